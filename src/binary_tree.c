@@ -11,7 +11,9 @@
 #include <stdio.h>
 #include <string.h>
 #include "binary_tree.h"
+#include "compiler.h"
 #include "compiler_error.h"
+#include "stats.h"
 
 // Binary tree private functions
 
@@ -21,13 +23,21 @@
  * \return New node | NULL in case of a memory allocation error
  */
 TNode* create_node(node_type type) {
+    stats_owner previous = stats_own(STATS_OWNER_AST);
     TNode* new_node = malloc(sizeof(TNode));
+    stats_own(previous);
     if(new_node != NULL){
         new_node->parent = NULL;
         new_node->left = NULL;
         new_node->right = NULL;
         new_node->type = type;
+        new_node->value_type = UNKNOWN_T;
+        new_node->value_nullable = false;
+        // Statements take the position of the token the parser is at, expressions take their own tokens
+        new_node->row = ctx->scanner.token_row;
+        new_node->col = ctx->scanner.token_col;
         memset(&new_node->data, 0, sizeof(new_node->data));
+        stats_count(STATS_NODES, 1);
     }
     return new_node;
 }
@@ -57,7 +67,9 @@ void assign_parents(TNode* root, TNode* parent){
 // Binary tree public functions
 
 TBinaryTree* BT_init(void){
+    stats_owner previous = stats_own(STATS_OWNER_AST);
     TBinaryTree* new_tree = malloc(sizeof(TBinaryTree));
+    stats_own(previous);
     if(new_tree != NULL){
         new_tree->root = NULL;
         new_tree->active = NULL;
@@ -227,6 +239,22 @@ bool BT_get_node_type(TBinaryTree* BT, node_type* type){
     return true;
 }
 
+bool BT_get_value_type(TBinaryTree* BT, Type* type){
+    if(!BT_is_active(BT) || type == NULL){
+        return false;
+    }
+    *type = BT->active->value_type;
+    return true;
+}
+
+bool BT_get_value_nullable(TBinaryTree* BT, bool* nullable){
+    if(!BT_is_active(BT) || nullable == NULL){
+        return false;
+    }
+    *nullable = BT->active->value_nullable;
+    return true;
+}
+
 bool BT_get_data_left(TBinaryTree* BT, node_data* data_out){
     if(!BT_has_left(BT)){
         return false;
@@ -323,7 +351,7 @@ char *new_line(char *line, char *str) {
 
     if((new = (char *) malloc(new_size)) == NULL) {
         fprintf(stderr,"Tree print function resource allocation failure");
-        error =  ERR_COMPILER_INTERNAL;
+        ctx->error =  ERR_COMPILER_INTERNAL;
         return NULL;
     }; 
     
@@ -157,6 +157,9 @@ struct node{
 
     node_type type;
     node_data data;
+    Type value_type;    // Resolved static type of an expression node, filled in by semantic analysis
+    bool value_nullable; // Value of the expression node can be null (?type)
+    unsigned int row, col; // Position in the source code, instructions generated from the node are mapped to it
 };
 
 struct binary_tree{
@@ -292,6 +295,22 @@ bool BT_get_data(TBinaryTree* BT, node_data* data_out);
  */
 bool BT_get_node_type(TBinaryTree* BT, node_type* type);
 
+/**
+ *
+ * \param BT Binary tree
+ * \param[out] type Resolved static type of the active expression node (UNKNOWN_T if it was not resolved)
+ * \return True: Success, False: NULL pointer argument | Binary tree is not active
+ */
+bool BT_get_value_type(TBinaryTree* BT, Type* type);
+
+/**
+ *
+ * \param BT Binary tree
+ * \param[out] nullable Value of the active expression node can be null
+ * \return True: Success, False: NULL pointer argument | Binary tree is not active
+ */
+bool BT_get_value_nullable(TBinaryTree* BT, bool* nullable);
+
 /**
  *
  * \param BT Binary tree
@@ -0,0 +1,349 @@
+/**
+ * Název projektu: Implementace překladače imperativního jazyka IFJ24.
+ *
+ * @file cache.c
+ */
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "cache.h"
+#include "compiler.h"
+#include "compiler_error.h"
+
+/*
+ * Generated code may change with any source file of the compiler, make passes a checksum of the sources and
+ * every version of the sources has its own entries. A build without the checksum does not use the cache.
+ */
+#ifdef IFJ24_SOURCE_HASH
+#define CACHE_VERSION "IFJ24 " IFJ24_SOURCE_HASH
+#define CACHE_ENABLED true
+#else
+#define CACHE_VERSION "IFJ24"
+#define CACHE_ENABLED false
+#endif
+
+/*
+ * Entry: CACHE_VERSION line, "<optimization> <exit code> <source length> <messages length> <errors length>" line,
+ * source code, diagnostics printed to the messages and the errors stream of the compilation, IFJcode24
+ */
+#define CACHE_SUFFIX ".ifjc"
+
+typedef struct cache_buffer{
+    char* data;
+    size_t size, capacity;
+} cache_buffer;
+
+// Output of a compilation kept in an entry
+typedef struct cache_result{
+    unsigned int exit_code;
+    const char* messages;   // Diagnostics of the program
+    size_t messages_length;
+    const char* errors;     // Internal errors of the compiler
+    size_t errors_length;
+    const char* code;       // IFJcode24, empty on error
+    size_t code_length;
+} cache_result;
+
+static bool cache_append(cache_buffer* buffer, const char* data, size_t size){
+    if(buffer->size + size > buffer->capacity){
+        size_t capacity = buffer->capacity ? buffer->capacity : 4096;
+        while(capacity < buffer->size + size){
+            capacity *= 2;
+        }
+        char* grown = realloc(buffer->data, capacity);
+        if(grown == NULL){
+            return false;
+        }
+        buffer->data = grown;
+        buffer->capacity = capacity;
+    }
+    memcpy(buffer->data + buffer->size, data, size);
+    buffer->size += size;
+    return true;
+}
+
+static bool cache_read(FILE* stream, cache_buffer* buffer){
+    char chunk[64 * 1024];
+    size_t count;
+    while((count = fread(chunk, 1, sizeof(chunk), stream)) > 0){
+        if(!cache_append(buffer, chunk, count)){
+            return false;
+        }
+    }
+    return !ferror(stream);
+}
+
+// 64 bit FNV-1a, entries keep the source code, so a collision is only a miss
+static uint64_t cache_hash(uint64_t hash, const char* data, size_t size){
+    for(size_t i = 0; i < size; i++){
+        hash ^= (unsigned char)data[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+/**
+ * Creates path of the entry of the source code
+ * \param dir
+ * \param optimization
+ * \param source
+ * \param length
+ * \return path, has to be freed | NULL on allocation error
+ */
+static char* cache_path(const char* dir, opt_level optimization, const char* source, size_t length){
+    char level = '0' + optimization;
+    uint64_t hash = cache_hash(0xcbf29ce484222325ull, CACHE_VERSION, sizeof(CACHE_VERSION));
+    hash = cache_hash(hash, &level, 1);
+    hash = cache_hash(hash, source, length);
+    char* path = malloc(strlen(dir) + 1 + 16 + sizeof(CACHE_SUFFIX));
+    if(path != NULL){
+        sprintf(path, "%s/%016llx%s", dir, (unsigned long long)hash, CACHE_SUFFIX);
+    }
+    return path;
+}
+
+/**
+ * Reads entry and checks that it belongs to the source code
+ * \param path
+ * \param optimization
+ * \param source
+ * \param length
+ * \param entry content of the entry
+ * \param result stored output pointing into the entry
+ * \return true: hit, false: missing or different entry
+ */
+static bool cache_lookup(const char* path, opt_level optimization, const char* source, size_t length,
+                         cache_buffer* entry, cache_result* result){
+    FILE* file = fopen(path, "rb");
+    if(file == NULL){
+        return false;
+    }
+    bool read = cache_read(file, entry);
+    fclose(file);
+    size_t version = sizeof(CACHE_VERSION) - 1;
+    if(!read || entry->size <= version || memcmp(entry->data, CACHE_VERSION "\n", version + 1) != 0){
+        return false;
+    }
+    int level, header;
+    size_t stored_length;
+    // The header is terminated by the newline inside of the entry
+    char* newline = memchr(entry->data + version + 1, '\n', entry->size - version - 1);
+    if(newline == NULL || sscanf(entry->data + version + 1, "%d %u %zu %zu %zu%n", &level, &result->exit_code,
+                                 &stored_length, &result->messages_length, &result->errors_length, &header) != 5
+       || entry->data + version + 1 + header != newline){
+        return false;
+    }
+    size_t start = newline + 1 - entry->data;
+    size_t available = entry->size - start;
+    if(level != (int)optimization || available < length || available - length < result->messages_length
+       || available - length - result->messages_length < result->errors_length
+       || stored_length != length || memcmp(entry->data + start, source, length) != 0){
+        return false;
+    }
+    result->messages = entry->data + start + length;
+    result->errors = result->messages + result->messages_length;
+    result->code = result->errors + result->errors_length;
+    result->code_length = entry->data + entry->size - result->code;
+    // Modification time orders entries for eviction
+    utimensat(AT_FDCWD, path, NULL, 0);
+    return true;
+}
+
+typedef struct cache_entry{
+    char* name;
+    off_t size;
+    struct timespec modified;
+} cache_entry;
+
+static int cache_compare_age(const void* first, const void* second){
+    const cache_entry* a = first;
+    const cache_entry* b = second;
+    if(a->modified.tv_sec != b->modified.tv_sec){
+        return a->modified.tv_sec < b->modified.tv_sec ? -1 : 1;
+    }
+    return (a->modified.tv_nsec > b->modified.tv_nsec) - (a->modified.tv_nsec < b->modified.tv_nsec);
+}
+
+/**
+ * Removes the least recently used entries until the entries fit into the limit
+ * \param dir
+ * \param limit
+ */
+static void cache_evict(const char* dir, size_t limit){
+    DIR* directory = opendir(dir);
+    if(directory == NULL){
+        return;
+    }
+    cache_entry* entries = NULL;
+    size_t count = 0, capacity = 0, total = 0;
+    struct dirent* item;
+    char path[4096];
+    while((item = readdir(directory)) != NULL){
+        size_t name_length = strlen(item->d_name);
+        struct stat status;
+        if(name_length <= strlen(CACHE_SUFFIX) || strcmp(item->d_name + name_length - strlen(CACHE_SUFFIX), CACHE_SUFFIX) != 0
+           || snprintf(path, sizeof(path), "%s/%s", dir, item->d_name) >= (int)sizeof(path) || stat(path, &status) != 0){
+            continue;
+        }
+        if(count == capacity){
+            capacity = capacity ? capacity * 2 : 64;
+            cache_entry* grown = realloc(entries, capacity * sizeof(cache_entry));
+            if(grown == NULL){
+                break;
+            }
+            entries = grown;
+        }
+        if((entries[count].name = strdup(item->d_name)) == NULL){
+            break;
+        }
+        entries[count].size = status.st_size;
+        entries[count].modified = status.st_mtim;
+        total += status.st_size;
+        count++;
+    }
+    closedir(directory);
+    if(total > limit){
+        qsort(entries, count, sizeof(cache_entry), cache_compare_age);
+        // Another compiler may have removed the entry already
+        for(size_t i = 0; i < count && total > limit; i++){
+            snprintf(path, sizeof(path), "%s/%s", dir, entries[i].name);
+            unlink(path);
+            total -= entries[i].size;
+        }
+    }
+    for(size_t i = 0; i < count; i++){
+        free(entries[i].name);
+    }
+    free(entries);
+}
+
+/**
+ * Writes entry to a temporary file renamed to the entry, readers never see partial entries
+ * \param path
+ * \param optimization
+ * \param source
+ * \param length
+ * \param result
+ */
+static void cache_store(const char* path, opt_level optimization, const char* source, size_t length,
+                        const cache_result* result){
+    char* temporary = malloc(strlen(path) + 24);
+    if(temporary == NULL){
+        return;
+    }
+    sprintf(temporary, "%s.%ld.tmp", path, (long)getpid());
+    FILE* file = fopen(temporary, "wb");
+    if(file == NULL){
+        free(temporary);
+        return;
+    }
+    fprintf(file, "%s\n%d %u %zu %zu %zu\n", CACHE_VERSION, (int)optimization, result->exit_code, length,
+            result->messages_length, result->errors_length);
+    fwrite(source, 1, length, file);
+    fwrite(result->messages, 1, result->messages_length, file);
+    fwrite(result->errors, 1, result->errors_length, file);
+    fwrite(result->code, 1, result->code_length, file);
+    if(fclose(file) != 0 || rename(temporary, path) != 0){
+        unlink(temporary);
+    }
+    free(temporary);
+}
+
+/**
+ * Prints output of a compilation, a hit prints the same as the compilation that stored the entry
+ * \param result
+ * \param settings streams of the diagnostics
+ * \param out stream for IFJcode24
+ */
+static void cache_replay(const cache_result* result, const compile_settings* settings, FILE* out){
+    fwrite(result->messages, 1, result->messages_length, settings->messages);
+    fwrite(result->errors, 1, result->errors_length, settings->errors);
+    fwrite(result->code, 1, result->code_length, out);
+}
+
+unsigned int cache_compile(const char* dir, size_t limit, FILE* source, FILE* out){
+    cache_buffer input = {.data = NULL, .size = 0, .capacity = 0};
+    if(!cache_read(source, &input)){
+        free(input.data);
+        return ERR_COMPILER_INTERNAL;
+    }
+    compile_settings settings = compile_settings_from_options();
+    char* path = NULL;
+    if(CACHE_ENABLED){
+        if(mkdir(dir, 0777) != 0 && errno != EEXIST){
+            fprintf(stderr, "cannot create cache directory '%s'\n", dir);
+        }
+        path = cache_path(dir, settings.optimization, input.data, input.size);
+    }
+
+    cache_buffer entry = {.data = NULL, .size = 0, .capacity = 0};
+    cache_result result;
+    if(path != NULL && cache_lookup(path, settings.optimization, input.data, input.size, &entry, &result)){
+        cache_replay(&result, &settings, out);
+    }
+    else{
+        // Diagnostics are captured to be stored with the generated code
+        char* messages = NULL;
+        char* errors = NULL;
+        char* text = NULL;
+        size_t messages_length = 0, errors_length = 0, text_length = 0;
+        compile_settings captured = settings;
+        captured.messages = open_memstream(&messages, &messages_length);
+        captured.errors = open_memstream(&errors, &errors_length);
+        FILE* stream = fmemopen(input.size > 0 ? input.data : (char[1]){0}, input.size, "r");
+        ir_program program = {0};
+        result.exit_code = ERR_COMPILER_INTERNAL;
+        if(stream != NULL && captured.messages != NULL && captured.errors != NULL){
+            result.exit_code = compile_with_settings(stream, &captured, &program);
+        }
+        if(stream != NULL){
+            fclose(stream);
+        }
+        FILE* printed = open_memstream(&text, &text_length);
+        if(printed == NULL){
+            result.exit_code = ERR_COMPILER_INTERNAL;
+        }
+        else{
+            if(result.exit_code == 0){
+                ir_print(&program, printed);
+            }
+            if(fclose(printed) != 0){
+                result.exit_code = ERR_COMPILER_INTERNAL;
+            }
+        }
+        ir_dispose(&program);
+        if(captured.messages != NULL && fclose(captured.messages) != 0){
+            result.exit_code = ERR_COMPILER_INTERNAL;
+        }
+        if(captured.errors != NULL && fclose(captured.errors) != 0){
+            result.exit_code = ERR_COMPILER_INTERNAL;
+        }
+        result.messages = messages != NULL ? messages : "";
+        result.messages_length = messages != NULL ? messages_length : 0;
+        result.errors = errors != NULL ? errors : "";
+        result.errors_length = errors != NULL ? errors_length : 0;
+        result.code = text != NULL ? text : "";
+        result.code_length = text != NULL && result.exit_code == 0 ? text_length : 0;
+        cache_replay(&result, &settings, out);
+        // Internal errors are not results of the source code
+        if(result.exit_code != ERR_COMPILER_INTERNAL && path != NULL){
+            cache_store(path, settings.optimization, input.data, input.size, &result);
+            cache_evict(dir, limit);
+        }
+        free(messages);
+        free(errors);
+        free(text);
+    }
+    free(entry.data);
+    free(path);
+    free(input.data);
+    return result.exit_code;
+}
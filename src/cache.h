@@ -0,0 +1,34 @@
+/**
+ * Název projektu: Implementace překladače imperativního jazyka IFJ24.
+ *
+ * @file cache.h
+ */
+
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <stddef.h>
+#include <stdio.h>
+
+/*
+ * On-disk cache of --cache. An entry is named by a hash of the version of the compiler sources, the optimization
+ * level and the source code. It keeps the source code to rule out collisions, the exit code, the diagnostics
+ * and the generated IFJcode24, a hit prints the same diagnostics as the compilation that stored the entry.
+ * Entries are written to a temporary file and renamed, hits refresh the modification time and the least recently
+ * used entries are removed when the directory grows over its limit.
+ */
+
+// Default limit of the cache directory in MiB
+#define CACHE_DEFAULT_SIZE 64
+
+/**
+ * Prints IFJcode24 of the source code from the cache, the source code is compiled and stored on a miss
+ * \param dir cache directory, created when it does not exist
+ * \param limit size limit of the directory in bytes
+ * \param source stream with the source code
+ * \param out stream for IFJcode24, diagnostics go to the streams of compile_settings_from_options
+ * \return 0: success, error code of the compiler
+ */
+unsigned int cache_compile(const char* dir, size_t limit, FILE* source, FILE* out);
+
+#endif
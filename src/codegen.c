@@ -11,15 +11,12 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "compiler.h"
 #include "compiler_error.h"
 #include "binary_tree.h"
 #include "codegen.h"
-
-typedef enum frame{
-    GLOBAL = 0,
-    LOCAL = 1,
-    TEMPORARY = 2,
-} Frame;
+#include "options.h"
+#include "ir.h"
 
 typedef struct term{
     enum _term_type{
@@ -42,6 +39,7 @@ typedef struct term{
 
 typedef unsigned long long TLabel;
 
+
 // IFJcode24 GF variable for storing function return values
 const TTerm cg_var_retval = {.type = CG_VARIABLE_T, .value.var_name = "retval", .frame = GLOBAL};
 // IFJcode24 GF bool variable for storing results of comparisons
@@ -57,34 +55,17 @@ const TTerm cg_zero_int_term = {.type = CG_INTEGER_T, .value.int_val = 0};
 const TTerm cg_one_int_term = {.type = CG_INTEGER_T, .value.int_val = 1};
 const TTerm cg_empty_string_lit = {.type = CG_STRING_T, .value.string = ""};
 
-// IFJcode24 frame types
-#define GF "GF@"
-#define LF "LF@"
-#define TF "TF@"
-
-/**
- * Function for getting strings with memory frames
- * \param frame Constant value of a memory frame
- * \return String with a corresponding frame and @ eg. "'frame type'F@"
- */
-const char* get_frame(Frame frame){
-    switch(frame){
-        case GLOBAL:
-            return GF;
-        case LOCAL:
-            return LF;
-        case TEMPORARY:
-            return TF;
-    }
-    error = ERR_COMPILER_INTERNAL;
-    return "";
-}
-
 // ---------------------------------------------------------------------------------------------------------------------
 // ----------------------------------------------- DECLARATIONS --------------------------------------------------------
 // ---------------------------------------------------------------------------------------------------------------------
 
-void cg_term(TTerm term);
+ir_operand cg_operand(TTerm term);
+
+void cg_emit(ir_opcode op, ir_operand o1, ir_operand o2, ir_operand o3);
+
+ir_position cg_position(TNode* node);
+
+void cg_no_operand(ir_opcode op);
 
 // CG variables and frames
 
@@ -120,25 +101,33 @@ TLabel cg_get_new_label(void);
 
 void cg_create_label(TLabel label_number);
 
-void cg_label(TLabel label_number);
+ir_operand cg_label(TLabel label_number, char* name);
 
 // Operands
 
 /**
- * Prints two instruction operands
+ * Generates instruction with one operand
+ * \param op
+ * \param o1
+ */
+void cg_one_operand(ir_opcode op, TTerm o1);
+
+/**
+ * Generates instruction with two operands
+ * \param op
  * \param o1
  * \param o2
- * \param o3
  */
-void cg_two_operands(TTerm o1, TTerm o2);
+void cg_two_operands(ir_opcode op, TTerm o1, TTerm o2);
 
 /**
- * Prints three instruction operands
+ * Generates instruction with three operands
+ * \param op
  * \param o1
  * \param o2
  * \param o3
  */
-void cg_three_operands(TTerm o1, TTerm o2, TTerm o3);
+void cg_three_operands(ir_opcode op, TTerm o1, TTerm o2, TTerm o3);
 
 // Comparisons
 
@@ -158,6 +147,12 @@ void cg_lteq_stack(void);
 
 void cg_gteq_stack(void);
 
+void cg_not_stack(void);
+
+void cg_num_lteq_stack(void);
+
+void cg_num_gteq_stack(void);
+
 // Jumps
 
 void cg_jump(TLabel label);
@@ -198,6 +193,8 @@ void cg_fdiv_stack(void);
 
 void cg_idiv_stack(void);
 
+void cg_div_stack(void);
+
 // Increment/Decrement
 
 void cg_int_var_inc_1(TTerm ivar);
@@ -224,6 +221,12 @@ void cg_stack_pop(TTerm variable);
 
 void cg_stack_clear(void);
 
+// Input and output
+
+void cg_read(TTerm dest, char* type);
+
+void cg_write(TTerm term);
+
 // IFJ BUILT-IN FUNCTIONS
 
 /**
@@ -300,46 +303,84 @@ void generate_comment(char* string);
 // ---------------------------------------------------------------------------------------------------------------------
 
 /**
- * Prints identifier or literal in IFJcode24 standard
+ * Converts identifier or literal to instruction operand
  * \param term
+ * \return operand referring to strings of the term
  */
-void cg_term(TTerm term){
-    char* bool_str;
+ir_operand cg_operand(TTerm term){
+    ir_operand operand = ir_none;
     switch(term.type){
         case CG_VARIABLE_T:
-            printf("%sVAR_%s", get_frame(term.frame), term.value.var_name);
+            operand.type = IR_VAR;
+            operand.frame = term.frame;
+            operand.value.name = term.value.var_name;
             break;
         case CG_INTEGER_T:
-            printf("int@%d", term.value.int_val);
+            operand.type = IR_INT;
+            operand.value.int_val = term.value.int_val;
             break;
         case CG_FLOAT_T:
-            printf("float@%a", term.value.float_val);
+            operand.type = IR_FLOAT;
+            operand.value.float_val = term.value.float_val;
             break;
         case CG_BOOLEAN_T:
-            bool_str = term.value.bool_val ? "true" : "false";
-            printf("bool@%s", bool_str);
+            operand.type = IR_BOOL;
+            operand.value.bool_val = term.value.bool_val;
             break;
         case CG_STRING_T:
-            printf("string@");
-            int i = 0;
-            while(term.value.string[i] != '\0'){
-                char c = term.value.string[i];
-                if(c <= 32 || c == '#' || c == '\\'){ // 000-032: Unprintable characters, 035: '#', 092: '\'
-                    printf("\\%03d", c);
-                }
-                else{
-                    putchar(c);
-                }
-                i++;
-            }
+            operand.type = IR_STRING;
+            operand.value.string = term.value.string;
             break;
         case CG_NULL_T:
-            printf("nil@nil");
+            operand.type = IR_NIL;
             break;
         default:
-            error = ERR_COMPILER_INTERNAL;
+            ctx->error = ERR_COMPILER_INTERNAL;
             break;
     }
+    return operand;
+}
+
+/**
+ * Appends instruction to the generated code
+ * \param op
+ * \param o1 ir_none when unused
+ * \param o2 ir_none when unused
+ * \param o3 ir_none when unused
+ */
+void cg_emit(ir_opcode op, ir_operand o1, ir_operand o2, ir_operand o3){
+    if(!ir_append_typed(&ctx->generated_code, op, ctx->cg_operand_type, o1, o2, o3)){
+        ctx->error = ERR_COMPILER_INTERNAL;
+        return;
+    }
+    ctx->generated_code.code[ctx->generated_code.count - 1].position = ctx->cg_position;
+}
+
+/**
+ * Maps the following instructions to the source position of the node
+ * \param node
+ * \return position of the previous instructions, restored when the node is generated
+ */
+ir_position cg_position(TNode* node){
+    ir_position previous = ctx->cg_position;
+    ctx->cg_position = (ir_position){node->row, node->col};
+    return previous;
+}
+
+void cg_no_operand(ir_opcode op){
+    cg_emit(op, ir_none, ir_none, ir_none);
+}
+
+void cg_one_operand(ir_opcode op, TTerm o1){
+    cg_emit(op, cg_operand(o1), ir_none, ir_none);
+}
+
+void cg_two_operands(ir_opcode op, TTerm o1, TTerm o2){
+    cg_emit(op, cg_operand(o1), cg_operand(o2), ir_none);
+}
+
+void cg_three_operands(ir_opcode op, TTerm o1, TTerm o2, TTerm o3){
+    cg_emit(op, cg_operand(o1), cg_operand(o2), cg_operand(o3));
 }
 
 // CG variables and frames
@@ -349,19 +390,16 @@ void cg_term(TTerm term){
  */
 void cg_create_var(TTerm var){
     if(var.type != CG_VARIABLE_T || var.value.var_name == NULL){
-        error = ERR_COMPILER_INTERNAL;
+        ctx->error = ERR_COMPILER_INTERNAL;
         return;
     }
-    printf("defvar ");
-    cg_term(var);
-    putchar('\n');
+    cg_one_operand(IR_DEFVAR, var);
 }
 
 /**
- * Initializes global variables, sets interpreted language to IFJcode24
+ * Initializes global variables
  */
 void cg_init(void){
-    printf(".IFJcode24\n");
     cg_create_var(cg_var_retval);
     cg_create_var(cg_var_cmp);
     cg_create_var(cg_var_temp);
@@ -370,38 +408,37 @@ void cg_init(void){
 }
 
 void cg_create_frame(void){
-    printf("createframe\n");
+    cg_no_operand(IR_CREATEFRAME);
 }
 
 void cg_push_frame(void){
-    printf("pushframe\n");
+    cg_no_operand(IR_PUSHFRAME);
 }
 
 void cg_pop_frame(void){
-    printf("popframe\n");
+    cg_no_operand(IR_POPFRAME);
 }
 
 void cg_exit(TTerm number){
-    printf("exit ");
-    cg_term(number);
-    putchar('\n');
+    cg_one_operand(IR_EXIT, number);
 }
 
 // Function calling
 
 /**
- * Prints function name, replaces . with -
+ * Creates label of function, replaces . with -
  * \param function
+ * \param name buffer for the label, at least strlen(function) + 5 characters long
+ * \return label operand
  */
-void cg_print_fun(char* function){
+ir_operand cg_fun_label(char* function, char* name){
+    strcpy(name, "FUN_");
     for(int i = 0; function[i] != '\0'; i++){
-        if(function[i] == '.'){
-            putchar('-');
-        }
-        else{
-            putchar(function[i]);
-        }
+        name[i + 4] = function[i] == '.' ? '-' : function[i];
+        name[i + 5] = '\0';
     }
+    ir_operand label = {.type = IR_LABEL_NAME, .value.name = name};
+    return label;
 }
 
 /**
@@ -410,16 +447,15 @@ void cg_print_fun(char* function){
  */
 void cg_call(char* function){
     if(function == NULL){
-        error = ERR_COMPILER_INTERNAL;
+        ctx->error = ERR_COMPILER_INTERNAL;
         return;
     }
-    printf("call FUN_");
-    cg_print_fun(function);
-    putchar('\n');
+    char name[strlen(function) + 5];
+    cg_emit(IR_CALL, cg_fun_label(function, name), ir_none, ir_none);
 }
 
 void cg_return(void){
-    printf("return\n");
+    cg_no_operand(IR_RETURN);
 }
 
 /**
@@ -428,24 +464,19 @@ void cg_return(void){
  */
 void cg_create_fun(char* function){
     if(function == NULL){
-        error = ERR_COMPILER_INTERNAL;
+        ctx->error = ERR_COMPILER_INTERNAL;
         return;
     }
-    printf("label FUN_");
-    cg_print_fun(function);
-    putchar('\n');
+    char name[strlen(function) + 5];
+    cg_emit(IR_LABEL, cg_fun_label(function, name), ir_none, ir_none);
 }
 
 void cg_move(TTerm dest, TTerm src){
     if(dest.type != CG_VARIABLE_T){
-        error = ERR_COMPILER_INTERNAL;
+        ctx->error = ERR_COMPILER_INTERNAL;
         return;
     }
-    printf("move ");
-    cg_term(dest);
-    putchar(' ');
-    cg_term(src);
-    putchar('\n');
+    cg_two_operands(IR_MOVE, dest, src);
 }
 
 void cg_set_type_bool(TTerm var){
@@ -459,59 +490,53 @@ void cg_set_type_bool(TTerm var){
  * \return label id
  */
 TLabel cg_get_new_label(void){
-    static TLabel label = 0;
-    return label++;
+    return ctx->label_count++;
 }
 
+// Maximal length of label name L<number>
+#define CG_LABEL_SIZE 24
+
 void cg_create_label(TLabel label_number){
-    printf("label L%llu\n", label_number);
+    char name[CG_LABEL_SIZE];
+    cg_emit(IR_LABEL, cg_label(label_number, name), ir_none, ir_none);
 }
 
-void cg_label(TLabel label_number){
-    printf("L%llu", label_number);
+/**
+ * Creates label operand
+ * \param label_number
+ * \param name buffer for the label, CG_LABEL_SIZE characters long
+ * \return label operand
+ */
+ir_operand cg_label(TLabel label_number, char* name){
+    snprintf(name, CG_LABEL_SIZE, "L%llu", label_number);
+    ir_operand label = {.type = IR_LABEL_NAME, .value.name = name};
+    return label;
 }
 
 // Comparisons
 
-void cg_two_operands(TTerm o1, TTerm o2){
-    putchar(' ');
-    cg_term(o1);
-    putchar(' ');
-    cg_term(o2);
-    putchar('\n');
-}
-
-void cg_three_operands(TTerm o1, TTerm o2, TTerm o3){
-    putchar(' ');
-    cg_term(o1);
-    cg_two_operands(o2, o3);
-}
-
 void cg_equal(TTerm value1, TTerm value2){
-    printf("eq");
-    cg_three_operands(cg_var_cmp, value1, value2);
+    cg_three_operands(IR_EQ, cg_var_cmp, value1, value2);
 }
 
 void cg_less_than(TTerm value1, TTerm value2){
-    printf("lt");
-    cg_three_operands(cg_var_cmp, value1, value2);
+    cg_three_operands(IR_LT, cg_var_cmp, value1, value2);
 }
 
 void cg_greater_than(TTerm value1, TTerm value2){
-    printf("gt");
-    cg_three_operands(cg_var_cmp, value1, value2);
+    cg_three_operands(IR_GT, cg_var_cmp, value1, value2);
 }
 
 void cg_eq_stack(void){
-    printf("eqs\n");
+    cg_no_operand(IR_EQS);
 }
 
 void cg_lt_stack(void){
-    printf("lts\n");
+    cg_no_operand(IR_LTS);
 }
 
 void cg_gt_stack(void){
-    printf("gts\n");
+    cg_no_operand(IR_GTS);
 }
 
 void cg_lteq_stack(void){
@@ -523,7 +548,7 @@ void cg_lteq_stack(void){
     cg_stack_push(cg_var_temp);
     cg_stack_push(cg_var_temp2);
     cg_eq_stack();
-    printf("ors\n");
+    cg_no_operand(IR_ORS);
 }
 
 void cg_gteq_stack(void){
@@ -535,27 +560,44 @@ void cg_gteq_stack(void){
     cg_stack_push(cg_var_temp);
     cg_stack_push(cg_var_temp2);
     cg_eq_stack();
-    printf("ors\n");
+    cg_no_operand(IR_ORS);
+}
+
+void cg_not_stack(void){
+    cg_no_operand(IR_NOTS);
+}
+
+/**
+ * Less or equal of two non-null numbers of the same type on stack's top, evaluated as not greater than
+ */
+void cg_num_lteq_stack(void){
+    cg_gt_stack();
+    cg_not_stack();
+}
+
+/**
+ * Greater or equal of two non-null numbers of the same type on stack's top, evaluated as not less than
+ */
+void cg_num_gteq_stack(void){
+    cg_lt_stack();
+    cg_not_stack();
 }
 
 // Jumps
 
 void cg_jump(TLabel label){
-    printf("jump ");
-    cg_label(label);
-    putchar('\n');
+    char name[CG_LABEL_SIZE];
+    cg_emit(IR_JUMP, cg_label(label, name), ir_none, ir_none);
 }
 
 void cg_jump_eq(TLabel label, TTerm value1, TTerm value2){
-    printf("jumpifeq ");
-    cg_label(label);
-    cg_two_operands(value1, value2);
+    char name[CG_LABEL_SIZE];
+    cg_emit(IR_JUMPIFEQ, cg_label(label, name), cg_operand(value1), cg_operand(value2));
 }
 
 void cg_jump_neq(TLabel label, TTerm value1, TTerm value2){
-    printf("jumpifneq ");
-    cg_label(label);
-    cg_two_operands(value1, value2);
+    char name[CG_LABEL_SIZE];
+    cg_emit(IR_JUMPIFNEQ, cg_label(label, name), cg_operand(value1), cg_operand(value2));
 }
 
 void cg_jump_lt(TLabel label, TTerm value1, TTerm value2){
@@ -581,50 +623,45 @@ void cg_jump_gteq(TLabel label, TTerm value1, TTerm value2){
 // Arithmetic
 
 void cg_add(TTerm dest, TTerm num1, TTerm num2){
-    printf("add");
-    cg_three_operands(dest, num1, num2);
+    cg_three_operands(IR_ADD, dest, num1, num2);
 }
 
 void cg_sub(TTerm dest, TTerm num1, TTerm num2){
-    printf("sub");
-    cg_three_operands(dest, num1, num2);
+    cg_three_operands(IR_SUB, dest, num1, num2);
 }
 
 void cg_mul(TTerm dest, TTerm num1, TTerm num2){
-    printf("mul");
-    cg_three_operands(dest, num1, num2);
+    cg_three_operands(IR_MUL, dest, num1, num2);
 }
 
 void cg_fdiv(TTerm dest, TTerm num1, TTerm num2){
-    printf("div");
-    cg_three_operands(dest, num1, num2);
+    cg_three_operands(IR_DIV, dest, num1, num2);
 }
 
 void cg_idiv(TTerm dest, TTerm num1, TTerm num2){
-    printf("idiv");
-    cg_three_operands(dest, num1, num2);
+    cg_three_operands(IR_IDIV, dest, num1, num2);
 }
 
 // Arithmetic stack
 
 void cg_add_stack(void){
-    printf("adds\n");
+    cg_no_operand(IR_ADDS);
 }
 
 void cg_sub_stack(void){
-    printf("subs\n");
+    cg_no_operand(IR_SUBS);
 }
 
 void cg_mul_stack(void){
-    printf("muls\n");
+    cg_no_operand(IR_MULS);
 }
 
 void cg_fdiv_stack(void){
-    printf("divs\n");
+    cg_no_operand(IR_DIVS);
 }
 
 void cg_idiv_stack(void){
-    printf("idivs\n");
+    cg_no_operand(IR_IDIVS);
 }
 
 /**
@@ -633,8 +670,7 @@ void cg_idiv_stack(void){
 void cg_div_stack(void){
     TTerm float_type = {.type = CG_STRING_T, .value.string = "float"};
     cg_stack_pop(cg_var_temp);
-    printf("type ");
-    cg_two_operands(cg_var_temp2, cg_var_temp);
+    cg_two_operands(IR_TYPE, cg_var_temp2, cg_var_temp);
     cg_stack_push(cg_var_temp);
     TLabel is_float = cg_get_new_label();
     TLabel end = cg_get_new_label();
@@ -660,76 +696,60 @@ void cg_int_var_dec_1(TTerm ivar){
 // String
 
 void cg_concat(TTerm dest, TTerm string1, TTerm string2){
-    printf("concat");
-    cg_three_operands(dest, string1, string2);
+    cg_three_operands(IR_CONCAT, dest, string1, string2);
 }
 
 void cg_strlen(TTerm dest, TTerm string){
-    printf("strlen");
-    cg_two_operands(dest, string);
+    cg_two_operands(IR_STRLEN, dest, string);
 }
 
 void cg_getchar(TTerm dest, TTerm string, TTerm position){
-    printf("getchar");
-    cg_three_operands(dest, string, position);
+    cg_three_operands(IR_GETCHAR, dest, string, position);
 }
 
 void cg_setchar(TTerm src_str, TTerm dest_str, TTerm position){
-    printf("setchar");
-    cg_three_operands(src_str, dest_str, position);
+    cg_three_operands(IR_SETCHAR, src_str, dest_str, position);
 }
 
 void cg_stri2int(TTerm dest, TTerm string, TTerm pos){
-    printf("stri2int");
-    cg_three_operands(dest, string, pos);
+    cg_three_operands(IR_STRI2INT, dest, string, pos);
 }
 
 void cg_int2char(TTerm dest, TTerm num){
-    printf("int2char");
-    cg_two_operands(dest, num);
+    cg_two_operands(IR_INT2CHAR, dest, num);
 }
 
 // Stack
 
 void cg_stack_push(TTerm value){
-    printf("pushs ");
-    cg_term(value);
-    putchar('\n');
+    cg_one_operand(IR_PUSHS, value);
 }
 
 void cg_stack_pop(TTerm variable){
-    printf("pops ");
-    cg_term(variable);
-    putchar('\n');
+    cg_one_operand(IR_POPS, variable);
 }
 
 void cg_stack_clear(void){
-    printf("clears\n");
+    cg_no_operand(IR_CLEARS);
 }
 
 // IFJ BUILT-IN FUNCTIONS
 
 void cg_ifj_readstr(void){
     cg_create_fun("ifj.readstr");
-    printf("read ");
-    cg_term(cg_var_retval);
-    printf(" string\n");
+    cg_read(cg_var_retval, "string");
     cg_return();
 }
 
 void cg_ifj_readi32(void){
     cg_create_fun("ifj.readi32");
-    printf("read ");
-    cg_term(cg_var_retval);
-    printf(" int\n");
+    cg_read(cg_var_retval, "int");
     cg_return();
 }
 
 void cg_ifj_readf64(void){
     cg_create_fun("ifj.readf64");
-    printf("read ");
-    cg_term(cg_var_retval);
-    printf(" float\n");
+    cg_read(cg_var_retval, "float");
     cg_return();
 }
 
@@ -742,9 +762,7 @@ void cg_ifj_write(void){
     cg_create_var(term);
     cg_stack_pop(term);
 
-    printf("write ");
-    cg_term(term);
-    putchar('\n');
+    cg_write(term);
 
     cg_pop_frame();
     cg_return();
@@ -759,8 +777,7 @@ void cg_ifj_i2f(void){
     cg_create_var(term);
     cg_stack_pop(term);
 
-    printf("int2float");
-    cg_two_operands(cg_var_retval, term);
+    cg_two_operands(IR_INT2FLOAT, cg_var_retval, term);
 
     cg_pop_frame();
     cg_return();
@@ -775,8 +792,7 @@ void cg_ifj_f2i(void){
     cg_create_var(term);
     cg_stack_pop(term);
 
-    printf("float2int");
-    cg_two_operands(cg_var_retval, term);
+    cg_two_operands(IR_FLOAT2INT, cg_var_retval, term);
 
     cg_pop_frame();
     cg_return();
@@ -858,9 +874,7 @@ void cg_ifj_substring(void){
     // i > j
     cg_jump_gt(ret_null, i, j);
     // i >= ifj.length(s)
-    cg_stack_push(s);
-    cg_call("ifj.length");
-    cg_move(str_len, cg_var_retval);
+    cg_strlen(str_len, s);
     cg_jump_gteq(ret_null, i, str_len);
     // j > ifj.length(s)
     cg_jump_gt(ret_null, j, str_len);
@@ -880,7 +894,10 @@ void cg_ifj_substring(void){
     cg_jump_gteq(while_end, i_loc, j);
 
     cg_getchar(character, s, i_loc);
+    // Result is initialized to string and getchar returns string
+    ctx->cg_operand_type = IR_TYPE_STR;
     cg_concat(cg_var_retval, cg_var_retval, character);
+    ctx->cg_operand_type = IR_TYPE_ANY;
     cg_int_var_inc_1(i_loc);
 
     cg_jump(while_beg);
@@ -1024,6 +1041,125 @@ void cg_ifj_chr(void){
     cg_return();
 }
 
+// Intrinsic lowering of IFJ built-in functions
+
+void cg_read(TTerm dest, char* type){
+    ir_operand type_name = {.type = IR_TYPE_NAME, .value.name = type};
+    cg_emit(IR_READ, cg_operand(dest), type_name, ir_none);
+}
+
+void cg_write(TTerm term){
+    cg_one_operand(IR_WRITE, term);
+}
+
+void cg_inline_readstr(TTerm dest, TTerm* args){
+    (void)args;
+    cg_read(dest, "string");
+}
+
+void cg_inline_readi32(TTerm dest, TTerm* args){
+    (void)args;
+    cg_read(dest, "int");
+}
+
+void cg_inline_readf64(TTerm dest, TTerm* args){
+    (void)args;
+    cg_read(dest, "float");
+}
+
+void cg_inline_write(TTerm dest, TTerm* args){
+    (void)dest;
+    cg_write(args[0]);
+}
+
+void cg_inline_i2f(TTerm dest, TTerm* args){
+    cg_two_operands(IR_INT2FLOAT, dest, args[0]);
+}
+
+void cg_inline_f2i(TTerm dest, TTerm* args){
+    cg_two_operands(IR_FLOAT2INT, dest, args[0]);
+}
+
+void cg_inline_string(TTerm dest, TTerm* args){
+    cg_move(dest, args[0]);
+}
+
+void cg_inline_length(TTerm dest, TTerm* args){
+    cg_strlen(dest, args[0]);
+}
+
+void cg_inline_concat(TTerm dest, TTerm* args){
+    cg_concat(dest, args[0], args[1]);
+}
+
+/**
+ * ifj.ord(s, i), bounds check is kept inline, result is folded when both arguments are literals
+ */
+void cg_inline_ord(TTerm dest, TTerm* args){
+    TTerm s = args[0];
+    TTerm i = args[1];
+    if(s.type == CG_STRING_T && i.type == CG_INTEGER_T){
+        TTerm ordinal = cg_zero_int_term;
+        if(i.value.int_val >= 0 && (size_t)i.value.int_val < strlen(s.value.string)){
+            ordinal.value.int_val = (unsigned char)s.value.string[i.value.int_val];
+        }
+        cg_move(dest, ordinal);
+        return;
+    }
+    TLabel end = cg_get_new_label();
+    cg_strlen(cg_var_temp2, s);
+    cg_move(cg_var_temp, cg_zero_int_term);
+    cg_jump_lt(end, i, cg_zero_int_term);
+    cg_jump_gteq(end, i, cg_var_temp2);
+    cg_stri2int(cg_var_temp, s, i);
+    cg_create_label(end);
+    cg_move(dest, cg_var_temp);
+}
+
+void cg_inline_chr(TTerm dest, TTerm* args){
+    cg_int2char(dest, args[0]);
+}
+
+#define MAX_INTRINSIC_ARGS 3
+
+typedef struct intrinsic{
+    char* name;                             // IFJ24 name of the built-in function
+    void (*helper)(void);                   // Generates callable function body
+    void (*lower)(TTerm dest, TTerm* args); // Generates the call inline, NULL if it has to be called
+} TIntrinsic;
+
+static const TIntrinsic intrinsics[] = {
+    {"ifj.readstr", cg_ifj_readstr, cg_inline_readstr},
+    {"ifj.readi32", cg_ifj_readi32, cg_inline_readi32},
+    {"ifj.readf64", cg_ifj_readf64, cg_inline_readf64},
+    {"ifj.write", cg_ifj_write, cg_inline_write},
+    {"ifj.i2f", cg_ifj_i2f, cg_inline_i2f},
+    {"ifj.f2i", cg_ifj_f2i, cg_inline_f2i},
+    {"ifj.string", cg_ifj_string, cg_inline_string},
+    {"ifj.length", cg_ifj_length, cg_inline_length},
+    {"ifj.concat", cg_ifj_concat, cg_inline_concat},
+    {"ifj.substring", cg_ifj_substring, NULL},
+    {"ifj.strcmp", cg_ifj_strcmp, NULL},
+    {"ifj.ord", cg_ifj_ord, cg_inline_ord},
+    {"ifj.chr", cg_ifj_chr, cg_inline_chr},
+};
+
+#define INTRINSIC_COUNT (sizeof(intrinsics) / sizeof(intrinsics[0]))
+
+/**
+ * Finds IFJ built-in function in the table of intrinsics
+ * \param function function identifier
+ * \return Intrinsic | NULL if the function is not built-in
+ */
+const TIntrinsic* get_intrinsic(char* function){
+    for(size_t i = 0; i < INTRINSIC_COUNT; i++){
+        if(strcmp(intrinsics[i].name, function) == 0){
+            return &intrinsics[i];
+        }
+    }
+    return NULL;
+}
+
 // Variable binary search tree
 
 typedef struct element{
@@ -1032,7 +1168,6 @@ typedef struct element{
     struct element* left;
 } TElement;
 
-TElement* var_tree = NULL;
 
 /**
  * Inserts element
@@ -1042,13 +1177,13 @@ TElement* var_tree = NULL;
  */
 bool insert_in(TElement** element, char* name){
     if(element == NULL){
-        error = ERR_COMPILER_INTERNAL;
+        ctx->error = ERR_COMPILER_INTERNAL;
         return false;
     }
     if(*element == NULL){
         *element = malloc(sizeof(TElement));
         if(*element == NULL){
-            error = ERR_COMPILER_INTERNAL;
+            ctx->error = ERR_COMPILER_INTERNAL;
             return false;
         }
         (*element)->var_name = name;
@@ -1073,7 +1208,7 @@ bool insert_in(TElement** element, char* name){
  * \return Insertiom failed
  */
 bool insert(char* name){
-    return insert_in(&var_tree, name);
+    return insert_in(&ctx->var_tree, name);
 }
 
 /**
@@ -1092,8 +1227,396 @@ void dispose_in(TElement* element){
  * Disposes whole tree
  */
 void dispose(void){
-    dispose_in(var_tree);
-    var_tree = NULL;
+    dispose_in(ctx->var_tree);
+    ctx->var_tree = NULL;
+}
+
+// User function calling convention
+
+typedef struct function_info{
+    char* name;                 // Function identifier
+    linked_list_t params;       // Parameter identifiers
+    bool has_frame;             // Caller builds a memory frame with the parameters in TF
+    Frame frame;                // Frame of the function's variables, TEMPORARY for leaf functions without locals
+} TFunctionInfo;
+
+
+/**
+ * Checks if function call is lowered inline and does not touch memory frames
+ * \param function function identifier
+ */
+bool is_inline_call(char* function){
+    const TIntrinsic* intrinsic = get_intrinsic(function);
+    return intrinsic != NULL && intrinsic->lower != NULL && ctx->optimization >= OPT_BASIC;
+}
+
+/**
+ * Looks for declarations and calls in the subtree of the function body
+ * \param node
+ * \param[out] has_locals Subtree declares variables
+ * \param[out] has_calls Subtree calls a function, that creates its own frame
+ */
+void scan_function_body(TNode* node, bool* has_locals, bool* has_calls){
+    if(node == NULL){
+        return;
+    }
+    switch(node->type){
+        case VAR_DECL:
+        case CONST_DECL:
+            *has_locals = true;
+            break;
+        case IF:
+        case WHILE:
+            if(node->data.nodeData.body.is_nullable){
+                *has_locals = true;
+            }
+            break;
+        case FUNCTION_CALL:
+            if(!is_inline_call(node->data.nodeData.identifier.identifier)){
+                *has_calls = true;
+            }
+            break;
+        default:
+            break;
+    }
+    scan_function_body(node->left, has_locals, has_calls);
+    scan_function_body(node->right, has_locals, has_calls);
+}
+
+int compare_functions(const void* f1, const void* f2){
+    return strcmp(((const TFunctionInfo*)f1)->name, ((const TFunctionInfo*)f2)->name);
+}
+
+void codegen_declare_function(TNode* function, bool has_locals, bool has_calls){
+    if(ctx->function_count == ctx->function_capacity){
+        size_t capacity = ctx->function_capacity ? ctx->function_capacity * 2 : 16;
+        TFunctionInfo* functions = realloc(ctx->functions, sizeof(TFunctionInfo) * capacity);
+        if(functions == NULL){
+            ctx->error = ERR_COMPILER_INTERNAL;
+            return;
+        }
+        ctx->functions = functions;
+        ctx->function_capacity = capacity;
+    }
+    bool has_params = function->data.nodeData.function.param_identifiers.first != NULL;
+    TFunctionInfo* info = &ctx->functions[ctx->function_count++];
+    info->name = function->data.nodeData.function.identifier;
+    info->params = function->data.nodeData.function.param_identifiers;
+    info->has_frame = has_params || has_locals || ctx->optimization < OPT_BASIC;
+    info->frame = (has_params && !has_locals && !has_calls && ctx->optimization >= OPT_BASIC) ? TEMPORARY : LOCAL;
+}
+
+/**
+ * Chooses memory frame of every user function
+ * \param tree abstract syntactic tree
+ */
+void analyze_functions(TBinaryTree* tree){
+    for(TNode* fn = tree->root->left; fn != NULL && !ctx->error; fn = fn->left){
+        bool has_locals = false;
+        bool has_calls = false;
+        scan_function_body(fn->right, &has_locals, &has_calls);
+        codegen_declare_function(fn, has_locals, has_calls);
+    }
+}
+
+/**
+ * Finds user function
+ * \param function function identifier
+ * \return function info | NULL if it is not user function
+ */
+TFunctionInfo* get_function(char* function){
+    TFunctionInfo key = {.name = function};
+    return bsearch(&key, ctx->functions, ctx->function_count, sizeof(TFunctionInfo), compare_functions);
+}
+
+// Frame slot allocation
+
+typedef struct slot_var{
+    char* name;     // Declared identifier
+    int depth;      // Block nesting depth of the declaration
+    bool visible;   // Declaration is in scope of the currently scanned command
+    int start;      // Position of the declaration
+    int end;        // Position of the last use
+    int slot;       // Assigned frame slot
+} TSlotVar;
+
+typedef struct slot_use{
+    char** identifier; // AST field referring to the variable
+    int var;           // Index of the variable
+} TSlotUse;
+
+typedef struct slot_allocation{
+    TSlotVar* vars;
+    size_t var_count, var_capacity;
+    TSlotUse* uses;
+    size_t use_count, use_capacity;
+    int position;   // Position of currently scanned command
+    int depth;      // Nesting depth of currently scanned block
+} TSlotAllocation;
+
+
+/**
+ * Declares variable, that has its own live range
+ * \param alloc
+ * \param identifier AST field with the identifier of the variable
+ */
+void slot_declare(TSlotAllocation* alloc, char** identifier){
+    if(alloc->var_count == alloc->var_capacity){
+        size_t capacity = alloc->var_capacity ? alloc->var_capacity * 2 : 16;
+        TSlotVar* vars = realloc(alloc->vars, sizeof(TSlotVar) * capacity);
+        if(vars == NULL){
+            ctx->error = ERR_COMPILER_INTERNAL;
+            return;
+        }
+        alloc->vars = vars;
+        alloc->var_capacity = capacity;
+    }
+    TSlotVar* var = &alloc->vars[alloc->var_count++];
+    var->name = *identifier;
+    var->depth = alloc->depth;
+    var->visible = true;
+    var->start = alloc->position;
+    var->end = alloc->position;
+    var->slot = -1;
+}
+
+/**
+ * Records use of variable in the current command, the identifier is later replaced by its slot
+ * \param alloc
+ * \param identifier AST field with the identifier of the variable
+ */
+void slot_use(TSlotAllocation* alloc, char** identifier){
+    // Innermost visible declaration
+    size_t i = alloc->var_count;
+    while(i > 0 && (!alloc->vars[i - 1].visible || strcmp(alloc->vars[i - 1].name, *identifier) != 0)){
+        i--;
+    }
+    if(i == 0){
+        return;
+    }
+    if(alloc->use_count == alloc->use_capacity){
+        size_t capacity = alloc->use_capacity ? alloc->use_capacity * 2 : 32;
+        TSlotUse* uses = realloc(alloc->uses, sizeof(TSlotUse) * capacity);
+        if(uses == NULL){
+            ctx->error = ERR_COMPILER_INTERNAL;
+            return;
+        }
+        alloc->uses = uses;
+        alloc->use_capacity = capacity;
+    }
+    alloc->vars[i - 1].end = alloc->position;
+    alloc->uses[alloc->use_count].identifier = identifier;
+    alloc->uses[alloc->use_count].var = i - 1;
+    alloc->use_count++;
+}
+
+/**
+ * Records uses of variables in expression or function call arguments
+ * \param alloc
+ * \param node
+ */
+void slot_scan_expression(TSlotAllocation* alloc, TNode* node){
+    if(node == NULL){
+        return;
+    }
+    if(node->type == VAR_CONST){
+        slot_use(alloc, &node->data.nodeData.value.identifier);
+    }
+    slot_scan_expression(alloc, node->left);
+    slot_scan_expression(alloc, node->right);
+}
+
+void slot_scan_commands(TSlotAllocation* alloc, TNode* command);
+
+/**
+ * Scans block of commands, variables declared inside are not visible after it
+ * \param alloc
+ * \param command first command of the block
+ * \param replacement |null_replacement| declared in the block, NULL if there is none
+ */
+void slot_scan_block(TSlotAllocation* alloc, TNode* command, char** replacement){
+    alloc->depth++;
+    if(replacement != NULL){
+        slot_declare(alloc, replacement);
+        slot_use(alloc, replacement);
+    }
+    slot_scan_commands(alloc, command);
+    for(size_t i = 0; i < alloc->var_count; i++){
+        if(alloc->vars[i].depth == alloc->depth){
+            alloc->vars[i].visible = false;
+        }
+    }
+    alloc->depth--;
+}
+
+/**
+ * Computes live ranges of variables declared in the commands
+ * \param alloc
+ * \param command
+ */
+void slot_scan_commands(TSlotAllocation* alloc, TNode* command){
+    for(; command != NULL && !ctx->error; command = command->right){
+        TNode* statement = command->left;
+        if(statement == NULL){
+            continue;
+        }
+        alloc->position++;
+        char** replacement = statement->data.nodeData.body.is_nullable ? &statement->data.nodeData.body.null_replacement : NULL;
+        switch(statement->type){
+            case VAR_DECL:
+            case CONST_DECL:
+                slot_scan_expression(alloc, statement->left);
+                slot_declare(alloc, &statement->data.nodeData.identifier.identifier);
+                slot_use(alloc, &statement->data.nodeData.identifier.identifier);
+                break;
+            case ASSIG:
+                slot_scan_expression(alloc, statement->left);
+                if(!statement->data.nodeData.identifier.is_disposeable){
+                    slot_use(alloc, &statement->data.nodeData.identifier.identifier);
+                }
+                break;
+            case FUNCTION_CALL:
+                slot_scan_expression(alloc, statement->right);
+                break;
+            case RETURN:
+                slot_scan_expression(alloc, statement->left);
+                break;
+            case IF:
+                slot_scan_expression(alloc, statement->left);
+                slot_scan_block(alloc, statement->right, replacement);
+                break;
+            case WHILE:{
+                int loop_start = alloc->position;
+                slot_scan_expression(alloc, statement->left);
+                slot_scan_block(alloc, statement->right, replacement);
+                int loop_end = ++alloc->position;
+                // Variables declared before the cycle and used in it are live until its last iteration
+                for(size_t i = 0; i < alloc->var_count; i++){
+                    if(alloc->vars[i].start < loop_start && alloc->vars[i].end >= loop_start && alloc->vars[i].end < loop_end){
+                        alloc->vars[i].end = loop_end;
+                    }
+                }
+                break;
+            }
+            case ELSE:
+            case BODY:
+                slot_scan_block(alloc, statement->right, NULL);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+/**
+ * Creates slot name derived from the name of its first variable, unique within the function
+ * \param name identifier of the first variable in the slot
+ * \param slot slot number
+ * \param first index of the first slot name of the function
+ * \return slot name | NULL in case of a memory allocation error
+ */
+char* slot_name(char* name, int slot, size_t first){
+    bool unique = true;
+    for(size_t i = first; i < ctx->slot_name_count && unique; i++){
+        unique = strcmp(ctx->slot_names[i], name) != 0;
+    }
+    char* new_name = malloc(strlen(name) + 16);
+    char** names = realloc(ctx->slot_names, sizeof(char*) * (ctx->slot_name_count + 1));
+    if(new_name == NULL || names == NULL){
+        free(new_name);
+        ctx->error = ERR_COMPILER_INTERNAL;
+        return NULL;
+    }
+    ctx->slot_names = names;
+    if(unique){
+        strcpy(new_name, name);
+    }
+    else{
+        sprintf(new_name, "%s$%d", name, slot);
+    }
+    ctx->slot_names[ctx->slot_name_count++] = new_name;
+    return new_name;
+}
+
+/**
+ * Assigns variables with disjoint live ranges to shared frame slots, renames them in the AST
+ * and declares the slots, parameters keep their slots from the caller
+ * \param function function node
+ * \param params parameter identifiers
+ */
+void allocate_frame_slots(TNode* function, linked_list_t params){
+    TSlotAllocation alloc = {0};
+    size_t first_slot_name = ctx->slot_name_count;
+    // Parameters are declared before the first command
+    set_first_llist(&params);
+    char* param_name;
+    while(get_value_llist(&params, &param_name)){
+        char* name = param_name;
+        slot_declare(&alloc, &name);
+        next_llist(&params);
+    }
+    size_t param_count = alloc.var_count;
+    slot_scan_commands(&alloc, function->right);
+
+    // Linear scan, variables are already sorted by the start of their live range
+    size_t slot_count = 0;
+    int* slot_end = malloc(sizeof(int) * (alloc.var_count + 1));
+    char** slot_var_name = malloc(sizeof(char*) * (alloc.var_count + 1));
+    if(slot_end == NULL || slot_var_name == NULL){
+        ctx->error = ERR_COMPILER_INTERNAL;
+    }
+    for(size_t i = 0; i < alloc.var_count && !ctx->error; i++){
+        TSlotVar* var = &alloc.vars[i];
+        if(i >= param_count){
+            for(size_t slot = 0; slot < slot_count; slot++){
+                if(slot_end[slot] <= var->start){
+                    var->slot = slot;
+                    break;
+                }
+            }
+        }
+        if(var->slot < 0){
+            var->slot = slot_count;
+            slot_var_name[slot_count] = slot_name(var->name, slot_count, first_slot_name);
+            slot_count++;
+        }
+        slot_end[var->slot] = var->end;
+    }
+    for(size_t i = 0; i < alloc.use_count && !ctx->error; i++){
+        *alloc.uses[i].identifier = slot_var_name[alloc.vars[alloc.uses[i].var].slot];
+    }
+    // Slots of parameters are already defined
+    for(size_t slot = 0; slot < slot_count && !ctx->error; slot++){
+        insert(ctx->slot_names[first_slot_name + slot]);
+        if(slot >= param_count){
+            TTerm variable = {.type = CG_VARIABLE_T, .value.var_name = ctx->slot_names[first_slot_name + slot], .frame = ctx->var_frame};
+            cg_create_var(variable);
+        }
+    }
+    free(slot_end);
+    free(slot_var_name);
+    free(alloc.vars);
+    free(alloc.uses);
+}
+
+/**
+ * Frees names of the slots, the AST of generated functions refers to them
+ */
+void dispose_slot_names(void){
+    for(size_t i = 0; i < ctx->slot_name_count; i++){
+        free(ctx->slot_names[i]);
+    }
+    free(ctx->slot_names);
+    ctx->slot_names = NULL;
+    ctx->slot_name_count = 0;
+}
+
+void dispose_functions(void){
+    free(ctx->functions);
+    ctx->functions = NULL;
+    ctx->function_count = 0;
+    ctx->function_capacity = 0;
+    dispose_slot_names();
 }
 
 // Codegen
@@ -1106,7 +1629,8 @@ void generate_comment(char* string){
     if(string == NULL){
         return;
     }
-    printf("# %s\n", string);
+    ir_operand text = {.type = IR_TYPE_NAME, .value.name = string};
+    cg_emit(IR_COMMENT, text, ir_none, ir_none);
 }
 
 // Function generation
@@ -1128,17 +1652,43 @@ void generate_function_parameters(linked_list_t parameters){
     set_last_llist(&parameters);
     char** param_name_ptr = malloc(sizeof(char*));
     if(param_name_ptr == NULL){
-        error = ERR_COMPILER_INTERNAL;
+        ctx->error = ERR_COMPILER_INTERNAL;
         return;
     }
     while(get_value_llist(&parameters, param_name_ptr)){
-        TTerm variable = {.type = CG_VARIABLE_T, .value.var_name = *param_name_ptr, .frame = LOCAL};
+        TTerm variable = {.type = CG_VARIABLE_T, .value.var_name = *param_name_ptr, .frame = ctx->var_frame};
         cg_create_var(variable);
         cg_stack_pop(variable);
         prev_llist(&parameters);
     }
 }
 
+/**
+ * Returns type of both operands of the active operator node proven by semantic analysis
+ * \param tree abstract syntactic tree
+ * \return IR_TYPE_I32 | IR_TYPE_F64 | IR_TYPE_ANY when an operand can be null or the types are not the same number type
+ */
+ir_value_type proven_operand_type(TBinaryTree* tree){
+    Type types[2] = {UNKNOWN_T, UNKNOWN_T};
+    bool nullable[2] = {true, true};
+    if(BT_has_left(tree)){
+        BT_go_left(tree);
+        BT_get_value_type(tree, &types[0]);
+        BT_get_value_nullable(tree, &nullable[0]);
+        BT_go_parent(tree);
+    }
+    if(BT_has_right(tree)){
+        BT_go_right(tree);
+        BT_get_value_type(tree, &types[1]);
+        BT_get_value_nullable(tree, &nullable[1]);
+        BT_go_parent(tree);
+    }
+    if(nullable[0] || nullable[1] || types[0] != types[1]){
+        return IR_TYPE_ANY;
+    }
+    return types[0] == INTEGER_T ? IR_TYPE_I32 : types[0] == FLOAT_T ? IR_TYPE_F64 : IR_TYPE_ANY;
+}
+
 /**
  * Generates expression calculation, calculated value is left on top of the stack
  * \param tree abstract syntactic tree
@@ -1156,11 +1706,15 @@ void calculate_expression(TBinaryTree* tree){
     }
     node_type type;
     node_data data;
-    if(!BT_get_node_type(tree, &type) || !BT_get_data(tree, &data)){
-        error = ERR_COMPILER_INTERNAL;
+    Type value_type;
+    if(!BT_get_node_type(tree, &type) || !BT_get_data(tree, &data) || !BT_get_value_type(tree, &value_type)){
+        ctx->error = ERR_COMPILER_INTERNAL;
         return;
     }
     TTerm term;
+    ir_position position = cg_position(tree->active);
+    // Operators get type specific instructions in the interpreter
+    ctx->cg_operand_type = proven_operand_type(tree);
     switch(type){
         case INT:
             term.type = CG_INTEGER_T;
@@ -1184,7 +1738,7 @@ void calculate_expression(TBinaryTree* tree){
         case VAR_CONST:
             term.type = CG_VARIABLE_T;
             term.value.var_name = data.nodeData.value.identifier;
-            term.frame = LOCAL;
+            term.frame = ctx->var_frame;
             cg_stack_push(term);
             break;
         case OP_ADD:
@@ -1197,14 +1751,23 @@ void calculate_expression(TBinaryTree* tree){
             cg_mul_stack();
             break;
         case OP_DIV:
-            cg_div_stack();
+            // Division type is known from semantic analysis, runtime dispatch is only a fallback
+            if(value_type == INTEGER_T){
+                cg_idiv_stack();
+            }
+            else if(value_type == FLOAT_T){
+                cg_fdiv_stack();
+            }
+            else{
+                cg_div_stack();
+            }
             break;
         case OP_EQ:
             cg_eq_stack();
             break;
         case OP_NEQ:
             cg_eq_stack();
-            printf("nots\n");
+            cg_not_stack();
             break;
         case OP_GT:
             cg_gt_stack();
@@ -1213,15 +1776,27 @@ void calculate_expression(TBinaryTree* tree){
             cg_lt_stack();
             break;
         case OP_GTE:
-            cg_gteq_stack();
+            if(proven_operand_type(tree) != IR_TYPE_ANY){
+                cg_num_gteq_stack();
+            }
+            else{
+                cg_gteq_stack();
+            }
             break;
         case OP_LSE:
-            cg_lteq_stack();
+            if(proven_operand_type(tree) != IR_TYPE_ANY){
+                cg_num_lteq_stack();
+            }
+            else{
+                cg_lteq_stack();
+            }
             break;
         default:
-            error = ERR_COMPILER_INTERNAL;
+            ctx->error = ERR_COMPILER_INTERNAL;
             break;
     }
+    ctx->cg_operand_type = IR_TYPE_ANY;
+    ctx->cg_position = position;
 }
 /**
  * Generates function return statement
@@ -1235,7 +1810,9 @@ void generate_return(TBinaryTree* tree){
         cg_stack_pop(cg_var_retval);
         BT_go_parent(tree);
     }
-    cg_pop_frame();
+    if(ctx->frame_pushed){
+        cg_pop_frame();
+    }
     cg_return();
 }
 
@@ -1249,7 +1826,7 @@ TTerm node_to_term_rval(TBinaryTree* tree){
     node_data data;
     TTerm term = cg_null_term;
     if(!BT_get_node_type(tree, &type) || !BT_get_data(tree, &data)){
-        error = ERR_COMPILER_INTERNAL;
+        ctx->error = ERR_COMPILER_INTERNAL;
         return term;
     }
     switch(type){
@@ -1271,22 +1848,91 @@ TTerm node_to_term_rval(TBinaryTree* tree){
         case VAR_CONST:
             term.type = CG_VARIABLE_T;
             term.value.var_name = data.nodeData.value.identifier;
-            term.frame = LOCAL;
+            term.frame = ctx->var_frame;
             break;
         default:
-            error = ERR_COMPILER_INTERNAL;
+            ctx->error = ERR_COMPILER_INTERNAL;
             break;
     }
     return term;
 }
 /**
- * Pushes arguments to the stack and calls function
+ * Calls user function, arguments are moved straight to the callee's frame in TF
+ * \param tree abstract syntactic tree
+ * \param function called function
+ * \param dest variable for the return value, NULL if the value is not used
+ */
+void generate_user_call(TBinaryTree* tree, TFunctionInfo* function, const TTerm* dest){
+    if(function->has_frame){
+        cg_create_frame();
+    }
+    linked_list_t params = function->params;
+    set_first_llist(&params);
+    int arg_count = 0;
+    char* param_name;
+    while(BT_has_right(tree) && get_value_llist(&params, &param_name)){
+        BT_go_right(tree);
+        TTerm param = {.type = CG_VARIABLE_T, .value.var_name = param_name, .frame = TEMPORARY};
+        cg_create_var(param);
+        cg_move(param, node_to_term_rval(tree));
+        next_llist(&params);
+        arg_count++;
+    }
+    while(arg_count > 0){
+        BT_go_parent(tree);
+        arg_count--;
+    }
+    cg_call(function->name);
+    if(dest != NULL){
+        cg_move(*dest, cg_var_retval);
+    }
+}
+
+/**
+ * Generates built-in function call as inline instructions
  * \param tree abstract syntactic tree
+ * \param intrinsic built-in function with inline lowering
+ * \param dest variable for the return value, NULL if the value is not used
  */
-void generate_call(TBinaryTree* tree){
+void generate_intrinsic(TBinaryTree* tree, const TIntrinsic* intrinsic, const TTerm* dest){
+    TTerm args[MAX_INTRINSIC_ARGS];
+    int arg_count = 0;
+    while(BT_has_right(tree)){
+        BT_go_right(tree);
+        if(arg_count < MAX_INTRINSIC_ARGS){
+            args[arg_count] = node_to_term_rval(tree);
+        }
+        arg_count++;
+    }
+    while(arg_count > 0){
+        BT_go_parent(tree);
+        arg_count--;
+    }
+    intrinsic->lower(dest != NULL ? *dest : cg_var_retval, args);
+}
+
+/**
+ * Pushes arguments to the stack and calls function, built-in functions are lowered inline if possible
+ * \param tree abstract syntactic tree
+ * \param dest variable for the return value, NULL if the value is not used
+ */
+void generate_call(TBinaryTree* tree, const TTerm* dest){
     node_data fun_data;
     if(!BT_get_data(tree, &fun_data)){
-        error = ERR_COMPILER_INTERNAL;
+        ctx->error = ERR_COMPILER_INTERNAL;
+        return;
+    }
+    const TIntrinsic* intrinsic = get_intrinsic(fun_data.nodeData.identifier.identifier);
+    if(intrinsic != NULL && intrinsic->lower != NULL && ctx->optimization >= OPT_BASIC){
+        generate_intrinsic(tree, intrinsic, dest);
+        return;
+    }
+    if(intrinsic != NULL){
+        ctx->intrinsics_used |= 1u << (intrinsic - intrinsics);
+    }
+    TFunctionInfo* function = get_function(fun_data.nodeData.identifier.identifier);
+    if(function != NULL && ctx->optimization >= OPT_BASIC){
+        generate_user_call(tree, function, dest);
         return;
     }
     int arg_count = 0;
@@ -1300,6 +1946,9 @@ void generate_call(TBinaryTree* tree){
         arg_count--;
     }
     cg_call(fun_data.nodeData.identifier.identifier);
+    if(dest != NULL){
+        cg_move(*dest, cg_var_retval);
+    }
 }
 
 /**
@@ -1310,22 +1959,21 @@ void generate_var_declaration(TBinaryTree* tree){
     node_data data;
     node_type type;
     if(!BT_get_data(tree, &data)){
-        error = ERR_COMPILER_INTERNAL;
+        ctx->error = ERR_COMPILER_INTERNAL;
         return;
     }
-    TTerm variable = {.type = CG_VARIABLE_T, .value.var_name = data.nodeData.identifier.identifier, .frame = LOCAL};
+    TTerm variable = {.type = CG_VARIABLE_T, .value.var_name = data.nodeData.identifier.identifier, .frame = ctx->var_frame};
     if(insert(variable.value.var_name)){
         cg_create_var(variable);
     }
     if(BT_has_left(tree)){
         BT_go_left(tree);
         if(!BT_get_node_type(tree, &type)){
-            error = ERR_COMPILER_INTERNAL;
+            ctx->error = ERR_COMPILER_INTERNAL;
             return;
         }
         if(type == FUNCTION_CALL){
-            generate_call(tree);
-            cg_move(variable, cg_var_retval);
+            generate_call(tree, &variable);
         }
         else{
             cg_stack_clear();
@@ -1344,13 +1992,12 @@ void generate_assignment(TBinaryTree* tree){
     node_type type;
     node_data data;
     BT_get_data(tree, &data);
-    TTerm var = {.type = CG_VARIABLE_T, .value.var_name = data.nodeData.identifier.identifier, .frame = LOCAL};
+    TTerm var = {.type = CG_VARIABLE_T, .value.var_name = data.nodeData.identifier.identifier, .frame = ctx->var_frame};
     BT_go_left(tree);
     BT_get_node_type(tree, &type);
     if(strcmp("_", var.value.var_name) != 0){
         if(type == FUNCTION_CALL){
-            generate_call(tree);
-            cg_move(var, cg_var_retval);
+            generate_call(tree, &var);
         }
         else{
             calculate_expression(tree);
@@ -1396,7 +2043,7 @@ void generate_if(TBinaryTree* tree){
     // Jump
     cg_stack_pop(cg_var_temp);
     if(data.nodeData.body.is_nullable){
-        TTerm replacement = {.type = CG_VARIABLE_T, .value.var_name = data.nodeData.body.null_replacement, .frame = LOCAL};
+        TTerm replacement = {.type = CG_VARIABLE_T, .value.var_name = data.nodeData.body.null_replacement, .frame = ctx->var_frame};
         if(insert(replacement.value.var_name)){
             cg_create_var(replacement);
         }
@@ -1423,7 +2070,7 @@ void generate_while_declarations(TBinaryTree* tree){
         node_data data;
         BT_get_node_type(tree, &type);
         BT_get_data(tree, &data);
-        TTerm variable = {.type = CG_VARIABLE_T, .frame = LOCAL};
+        TTerm variable = {.type = CG_VARIABLE_T, .frame = ctx->var_frame};
         switch(type){
             case CONST_DECL:
             case VAR_DECL:
@@ -1458,7 +2105,121 @@ void generate_while_declarations(TBinaryTree* tree){
 }
 
 
-bool generated = false; // Tells generate_while function if it is generating nested while cycle
+/**
+ * Evaluates expression consisting only of i32/f64 literals at compile time
+ * \param tree abstract syntactic tree with active node containing expression
+ * \param[out] value Value of the expression, truth value of relation operators is 1 or 0
+ * \return True: Expression is constant, False: Expression depends on variables or its value is unknown
+ */
+bool const_expression_value(TBinaryTree* tree, double* value){
+    node_type type;
+    node_data data;
+    if(!BT_get_node_type(tree, &type) || !BT_get_data(tree, &data)){
+        return false;
+    }
+    if(type == INT || type == FL){
+        *value = strtod(data.nodeData.value.literal, NULL);
+        return true;
+    }
+    if(type < OP_ADD || type > OP_LSE || !BT_has_left(tree) || !BT_has_right(tree)){
+        return false;
+    }
+    double left, right;
+    BT_go_left(tree);
+    bool is_const = const_expression_value(tree, &left);
+    BT_go_parent(tree);
+    BT_go_right(tree);
+    is_const = is_const && const_expression_value(tree, &right);
+    BT_go_parent(tree);
+    if(!is_const){
+        return false;
+    }
+    switch(type){
+        case OP_ADD:
+            *value = left + right;
+            break;
+        case OP_SUB:
+            *value = left - right;
+            break;
+        case OP_MUL:
+            *value = left * right;
+            break;
+        case OP_DIV:
+            return false; // Division by zero and integer rounding are left to the interpreter
+        case OP_EQ:
+            *value = left == right;
+            break;
+        case OP_NEQ:
+            *value = left != right;
+            break;
+        case OP_GT:
+            *value = left > right;
+            break;
+        case OP_LS:
+            *value = left < right;
+            break;
+        case OP_GTE:
+            *value = left >= right;
+            break;
+        case OP_LSE:
+            *value = left <= right;
+            break;
+        default:
+            return false;
+    }
+    return true;
+}
+
+/**
+ * Checks if the condition of while cycle is proven to be true before the first iteration. Only conditions made of
+ * literals are proven, values of variables at the loop entry are not tracked, so loops like while (i < n) keep
+ * the entry guard
+ * \param tree abstract syntactic tree with active node containing while
+ * \return True: Condition is constant and true
+ */
+bool while_condition_true(TBinaryTree* tree){
+    double value = 0;
+    BT_go_left(tree);
+    bool is_const = const_expression_value(tree, &value);
+    BT_go_parent(tree);
+    return is_const && value != 0;
+}
+
+/**
+ * Generates rotated while cycle, condition is tested at the bottom with a single conditional back-edge
+ * \param tree abstract syntactic tree
+ * \param data while node data
+ */
+void generate_rotated_while(TBinaryTree* tree, node_data data){
+    // Labels
+    TLabel while_body = cg_get_new_label();
+    TLabel while_test = cg_get_new_label();
+    // Entry guard, skipped when the first test is known to pass
+    if(data.nodeData.body.is_nullable || !while_condition_true(tree)){
+        cg_jump(while_test);
+    }
+    // Body
+    cg_create_label(while_body);
+    if(data.nodeData.body.is_nullable){
+        TTerm replacement = {.type = CG_VARIABLE_T, .value.var_name = data.nodeData.body.null_replacement, .frame = ctx->var_frame};
+        cg_move(replacement, cg_var_temp);
+    }
+    generate_function_body(tree);
+    // Expression
+    cg_create_label(while_test);
+    BT_go_left(tree);
+    calculate_expression(tree);
+    BT_go_parent(tree);
+    // Back-edge
+    cg_stack_pop(cg_var_temp);
+    if(data.nodeData.body.is_nullable){
+        cg_jump_neq(while_body, cg_var_temp, cg_null_term);
+    }
+    else{
+        cg_jump_neq(while_body, cg_var_temp, cg_false_term);
+    }
+}
+
 /**
  * Generates while cycle
  * \param tree abstract syntactic tree
@@ -1472,12 +2233,19 @@ void generate_while(TBinaryTree* tree){
     TLabel while_end = cg_get_new_label();
     // Declarations
     bool unlock = false;
-    if(!generated){
+    if(!ctx->generated){
         BT_go_parent(tree);
         generate_while_declarations(tree);
         BT_go_left(tree);
         unlock = true;
-        generated = true;
+        ctx->generated = true;
+    }
+    if(ctx->optimization >= OPT_BASIC){
+        generate_rotated_while(tree, data);
+        if(unlock){
+            ctx->generated = false;
+        }
+        return;
     }
     // Expression
     cg_create_label(while_beg);
@@ -1488,7 +2256,7 @@ void generate_while(TBinaryTree* tree){
     cg_stack_pop(cg_var_temp);
     if(data.nodeData.body.is_nullable){
         cg_jump_eq(while_end, cg_var_temp, cg_null_term);
-        TTerm replacement = {.type = CG_VARIABLE_T, .value.var_name = data.nodeData.body.null_replacement, .frame = LOCAL};
+        TTerm replacement = {.type = CG_VARIABLE_T, .value.var_name = data.nodeData.body.null_replacement, .frame = ctx->var_frame};
         cg_move(replacement, cg_var_temp);
     }
     else{
@@ -1498,7 +2266,7 @@ void generate_while(TBinaryTree* tree){
     cg_jump(while_beg);
     cg_create_label(while_end);
     if(unlock){
-        generated = false;
+        ctx->generated = false;
     }
 }
 /**
@@ -1509,10 +2277,12 @@ void generate_command(TBinaryTree* tree){
     if(!BT_has_left(tree)){
         return;
     }
+    // The command is created at the first token of the statement
+    ir_position position = cg_position(tree->active);
     BT_go_left(tree);
     node_type type;
     if(!BT_get_node_type(tree, &type)){
-        error = ERR_COMPILER_INTERNAL;
+        ctx->error = ERR_COMPILER_INTERNAL;
         return;
     }
     switch(type){
@@ -1539,13 +2309,14 @@ void generate_command(TBinaryTree* tree){
             // Do nothing
             break;
         case FUNCTION_CALL:
-            generate_call(tree);
+            generate_call(tree, NULL);
             break;
         default:
-            error = ERR_COMPILER_INTERNAL;
+            ctx->error = ERR_COMPILER_INTERNAL;
             break;
     }
     BT_go_parent(tree);
+    ctx->cg_position = position;
 }
 
 void generate_function_body(TBinaryTree* tree){
@@ -1566,57 +2337,97 @@ void generate_function_body(TBinaryTree* tree){
 void generate_function(TBinaryTree* tree){
     node_data data;
     BT_get_data(tree, &data);
+    TFunctionInfo* function = get_function(data.nodeData.function.identifier);
+    if(function == NULL){
+        ctx->error = ERR_COMPILER_INTERNAL;
+        return;
+    }
+    ir_position position = cg_position(tree->active);
     // Creating function label and memory frame
     generate_comment(data.nodeData.function.identifier); // Comment
     cg_create_fun(data.nodeData.function.identifier);
-    cg_create_frame();
-    cg_push_frame();
-    // Creating variables for the parameters, moving arguments to the variables
-    generate_function_parameters(data.nodeData.function.param_identifiers);
+    ctx->var_frame = function->frame;
+    ctx->frame_pushed = function->frame == LOCAL && function->has_frame;
+    if(ctx->optimization < OPT_BASIC){
+        // Creating variables for the parameters, moving arguments from stack to the variables
+        cg_create_frame();
+        cg_push_frame();
+        generate_function_parameters(data.nodeData.function.param_identifiers);
+    }
+    else if(ctx->frame_pushed){
+        // Parameters were already defined by the caller in TF
+        cg_push_frame();
+        generate_comment("Frame slots:");
+        allocate_frame_slots(tree->active, data.nodeData.function.param_identifiers);
+    }
     generate_function_body(tree);
     // Creating return value
     generate_return(NULL);
     // Dispose var tree
     dispose();
+    ctx->cg_position = position;
 }
 
 /**
- * Generates IFJ24 built-in functions
+ * Generates IFJ24 built-in functions, that are still called
  */
 void generate_builtin(void){
     generate_comment("____IFJ BUILT-IN____");
-    cg_ifj_readstr();
-    cg_ifj_readi32();
-    cg_ifj_readf64();
-    cg_ifj_write();
-    cg_ifj_i2f();
-    cg_ifj_f2i();
-    cg_ifj_string();
-    cg_ifj_length();
-    cg_ifj_concat();
-    cg_ifj_substring();
-    cg_ifj_strcmp();
-    cg_ifj_ord();
-    cg_ifj_chr();
+    for(size_t i = 0; i < INTRINSIC_COUNT; i++){
+        if(ctx->intrinsics_used & (1u << i)){
+            intrinsics[i].helper();
+        }
+    }
 }
 
-void codegen(TBinaryTree* tree){
-    if(tree == NULL){
-        error = ERR_COMPILER_INTERNAL;
-        return;
-    }
-    BT_assign_parents(tree);
+void codegen_dispose(void){
+    dispose();
+    dispose_functions();
+}
+
+void codegen_prologue(void){
+    qsort(ctx->functions, ctx->function_count, sizeof(TFunctionInfo), compare_functions);
     generate_comment("Init:");
     cg_init();
     generate_comment("Generating program:");
     generate_comment("Main function call:");
+    TFunctionInfo* main_function = get_function("main");
+    if(main_function != NULL && main_function->has_frame && ctx->optimization >= OPT_BASIC){
+        cg_create_frame();
+    }
     cg_call("main");
     cg_exit(cg_zero_int_term);
     generate_comment("Function definitions:");
+}
+
+void codegen_function(TBinaryTree* tree){
+    BT_assign_parents(tree);
+    BT_set_root(tree);
+    BT_go_left(tree);
+    generate_function(tree);
+    dispose_slot_names();
+}
+
+void codegen_epilogue(void){
+    generate_builtin();
+    dispose_functions();
+}
+
+void codegen(TBinaryTree* tree){
+    if(tree == NULL){
+        ctx->error = ERR_COMPILER_INTERNAL;
+        return;
+    }
+    BT_assign_parents(tree);
+    analyze_functions(tree);
+    if(ctx->error){
+        return;
+    }
+    codegen_prologue();
     BT_set_root(tree);
     while(BT_has_left(tree)){
         BT_go_left(tree);
         generate_function(tree);
     }
-    generate_builtin();
+    codegen_epilogue();
 }
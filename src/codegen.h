@@ -9,10 +9,53 @@
 #ifndef CODEGEN_H
 #define CODEGEN_H
 
+#include "binary_tree.h"
+
 /**
- * Generates IFJcode24 from syntactically and semantically correct abstract syntactic tree to stdout
+ * Generates IFJcode24 instruction stream from syntactically and semantically correct abstract syntactic tree
  * \param tree abstract syntactic tree
  */
 void codegen(TBinaryTree* tree);
 
+/**
+ * Frees tables of the generator left by codegen stopped on error
+ */
+void codegen_dispose(void);
+
+/*
+ * Generation of one function at a time used by --stream, the functions are declared from their headers first:
+ * codegen_declare_function for every function, codegen_prologue, codegen_function for every function in the order
+ * of the source code and codegen_epilogue.
+ */
+
+/**
+ * Checks if function call is lowered inline and does not touch memory frames
+ * \param function function identifier
+ */
+bool is_inline_call(char* function);
+
+/**
+ * Chooses calling convention of user function
+ * \param function node of the function definition
+ * \param has_locals body of the function declares variables
+ * \param has_calls body of the function calls a function, that is not lowered inline
+ */
+void codegen_declare_function(TNode* function, bool has_locals, bool has_calls);
+
+/**
+ * Generates start of the program calling main, every function has to be declared
+ */
+void codegen_prologue(void);
+
+/**
+ * Generates function
+ * \param tree abstract syntactic tree with the function as the left child of the root
+ */
+void codegen_function(TBinaryTree* tree);
+
+/**
+ * Generates called built-in functions and frees tables of the generator
+ */
+void codegen_epilogue(void);
+
 #endif
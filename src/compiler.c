@@ -0,0 +1,263 @@
+/**
+ * Název projektu: Implementace překladače imperativního jazyka IFJ24.
+ *
+ * @file compiler.c
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "compiler.h"
+#include "compiler_error.h"
+#include "codegen.h"
+#include "lexer.h"
+#include "stats.h"
+#include "syna.h"
+
+__thread compiler_context* ctx = NULL;
+
+unsigned int compile_with_settings(FILE* source, const compile_settings* settings, ir_program* program){
+    compiler_context context = {
+        .optimization = settings->optimization,
+        .lexer_thread = settings->lexer_thread,
+        .messages = settings->messages,
+        .errors = settings->errors,
+        .cg_operand_type = IR_TYPE_ANY,
+        .var_frame = LOCAL,
+    };
+    ctx = &context;
+    init_scanner(source);
+    if(context.lexer_thread){
+        start_scanner_thread();
+    }
+
+    token_t first = {.id = TOKEN_DEFAULT};
+    stats_enter(STATS_PARSE);
+    init_parser(first);
+    stats_leave();
+
+    codegen_dispose();
+    dispose_scanner();
+    if(context.error){
+        ir_dispose(&context.generated_code);
+    }
+    stats_count(STATS_INSTRUCTIONS, context.generated_code.count);
+    *program = context.generated_code;
+    ctx = NULL;
+    return context.error;
+}
+
+unsigned int compile(FILE* source, opt_level optimization, ir_program* program){
+    compile_settings settings = compile_settings_from_options();
+    settings.optimization = optimization;
+    return compile_with_settings(source, &settings, program);
+}
+
+compile_settings compile_settings_from_options(void){
+    return (compile_settings){
+        .optimization = options.optimization,
+        .lexer_thread = options.lexer_thread,
+        .messages = stdout,
+        .errors = stderr,
+    };
+}
+
+int compile_jobs(int jobs){
+    if(jobs > 0){
+        return jobs;
+    }
+    long processors = sysconf(_SC_NPROCESSORS_ONLN);
+    return processors > 0 ? (int)processors : 1;
+}
+
+// Batch compilation
+
+typedef struct batch{
+    char** files;
+    size_t count;
+    size_t next;    // Index of the next file taken by a worker, updated atomically
+    bool failed;    // Some output could not be written
+} batch_t;
+
+/**
+ * Reads paths from the batch list, empty lines are skipped
+ * \param list
+ * \param batch
+ * \return true: success, false: the list could not be read
+ */
+static bool batch_read_list(const char* list, batch_t* batch){
+    FILE* file = fopen(list, "r");
+    if(file == NULL){
+        return false;
+    }
+    size_t capacity = 0;
+    char* line = NULL;
+    size_t line_size = 0;
+    ssize_t length;
+    bool success = true;
+    while((length = getline(&line, &line_size, file)) != -1){
+        while(length > 0 && (line[length - 1] == '\n' || line[length - 1] == '\r')){
+            line[--length] = '\0';
+        }
+        if(length == 0){
+            continue;
+        }
+        if(batch->count == capacity){
+            capacity = capacity ? capacity * 2 : 64;
+            char** files = realloc(batch->files, capacity * sizeof(char*));
+            if(files == NULL){
+                success = false;
+                break;
+            }
+            batch->files = files;
+        }
+        if((batch->files[batch->count] = strdup(line)) == NULL){
+            success = false;
+            break;
+        }
+        batch->count++;
+    }
+    free(line);
+    fclose(file);
+    return success;
+}
+
+/**
+ * Creates path of output file of the source, .zig extension is replaced by the suffix
+ * \param source
+ * \param suffix
+ * \return path, has to be freed | NULL on allocation error
+ */
+static char* batch_output_path(const char* source, const char* suffix){
+    size_t length = strlen(source);
+    if(length > 4 && strcmp(source + length - 4, ".zig") == 0){
+        length -= 4;
+    }
+    char* path = malloc(length + strlen(suffix) + 1);
+    if(path != NULL){
+        memcpy(path, source, length);
+        strcpy(path + length, suffix);
+    }
+    return path;
+}
+
+/**
+ * Writes the generated program or empty file on error, the exit code and the diagnostics of the compilation
+ * \param source
+ * \param program
+ * \param exit_code
+ * \param diagnostics messages and internal errors of the compilation
+ * \param diagnostics_length
+ * \return true: success, false: an output could not be written
+ */
+static bool batch_write(const char* source, const ir_program* program, unsigned int exit_code,
+                        const char* diagnostics, size_t diagnostics_length){
+    char* code_path = batch_output_path(source, ".code");
+    char* rc_path = batch_output_path(source, ".rc");
+    char* err_path = batch_output_path(source, ".err");
+    bool success = code_path != NULL && rc_path != NULL && err_path != NULL;
+    FILE* out;
+    if(success && (out = fopen(code_path, "w")) != NULL){
+        if(exit_code == 0){
+            ir_print(program, out);
+        }
+        success = fclose(out) == 0;
+    }
+    else{
+        success = false;
+    }
+    if(success && (out = fopen(rc_path, "w")) != NULL){
+        fprintf(out, "%u\n", exit_code);
+        success = fclose(out) == 0;
+    }
+    else{
+        success = false;
+    }
+    if(success && (out = fopen(err_path, "w")) != NULL){
+        if(diagnostics_length > 0){
+            fwrite(diagnostics, 1, diagnostics_length, out);
+        }
+        success = fclose(out) == 0;
+    }
+    else{
+        success = false;
+    }
+    free(code_path);
+    free(rc_path);
+    free(err_path);
+    return success;
+}
+
+static void* batch_worker(void* argument){
+    batch_t* batch = argument;
+    size_t index;
+    while((index = __atomic_fetch_add(&batch->next, 1, __ATOMIC_RELAXED)) < batch->count){
+        const char* path = batch->files[index];
+        ir_program program = {0};
+        unsigned int exit_code = ERR_COMPILER_INTERNAL;
+        // Every file gets its own diagnostics, so messages of files compiled at once do not interleave
+        char* diagnostics = NULL;
+        size_t diagnostics_length = 0;
+        compile_settings settings = compile_settings_from_options();
+        settings.messages = settings.errors = open_memstream(&diagnostics, &diagnostics_length);
+        FILE* source = fopen(path, "r");
+        if(source != NULL && settings.messages != NULL){
+            exit_code = compile_with_settings(source, &settings, &program);
+            if(exit_code != 0){
+                fprint_error(settings.messages, exit_code);
+            }
+        }
+        else if(source == NULL){
+            fprintf(stderr, "cannot open '%s'\n", path);
+        }
+        if(source != NULL){
+            fclose(source);
+        }
+        bool written = settings.messages != NULL && fclose(settings.messages) == 0;
+        if(!written || !batch_write(path, &program, exit_code, diagnostics, diagnostics_length)){
+            fprintf(stderr, "cannot write output of '%s'\n", path);
+            __atomic_store_n(&batch->failed, true, __ATOMIC_RELAXED);
+        }
+        free(diagnostics);
+        ir_dispose(&program);
+    }
+    return NULL;
+}
+
+int compile_batch(const char* list, int jobs){
+    batch_t batch = {0};
+    if(!batch_read_list(list, &batch)){
+        fprintf(stderr, "cannot read batch list '%s'\n", list);
+        for(size_t i = 0; i < batch.count; i++){
+            free(batch.files[i]);
+        }
+        free(batch.files);
+        return ERR_COMPILER_INTERNAL;
+    }
+    jobs = compile_jobs(jobs);
+    if((size_t)jobs > batch.count){
+        jobs = batch.count > 0 ? (int)batch.count : 1;
+    }
+
+    // The calling thread is one of the workers
+    pthread_t* threads = malloc(sizeof(pthread_t) * jobs);
+    int started = 0;
+    if(threads != NULL){
+        while(started < jobs - 1 && pthread_create(&threads[started], NULL, batch_worker, &batch) == 0){
+            started++;
+        }
+    }
+    batch_worker(&batch);
+    for(int i = 0; i < started; i++){
+        pthread_join(threads[i], NULL);
+    }
+    free(threads);
+
+    for(size_t i = 0; i < batch.count; i++){
+        free(batch.files[i]);
+    }
+    free(batch.files);
+    return batch.failed ? ERR_COMPILER_INTERNAL : 0;
+}
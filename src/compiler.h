@@ -0,0 +1,120 @@
+/**
+ * Název projektu: Implementace překladače imperativního jazyka IFJ24.
+ *
+ * @file compiler.h
+ */
+
+#ifndef COMPILER_H
+#define COMPILER_H
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "ir.h"
+#include "lexer.h"
+#include "options.h"
+#include "syna.h"
+
+// Settings of one compilation chosen by its caller, the compiler does not read the command line options
+typedef struct compile_settings{
+    opt_level optimization;             // Optimization level of the generated code
+    bool lexer_thread;                  // Tokens are scanned ahead on a separate thread
+    FILE* messages;                     // Diagnostics of the compiled program, stdout of the command line compiler
+    FILE* errors;                       // Internal errors of the compiler, stderr of the command line compiler
+} compile_settings;
+
+/*
+ * State of one compilation. Modules of the compiler reach the context of the running compilation through ctx,
+ * the pointer is local to the thread, so compilations on different threads are independent.
+ */
+typedef struct compiler_context{
+    unsigned int error;                 // Error code of the compilation, 0 until an error is found
+    opt_level optimization;             // Optimization level of the generated code
+    bool lexer_thread;                  // Tokens are scanned ahead on a separate thread
+    FILE* messages;                     // Diagnostics of the compiled program, NULL for stdout
+    FILE* errors;                       // Internal errors of the compiler, NULL for stderr
+
+    // Lexical analysis
+    scanner_t scanner;
+
+    // Precedence analysis
+    int relative_op_count;              // Relational operators in the current expression
+    struct TScope current_symtable_scope;
+    TData retrieved_data;
+    TSymtable* identifier_residence;
+
+    // Semantic analysis
+    bool hasReturn;                     // Currently checked function has a return statement
+    TSymtable* globalSymTable;
+
+    // Code generation
+    ir_program generated_code;          // Instruction stream of the generated program
+    ir_value_type cg_operand_type;      // Type of operands of the emitted instructions proven by semantic analysis
+    ir_position cg_position;            // Source position of the generated node, given to the emitted instructions
+    unsigned long long label_count;     // Labels are numbered from 0 in every compilation
+    unsigned intrinsics_used;           // Bit per built-in function, its body has to be generated
+    struct element* var_tree;           // Variables declared in the currently generated function
+    struct function_info* functions;    // Calling convention of user functions, sorted by name
+    size_t function_count, function_capacity;
+    Frame var_frame;                    // Frame of the variables of currently generated function
+    bool frame_pushed;                  // Currently generated function pushed its own frame, return has to pop it
+    char** slot_names;                  // Names of allocated slots, referenced from the AST until the end of codegen
+    size_t slot_name_count;
+    bool generated;                     // Tells generate_while function if it is generating nested while cycle
+} compiler_context;
+
+// Context of the compilation running on this thread
+extern __thread compiler_context* ctx;
+
+// Stream for diagnostics of the running compilation, a context created without streams prints like the command line
+static inline FILE* compiler_messages(void){
+    return ctx->messages != NULL ? ctx->messages : stdout;
+}
+
+// Stream for internal errors of the running compilation
+static inline FILE* compiler_errors(void){
+    return ctx->errors != NULL ? ctx->errors : stderr;
+}
+
+/**
+ * Compiles IFJ24 source code in a new context with the settings of the command line compiler
+ * \param source stream with the source code
+ * \param optimization optimization level of the generated code
+ * \param program generated code, has to be disposed by ir_dispose | empty program on error
+ * \return 0: success, error code of the compiler
+ */
+unsigned int compile(FILE* source, opt_level optimization, ir_program* program);
+
+/**
+ * Compiles IFJ24 source code in a new context
+ * \param source stream with the source code
+ * \param settings optimization level, lexer thread and streams for diagnostics of the compilation
+ * \param program generated code, has to be disposed by ir_dispose | empty program on error
+ * \return 0: success, error code of the compiler
+ */
+unsigned int compile_with_settings(FILE* source, const compile_settings* settings, ir_program* program);
+
+/**
+ * Settings of the command line compiler given by its options, diagnostics are printed to stdout and stderr
+ * \return settings
+ */
+compile_settings compile_settings_from_options(void);
+
+/**
+ * Count of worker threads of batch and server
+ * \param jobs requested count, 0 for count of online processors
+ * \return count of threads
+ */
+int compile_jobs(int jobs);
+
+/**
+ * Compiles every file listed in the batch list on worker threads. Program generated from <file>.zig is written
+ * to <file>.code, exit code of its compilation to <file>.rc and its diagnostics to <file>.err, other names get
+ * the suffixes appended.
+ * \param list path to file with one path to source code per line
+ * \param jobs count of worker threads, 0 for count of online processors
+ * \return 0: every file was compiled, ERR_COMPILER_INTERNAL: the list or some output could not be read or written
+ */
+int compile_batch(const char* list, int jobs);
+
+#endif
@@ -9,9 +9,6 @@
 #include "compiler_error.h"
 #include <stdio.h>
 
-/* Global variable for error code */
-unsigned int error = 0;
-
 /* Array of string messages containing the information about given error code */
 static const char *error_msg[] = {
 	GREEN("SUCCESS")" -  Preklad probehl uspesne",
@@ -30,8 +27,13 @@ static const char *error_msg[] = {
 
 /* error print function - prints the message bound to its error code */
 void print_error(unsigned int err) {
+	fprint_error(stderr, err);
+}
+
+/* prints the message bound to its error code to the given stream */
+void fprint_error(FILE *stream, unsigned int err) {
 
 	unsigned int size = sizeof(error_msg) / sizeof(char *); 
 
-	fprintf(stderr, RED_BOLD("error") "(%02d): %s\n", err, error_msg[err == ERR_COMPILER_INTERNAL ? (size - 1) : err]);
+	fprintf(stream, RED_BOLD("error") "(%02d): %s\n", err, error_msg[err == ERR_COMPILER_INTERNAL ? (size - 1) : err]);
 }
\ No newline at end of file
@@ -8,6 +8,8 @@
 #ifndef COMPILER_ERROR_H
 #define COMPILER_ERROR_H
 
+#include <stdio.h>
+
 /* Error code definition */
 typedef enum error_code {
 	SUCCESS = 0, /* Preklad probehl uspesne */
@@ -31,10 +33,10 @@ typedef enum error_code {
 #define YELLOW_BOLD(msg) "\033[1;33m" msg "\033[0;37m"
 #define WHITE_BOLD(msg) "\033[1;37m" msg "\033[0;37m"
 
-/* Shared global variable error */
-extern unsigned int error;
-
 /* prints information about error */
 void print_error(unsigned int err);
 
+/* prints information about error to the stream */
+void fprint_error(FILE *stream, unsigned int err);
+
 #endif 
\ No newline at end of file
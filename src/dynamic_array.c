@@ -10,85 +10,86 @@
 #include "stdio.h"
 #include "stdlib.h"
 #include "dynamic_array.h"
+#include "compiler.h"
 #include "compiler_error.h"
 
 void d_array_init(dynamic_array* array, int cap){
     if(array == NULL) {
-        error = ERR_COMPILER_INTERNAL;
-        fprintf(stderr, "Error: an empty pointer was given to d_array_init function");
+        ctx->error = ERR_COMPILER_INTERNAL;
+        fprintf(compiler_errors(), "Error: an empty pointer was given to d_array_init function");
     }else {
         array->array = (char *) calloc(cap + 1, sizeof(char));
         if (array->array == NULL) {
-            fprintf(stderr, "Error: an error occured during the alocation of the dynamic array");
-            error = ERR_COMPILER_INTERNAL;
+            fprintf(compiler_errors(), "Error: an error occured during the alocation of the dynamic array");
+            ctx->error = ERR_COMPILER_INTERNAL;
         }else {
             //setting default values
             array->capacity = cap;
             array->length = 0;
-            error = SUCCESS;
+            ctx->error = SUCCESS;
         }
     }
 }
 
 void d_array_append(dynamic_array* array, char element){
     if(array == NULL){
-        error = ERR_COMPILER_INTERNAL;
-        fprintf(stderr, "Error: an empty pointer was given to d_array_append function");
+        ctx->error = ERR_COMPILER_INTERNAL;
+        fprintf(compiler_errors(), "Error: an empty pointer was given to d_array_append function");
     }else {
         if (array->capacity == array->length) {
             array->capacity += array->capacity;
             array->array = (char *) realloc(array->array, (array->capacity + 1) * sizeof(char));
         }
         if (array->array == NULL) {
-            fprintf(stderr, "Error: an error occured during the realocation of the dynamic array");
-            error = ERR_COMPILER_INTERNAL;
+            fprintf(compiler_errors(), "Error: an error occured during the realocation of the dynamic array");
+            ctx->error = ERR_COMPILER_INTERNAL;
         }else {
             //appending the new element
             array->array[array->length] = element;
             array->length++;
             array->array[array->length] = '\0';
 
-            error = SUCCESS;
+            ctx->error = SUCCESS;
         }
     }
 }
 
 void d_array_set(dynamic_array* array, char element, int index){
     if(array == NULL){
-        error = ERR_COMPILER_INTERNAL;
-        fprintf(stderr, "Error: an empty pointer was given to d_array_set function");
+        ctx->error = ERR_COMPILER_INTERNAL;
+        fprintf(compiler_errors(), "Error: an empty pointer was given to d_array_set function");
     }else {
         if (0 <= index && index < array->length) {
             //changing the value
             array->array[index] = element;
         } else {
-            fprintf(stderr,
+            fprintf(compiler_errors(),
                     "Error: tried to set a value of an element an a dynamic array on the index %d but that index does not exist",
                     index);
-            error = ERR_COMPILER_INTERNAL;
+            ctx->error = ERR_COMPILER_INTERNAL;
         }
     }
 }
 
 char d_array_get(dynamic_array* array, int index){
     if(array == NULL){
-        error = ERR_COMPILER_INTERNAL;
-        fprintf(stderr, "Error: an empty pointer was given to d_array_get function");
+        ctx->error = ERR_COMPILER_INTERNAL;
+        fprintf(compiler_errors(), "Error: an empty pointer was given to d_array_get function");
         return '\0';
     }
     if(0 <= index && index < array->length){
         return array->array[index];
     }else{
-        fprintf(stderr, "Error: tried to get a value of an element an a dynamic array on the index %d but that index does not exist", index);
-        error = ERR_COMPILER_INTERNAL;
+        fprintf(compiler_errors(), "Error: tried to get a value of an element an a dynamic array on the index %d but that index does not exist", index);
+        ctx->error = ERR_COMPILER_INTERNAL;
     }
     return '\0';
 }
 
 void d_array_remove(dynamic_array* array, int index){
     if(array == NULL){
-        error = ERR_COMPILER_INTERNAL;
-        fprintf(stderr, "Error: an empty pointer was given to d_array_remove function");
+        ctx->error = ERR_COMPILER_INTERNAL;
+        fprintf(compiler_errors(), "Error: an empty pointer was given to d_array_remove function");
     }else {
         if (0 <= index && index < array->length) {
             //moving the elements to take the place of the removed element
@@ -97,18 +98,18 @@ void d_array_remove(dynamic_array* array, int index){
             }
             array->length--;
         } else {
-            fprintf(stderr,
+            fprintf(compiler_errors(),
                     "Error: tried to remove an element of a dynamic array on the index %d but that index does not exist",
                     index);
-            error = ERR_COMPILER_INTERNAL;
+            ctx->error = ERR_COMPILER_INTERNAL;
         }
     }
 }
 
 void d_array_free(dynamic_array* array) {
     if(array == NULL){
-        error = ERR_COMPILER_INTERNAL;
-        fprintf(stderr, "Error: an empty pointer was given to d_array_free function");
+        ctx->error = ERR_COMPILER_INTERNAL;
+        fprintf(compiler_errors(), "Error: an empty pointer was given to d_array_free function");
     }else {
         array->length = 0;
         array->capacity = 0;
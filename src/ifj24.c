@@ -0,0 +1,59 @@
+/**
+ * Název projektu: Implementace překladače imperativního jazyka IFJ24.
+ *
+ * @file ifj24.c
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "ifj24.h"
+#include "compiler.h"
+#include "compiler_error.h"
+
+int ifj24_compile(const char* src, size_t len, ifj24_output* out, const ifj24_options* opt){
+    *out = (ifj24_output){.code = NULL, .length = 0, .diagnostics = NULL, .diagnostics_length = 0,
+                          .error = ERR_COMPILER_INTERNAL};
+    compile_settings settings = {
+        .optimization = (opt == NULL || opt->optimization >= OPT_BASIC) ? OPT_BASIC : OPT_NONE,
+        .lexer_thread = opt != NULL && opt->lexer_thread,
+    };
+    // Messages and internal errors share one stream, so they keep the order in which they were reported
+    FILE* diagnostics = open_memstream(&out->diagnostics, &out->diagnostics_length);
+    if(diagnostics == NULL){
+        return out->error;
+    }
+    settings.messages = settings.errors = diagnostics;
+
+    // The lexer reads streams, the buffer is read in place without a copy
+    FILE* source = fmemopen((void*)src, len, "r");
+    unsigned int result = ERR_COMPILER_INTERNAL;
+    ir_program program = {0};
+    if(source != NULL){
+        result = compile_with_settings(source, &settings, &program);
+        fclose(source);
+    }
+
+    FILE* code = open_memstream(&out->code, &out->length);
+    if(code != NULL && result == 0){
+        ir_print(&program, code);
+    }
+    ir_dispose(&program);
+    bool written = code != NULL && fclose(code) == 0;
+    if(fclose(diagnostics) != 0 || !written){
+        ifj24_output_free(out);
+        out->error = ERR_COMPILER_INTERNAL;
+        return out->error;
+    }
+    out->error = (int)result;
+    return out->error;
+}
+
+void ifj24_output_free(ifj24_output* out){
+    free(out->code);
+    free(out->diagnostics);
+    out->code = NULL;
+    out->length = 0;
+    out->diagnostics = NULL;
+    out->diagnostics_length = 0;
+}
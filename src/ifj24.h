@@ -0,0 +1,47 @@
+/**
+ * Název projektu: Implementace překladače imperativního jazyka IFJ24.
+ *
+ * @file ifj24.h
+ */
+
+#ifndef IFJ24_H
+#define IFJ24_H
+
+#include <stddef.h>
+
+/*
+ * Embeddable interface of the compiler built into libifj24.a by make lib. Every call compiles in its own context
+ * with the options given to it, calls may run concurrently on different threads. Nothing is printed, diagnostics
+ * of the compiler are returned in the output.
+ */
+
+typedef struct ifj24_options{
+    int optimization;   // 0: -O0, 1: -O1 (default)
+    int lexer_thread;   // Nonzero: tokens are scanned ahead on a separate thread (default 0)
+} ifj24_options;
+
+typedef struct ifj24_output{
+    char* code;                 // IFJcode24 terminated by '\0', empty on error, freed by ifj24_output_free
+    size_t length;              // Length of code without the terminator
+    char* diagnostics;          // Messages of the compiler terminated by '\0', freed by ifj24_output_free
+    size_t diagnostics_length;  // Length of diagnostics without the terminator, 0 when nothing was reported
+    int error;                  // Exit code of the compiler, 0 on success
+} ifj24_output;
+
+/**
+ * Compiles IFJ24 source code
+ * \param src source code, does not have to be terminated by '\0'
+ * \param len length of the source code
+ * \param out generated code, diagnostics and the exit code
+ * \param opt options | NULL for defaults
+ * \return exit code of the compiler: 0 success, 1-10 error in the program, 99 internal error
+ */
+int ifj24_compile(const char* src, size_t len, ifj24_output* out, const ifj24_options* opt);
+
+/**
+ * Frees generated code and diagnostics
+ * \param out
+ */
+void ifj24_output_free(ifj24_output* out);
+
+#endif
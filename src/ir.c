@@ -0,0 +1,242 @@
+/**
+ * Název projektu: Implementace překladače imperativního jazyka IFJ24.
+ *
+ * @file ir.c
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ir.h"
+
+const ir_operand ir_none = {.type = IR_NONE};
+
+static const char* opcode_names[IR_OPCODE_COUNT] = {
+    [IR_MOVE] = "move",
+    [IR_CREATEFRAME] = "createframe",
+    [IR_PUSHFRAME] = "pushframe",
+    [IR_POPFRAME] = "popframe",
+    [IR_DEFVAR] = "defvar",
+    [IR_CALL] = "call",
+    [IR_RETURN] = "return",
+    [IR_PUSHS] = "pushs",
+    [IR_POPS] = "pops",
+    [IR_CLEARS] = "clears",
+    [IR_ADD] = "add",
+    [IR_SUB] = "sub",
+    [IR_MUL] = "mul",
+    [IR_DIV] = "div",
+    [IR_IDIV] = "idiv",
+    [IR_ADDS] = "adds",
+    [IR_SUBS] = "subs",
+    [IR_MULS] = "muls",
+    [IR_DIVS] = "divs",
+    [IR_IDIVS] = "idivs",
+    [IR_LT] = "lt",
+    [IR_GT] = "gt",
+    [IR_EQ] = "eq",
+    [IR_LTS] = "lts",
+    [IR_GTS] = "gts",
+    [IR_EQS] = "eqs",
+    [IR_ORS] = "ors",
+    [IR_NOTS] = "nots",
+    [IR_INT2FLOAT] = "int2float",
+    [IR_FLOAT2INT] = "float2int",
+    [IR_INT2CHAR] = "int2char",
+    [IR_STRI2INT] = "stri2int",
+    [IR_READ] = "read",
+    [IR_WRITE] = "write",
+    [IR_CONCAT] = "concat",
+    [IR_STRLEN] = "strlen",
+    [IR_GETCHAR] = "getchar",
+    [IR_SETCHAR] = "setchar",
+    [IR_TYPE] = "type",
+    [IR_LABEL] = "label",
+    [IR_JUMP] = "jump",
+    [IR_JUMPIFEQ] = "jumpifeq",
+    [IR_JUMPIFNEQ] = "jumpifneq",
+    [IR_EXIT] = "exit",
+    [IR_COMMENT] = "#",
+};
+
+void ir_init(ir_program* program){
+    program->code = NULL;
+    program->count = 0;
+    program->capacity = 0;
+}
+
+/**
+ * Copies string of the operand, so it is owned by the program
+ * \param operand
+ * \return true: success, false: memory allocation error
+ */
+static bool ir_copy_operand(ir_operand* operand){
+    char** string = NULL;
+    switch(operand->type){
+        case IR_VAR:
+        case IR_LABEL_NAME:
+        case IR_TYPE_NAME:
+            string = &operand->value.name;
+            break;
+        case IR_STRING:
+            string = &operand->value.string;
+            break;
+        default:
+            return true;
+    }
+    char* copy = malloc(strlen(*string) + 1);
+    if(copy == NULL){
+        return false;
+    }
+    strcpy(copy, *string);
+    *string = copy;
+    return true;
+}
+
+/**
+ * Frees string of the operand
+ * \param operand
+ */
+static void ir_free_operand(ir_operand* operand){
+    switch(operand->type){
+        case IR_VAR:
+        case IR_LABEL_NAME:
+        case IR_TYPE_NAME:
+            free(operand->value.name);
+            break;
+        case IR_STRING:
+            free(operand->value.string);
+            break;
+        default:
+            break;
+    }
+}
+
+bool ir_append(ir_program* program, ir_opcode op, ir_operand arg1, ir_operand arg2, ir_operand arg3){
+    return ir_append_typed(program, op, IR_TYPE_ANY, arg1, arg2, arg3);
+}
+
+bool ir_append_typed(ir_program* program, ir_opcode op, ir_value_type operand_type, ir_operand arg1, ir_operand arg2, ir_operand arg3){
+    if(program->count == program->capacity){
+        size_t capacity = program->capacity ? program->capacity * 2 : 256;
+        ir_instruction* code = realloc(program->code, sizeof(ir_instruction) * capacity);
+        if(code == NULL){
+            return false;
+        }
+        program->code = code;
+        program->capacity = capacity;
+    }
+    ir_instruction* instruction = &program->code[program->count];
+    instruction->op = op;
+    instruction->operand_type = operand_type;
+    instruction->args[0] = arg1;
+    instruction->args[1] = arg2;
+    instruction->args[2] = arg3;
+    instruction->position = (ir_position){0, 0};
+    for(int i = 0; i < IR_MAX_OPERANDS; i++){
+        if(!ir_copy_operand(&instruction->args[i])){
+            for(int j = 0; j < i; j++){
+                ir_free_operand(&instruction->args[j]);
+            }
+            return false;
+        }
+    }
+    program->count++;
+    return true;
+}
+
+const char* ir_opcode_name(ir_opcode op){
+    if(op >= IR_OPCODE_COUNT){
+        return "";
+    }
+    return opcode_names[op];
+}
+
+void ir_print_operand(const ir_operand* operand, FILE* out){
+    static const char* frames[] = {"GF@", "LF@", "TF@"};
+    switch(operand->type){
+        case IR_VAR:
+            fprintf(out, "%sVAR_%s", frames[operand->frame], operand->value.name);
+            break;
+        case IR_INT:
+            fprintf(out, "int@%lld", operand->value.int_val);
+            break;
+        case IR_FLOAT:
+            fprintf(out, "float@%a", operand->value.float_val);
+            break;
+        case IR_BOOL:
+            fprintf(out, "bool@%s", operand->value.bool_val ? "true" : "false");
+            break;
+        case IR_STRING:
+            fputs("string@", out);
+            for(const char* c = operand->value.string; *c != '\0'; c++){
+                if(*c <= 32 || *c == '#' || *c == '\\'){ // 000-032: Unprintable characters, 035: '#', 092: '\'
+                    fprintf(out, "\\%03d", *c);
+                }
+                else{
+                    putc(*c, out);
+                }
+            }
+            break;
+        case IR_NIL:
+            fputs("nil@nil", out);
+            break;
+        case IR_LABEL_NAME:
+        case IR_TYPE_NAME:
+            fputs(operand->value.name, out);
+            break;
+        case IR_NONE:
+            break;
+    }
+}
+
+void ir_print(const ir_program* program, FILE* out){
+    fputs(".IFJcode24\n", out);
+    ir_print_code(program, out);
+}
+
+static void ir_print_instruction(const ir_instruction* instruction, FILE* out){
+    fputs(ir_opcode_name(instruction->op), out);
+    for(int j = 0; j < IR_MAX_OPERANDS && instruction->args[j].type != IR_NONE; j++){
+        putc(' ', out);
+        ir_print_operand(&instruction->args[j], out);
+    }
+    putc('\n', out);
+}
+
+void ir_print_code(const ir_program* program, FILE* out){
+    for(size_t i = 0; i < program->count; i++){
+        ir_print_instruction(&program->code[i], out);
+    }
+}
+
+size_t ir_print_mapped(const ir_program* program, FILE* out, size_t line, bool comments, FILE* table){
+    ir_position last = {0, 0};
+    for(size_t i = 0; i < program->count; i++){
+        const ir_instruction* instruction = &program->code[i];
+        ir_position position = instruction->position;
+        if(comments && instruction->op != IR_COMMENT && position.row != 0
+           && (position.row != last.row || position.col != last.col)){
+            fprintf(out, "# %u:%u\n", position.row, position.col);
+            line++;
+            last = position;
+        }
+        ir_print_instruction(instruction, out);
+        if(table != NULL && instruction->op != IR_COMMENT){
+            fprintf(table, "%zu %u %u\n", line, position.row, position.col);
+        }
+        line++;
+    }
+    return line;
+}
+
+void ir_dispose(ir_program* program){
+    for(size_t i = 0; i < program->count; i++){
+        for(int j = 0; j < IR_MAX_OPERANDS; j++){
+            ir_free_operand(&program->code[i].args[j]);
+        }
+    }
+    free(program->code);
+    ir_init(program);
+}
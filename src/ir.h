@@ -0,0 +1,211 @@
+/**
+ * Název projektu: Implementace překladače imperativního jazyka IFJ24.
+ *
+ * @file ir.h
+ */
+
+#ifndef IR_H
+#define IR_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// IFJcode24 memory frames
+typedef enum frame{
+    GLOBAL = 0,
+    LOCAL = 1,
+    TEMPORARY = 2,
+} Frame;
+
+// IFJcode24 instructions generated by codegen
+typedef enum ir_opcode{
+    // Frames and function calls
+    IR_MOVE,
+    IR_CREATEFRAME,
+    IR_PUSHFRAME,
+    IR_POPFRAME,
+    IR_DEFVAR,
+    IR_CALL,
+    IR_RETURN,
+    // Data stack
+    IR_PUSHS,
+    IR_POPS,
+    IR_CLEARS,
+    // Arithmetic, relational and logical instructions
+    IR_ADD,
+    IR_SUB,
+    IR_MUL,
+    IR_DIV,
+    IR_IDIV,
+    IR_ADDS,
+    IR_SUBS,
+    IR_MULS,
+    IR_DIVS,
+    IR_IDIVS,
+    IR_LT,
+    IR_GT,
+    IR_EQ,
+    IR_LTS,
+    IR_GTS,
+    IR_EQS,
+    IR_ORS,
+    IR_NOTS,
+    // Conversions
+    IR_INT2FLOAT,
+    IR_FLOAT2INT,
+    IR_INT2CHAR,
+    IR_STRI2INT,
+    // Input and output
+    IR_READ,
+    IR_WRITE,
+    // Strings
+    IR_CONCAT,
+    IR_STRLEN,
+    IR_GETCHAR,
+    IR_SETCHAR,
+    // Types
+    IR_TYPE,
+    // Program flow
+    IR_LABEL,
+    IR_JUMP,
+    IR_JUMPIFEQ,
+    IR_JUMPIFNEQ,
+    IR_EXIT,
+    // Not an instruction, printed as # comment
+    IR_COMMENT,
+    IR_OPCODE_COUNT
+} ir_opcode;
+
+typedef enum ir_operand_type{
+    IR_NONE,    // Unused operand
+    IR_VAR,     // Variable in frame
+    IR_INT,     // int@ literal
+    IR_FLOAT,   // float@ literal
+    IR_BOOL,    // bool@ literal
+    IR_STRING,  // string@ literal, not escaped
+    IR_NIL,     // nil@nil
+    IR_LABEL_NAME, // Label (L42, FUN_main)
+    IR_TYPE_NAME,  // Type of read instruction, text of comment
+} ir_operand_type;
+
+typedef struct ir_operand{
+    ir_operand_type type;
+    Frame frame; // In case of IR_VAR
+    union{
+        char* name; // Variable name without VAR_ prefix, label name, type name
+        long long int_val;
+        double float_val;
+        bool bool_val;
+        char* string;
+    } value;
+} ir_operand;
+
+#define IR_MAX_OPERANDS 3
+
+// Type of operands of arithmetic, relational and string instructions proven by semantic analysis
+typedef enum ir_value_type{
+    IR_TYPE_ANY,    // Not proven, operands are checked at runtime
+    IR_TYPE_I32,
+    IR_TYPE_F64,
+    IR_TYPE_STR,
+} ir_value_type;
+
+// Position in IFJ24 source code, row 0 for code without a source (program setup, built-in functions)
+typedef struct ir_position{
+    unsigned int row, col;
+} ir_position;
+
+typedef struct ir_instruction{
+    ir_opcode op;
+    ir_value_type operand_type; // Not printed, IFJcode24 has no type annotations
+    ir_operand args[IR_MAX_OPERANDS];
+    ir_position position;       // Source code the instruction was generated from
+} ir_instruction;
+
+// Instruction stream of IFJcode24 program, owns all strings of its operands
+typedef struct ir_program{
+    ir_instruction* code;
+    size_t count;
+    size_t capacity;
+} ir_program;
+
+// Unused operand
+extern const ir_operand ir_none;
+
+/**
+ * Initializes empty program
+ * \param program
+ */
+void ir_init(ir_program* program);
+
+/**
+ * Appends instruction to the program, strings of the operands are copied
+ * \param program
+ * \param op
+ * \param arg1 ir_none when unused
+ * \param arg2 ir_none when unused
+ * \param arg3 ir_none when unused
+ * \return true: success, false: memory allocation error
+ */
+bool ir_append(ir_program* program, ir_opcode op, ir_operand arg1, ir_operand arg2, ir_operand arg3);
+
+/**
+ * Appends instruction with operands of proven type
+ * \param program
+ * \param op
+ * \param operand_type IR_TYPE_ANY when the type is not known
+ * \param arg1 ir_none when unused
+ * \param arg2 ir_none when unused
+ * \param arg3 ir_none when unused
+ * \return true: success, false: memory allocation error
+ */
+bool ir_append_typed(ir_program* program, ir_opcode op, ir_value_type operand_type, ir_operand arg1, ir_operand arg2, ir_operand arg3);
+
+/**
+ * \param op
+ * \return IFJcode24 name of the instruction
+ */
+const char* ir_opcode_name(ir_opcode op);
+
+/**
+ * Prints operand in IFJcode24 notation
+ * \param operand
+ * \param out
+ */
+void ir_print_operand(const ir_operand* operand, FILE* out);
+
+/**
+ * Prints program as IFJcode24 text including the .IFJcode24 header
+ * \param program
+ * \param out
+ */
+void ir_print(const ir_program* program, FILE* out);
+
+/**
+ * Prints instructions of the program without the header, parts of a program can be printed one after another
+ * \param program
+ * \param out
+ */
+void ir_print_code(const ir_program* program, FILE* out);
+
+/**
+ * Prints instructions like ir_print_code and maps them to the source code. Instructions of a new source position
+ * are preceded by a "# row:col" comment, every instruction that is not a comment gets a line
+ * "<line of IFJcode24> <row> <col>" in the line table
+ * \param program
+ * \param out
+ * \param line line of out where the first instruction is printed
+ * \param comments print source positions as comments
+ * \param table stream for the line table, NULL without the table
+ * \return line of out after the printed code
+ */
+size_t ir_print_mapped(const ir_program* program, FILE* out, size_t line, bool comments, FILE* table);
+
+/**
+ * Frees all instructions and their strings
+ * \param program
+ */
+void ir_dispose(ir_program* program);
+
+#endif
@@ -0,0 +1,1152 @@
+/**
+ * Název projektu: Implementace překladače imperativního jazyka IFJ24.
+ *
+ * @file jit.c
+ */
+
+#include "jit.h"
+
+#ifdef VM_JIT
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include "vm.h"
+
+/*
+ * Template compiler of loaded code to x86-64. Every instruction is translated by a fixed template working
+ * with frame slots and the data stack in memory. Templates check types and frames first and exit to the
+ * interpreter before the instruction when a check fails, so the interpreter reports errors and handles strings.
+ * Frames, calls, clears and I/O are executed by the helper of the interpreter.
+ */
+
+// Longest region in instructions
+#define JIT_REGION_LIMIT 1024
+// Return addresses compared after return, other returns leave the region
+#define JIT_RETURN_LIMIT 16
+
+// Native code works with the tag at offset 0 and the payload at offset 8 of values
+typedef char jit_value_layout_check[offsetof(vm_value, type) == 0 && offsetof(vm_value, as) == 8 && sizeof(vm_value) == 16 ? 1 : -1];
+
+enum jit_register{
+    RAX = 0, RCX = 1, RDX = 2, RBX = 3, RSP = 4, RBP = 5, RSI = 6, RDI = 7,
+    R12 = 12, R13 = 13, R14 = 14, R15 = 15,
+};
+
+enum jit_xmm_register{
+    XMM0 = 0, XMM1 = 1,
+};
+
+// Registers of native code, all of them are preserved by the helper
+#define REG_CONTEXT RBX
+#define REG_STACK_USED RBP  // Used part of the data stack in bytes
+#define REG_GLOBAL R12
+#define REG_LOCAL R13
+#define REG_TEMPORARY R14
+#define REG_STACK R15
+
+#define NO_INDEX (-1)
+
+// Condition codes of jcc and setcc
+enum jit_condition{
+    CC_ALWAYS = -1,
+    CC_B = 0x2,
+    CC_AE = 0x3,
+    CC_E = 0x4,
+    CC_NE = 0x5,
+    CC_BE = 0x6,
+    CC_A = 0x7,
+    CC_NP = 0xB,
+    CC_L = 0xC,
+    CC_G = 0xF,
+};
+
+// Operations of binary instructions, the stack and three address forms share them
+typedef enum jit_operation{
+    OP_ADD,
+    OP_SUB,
+    OP_MUL,
+    OP_DIV,
+    OP_IDIV,
+    OP_LT,
+    OP_GT,
+    OP_EQ,
+} jit_operation;
+
+// Memory operand [base + index + displacement]
+typedef struct jit_memory{
+    int base;
+    int index;      // NO_INDEX | register
+    int32_t displacement;
+} jit_memory;
+
+// Value read by an instruction
+typedef struct jit_source{
+    bool constant;
+    vm_value value;     // In case of constant
+    jit_memory memory;  // Variable or slot of the data stack
+} jit_source;
+
+typedef enum jit_fixup_kind{
+    FIXUP_INSTRUCTION,  // Native code of instruction in the region
+    FIXUP_GUARD,        // Exit to the interpreter before instruction
+    FIXUP_TRANSFER,     // Exit to instruction outside of the region
+    FIXUP_EPILOGUE,     // Exit with result already in RAX
+} jit_fixup_kind;
+
+// rel32 of jump patched when the code is complete
+typedef struct jit_fixup{
+    size_t position;
+    size_t target;      // Instruction index
+    jit_fixup_kind kind;
+} jit_fixup;
+
+typedef struct jit_compiler{
+    uint8_t* code;
+    size_t length, capacity;
+    bool failed;            // Memory allocation error
+    const vm_code* program;
+    size_t start, end;      // Region of instructions
+    bool* reachable;        // Instructions of the region reachable in native code, indexed from start
+    bool* entry;            // Start and return addresses of calls in the region
+    bool* local_checked;    // Size of LF is checked on all paths to instruction
+    size_t* offsets;        // Native code of instructions
+    size_t local_size;      // Count of LF slots used by the region
+    jit_fixup* fixups;
+    size_t fixup_count, fixup_capacity;
+} jit_compiler;
+
+// Machine code
+
+static void emit(jit_compiler* c, uint8_t byte){
+    if(c->failed){
+        return;
+    }
+    if(c->length == c->capacity){
+        size_t capacity = c->capacity ? c->capacity * 2 : 4096;
+        uint8_t* code = realloc(c->code, capacity);
+        if(code == NULL){
+            c->failed = true;
+            return;
+        }
+        c->code = code;
+        c->capacity = capacity;
+    }
+    c->code[c->length++] = byte;
+}
+
+static void emit32(jit_compiler* c, uint32_t value){
+    for(int i = 0; i < 4; i++){
+        emit(c, value >> (8 * i));
+    }
+}
+
+static void emit64(jit_compiler* c, uint64_t value){
+    emit32(c, value);
+    emit32(c, value >> 32);
+}
+
+static void patch32(jit_compiler* c, size_t position, uint32_t value){
+    if(!c->failed && position + 4 <= c->length){
+        for(int i = 0; i < 4; i++){
+            c->code[position + i] = value >> (8 * i);
+        }
+    }
+}
+
+/**
+ * Emits mandatory prefix of SSE instruction and REX prefix when it is needed
+ * \param c
+ * \param prefix 0 | 0x66 | 0xF2
+ * \param wide 64 bit operand size
+ * \param reg register in ModRM reg field
+ * \param index NO_INDEX | index register
+ * \param base register in ModRM rm field
+ */
+static void emit_prefix(jit_compiler* c, int prefix, bool wide, int reg, int index, int base){
+    if(prefix){
+        emit(c, prefix);
+    }
+    uint8_t rex = 0x40 | (wide ? 8 : 0) | (reg & 8 ? 4 : 0) | (index != NO_INDEX && index & 8 ? 2 : 0) | (base & 8 ? 1 : 0);
+    if(rex != 0x40){
+        emit(c, rex);
+    }
+}
+
+static void emit_opcode(jit_compiler* c, uint32_t opcode){
+    if(opcode > 0xFF){
+        emit(c, opcode >> 8);
+    }
+    emit(c, opcode);
+}
+
+/**
+ * Instruction with register (or opcode extension) and memory operand
+ */
+static void emit_memory(jit_compiler* c, int prefix, bool wide, uint32_t opcode, int reg, jit_memory memory){
+    emit_prefix(c, prefix, wide, reg, memory.index, memory.base);
+    emit_opcode(c, opcode);
+    if(memory.index == NO_INDEX && (memory.base & 7) != RSP){
+        emit(c, 0x80 | (reg & 7) << 3 | (memory.base & 7));
+    }
+    else{
+        emit(c, 0x80 | (reg & 7) << 3 | RSP);
+        emit(c, ((memory.index == NO_INDEX ? RSP : memory.index) & 7) << 3 | (memory.base & 7));
+    }
+    emit32(c, memory.displacement);
+}
+
+/**
+ * Instruction with two register operands (or opcode extension and register)
+ */
+static void emit_registers(jit_compiler* c, int prefix, bool wide, uint32_t opcode, int reg, int rm){
+    emit_prefix(c, prefix, wide, reg, NO_INDEX, rm);
+    emit_opcode(c, opcode);
+    emit(c, 0xC0 | (reg & 7) << 3 | (rm & 7));
+}
+
+static void emit_load_immediate(jit_compiler* c, int reg, uint64_t value){
+    // 32 bit move clears the upper half
+    emit_prefix(c, 0, value > UINT32_MAX, 0, NO_INDEX, reg);
+    emit(c, 0xB8 + (reg & 7));
+    if(value > UINT32_MAX){
+        emit64(c, value);
+    }
+    else{
+        emit32(c, value);
+    }
+}
+
+static void emit_push(jit_compiler* c, int reg){
+    emit_prefix(c, 0, false, 0, NO_INDEX, reg);
+    emit(c, 0x50 + (reg & 7));
+}
+
+static void emit_pop(jit_compiler* c, int reg){
+    emit_prefix(c, 0, false, 0, NO_INDEX, reg);
+    emit(c, 0x58 + (reg & 7));
+}
+
+/**
+ * Emits jmp or jcc with rel32 patched later
+ * \return position of rel32
+ */
+static size_t emit_jump_placeholder(jit_compiler* c, int condition){
+    if(condition == CC_ALWAYS){
+        emit(c, 0xE9);
+    }
+    else{
+        emit(c, 0x0F);
+        emit(c, 0x80 | condition);
+    }
+    size_t position = c->length;
+    emit32(c, 0);
+    return position;
+}
+
+static void emit_jump(jit_compiler* c, int condition, jit_fixup_kind kind, size_t target){
+    size_t position = emit_jump_placeholder(c, condition);
+    if(c->fixup_count == c->fixup_capacity){
+        size_t capacity = c->fixup_capacity ? c->fixup_capacity * 2 : 64;
+        jit_fixup* fixups = realloc(c->fixups, sizeof(jit_fixup) * capacity);
+        if(fixups == NULL){
+            c->failed = true;
+            return;
+        }
+        c->fixups = fixups;
+        c->fixup_capacity = capacity;
+    }
+    c->fixups[c->fixup_count++] = (jit_fixup){.position = position, .target = target, .kind = kind};
+}
+
+// Forward jump inside of template
+static size_t emit_forward(jit_compiler* c, int condition){
+    return emit_jump_placeholder(c, condition);
+}
+
+static void patch_here(jit_compiler* c, size_t position){
+    patch32(c, position, c->length - (position + 4));
+}
+
+static bool in_region(const jit_compiler* c, size_t target){
+    return target >= c->start && target < c->end && c->reachable[target - c->start];
+}
+
+// Jump to instruction, instructions outside of the region continue in the interpreter or in other region
+static void emit_branch(jit_compiler* c, int condition, size_t target){
+    emit_jump(c, condition, in_region(c, target) ? FIXUP_INSTRUCTION : FIXUP_TRANSFER, target);
+}
+
+// Exit to the interpreter, which executes the instruction again
+static void emit_guard(jit_compiler* c, int condition, size_t ip){
+    emit_jump(c, condition, FIXUP_GUARD, ip);
+}
+
+// Operands
+
+static jit_memory context_memory(size_t offset){
+    return (jit_memory){.base = REG_CONTEXT, .index = NO_INDEX, .displacement = (int32_t)offset};
+}
+
+static jit_memory slot_memory(const vm_operand* operand){
+    int base = operand->kind == VM_OPERAND_GF ? REG_GLOBAL : operand->kind == VM_OPERAND_LF ? REG_LOCAL : REG_TEMPORARY;
+    return (jit_memory){.base = base, .index = NO_INDEX, .displacement = (int32_t)(operand->index * sizeof(vm_value))};
+}
+
+// Slot of the data stack relative to its top
+static jit_memory stack_memory(int32_t displacement){
+    return (jit_memory){.base = REG_STACK, .index = REG_STACK_USED, .displacement = displacement};
+}
+
+static jit_memory payload_memory(jit_memory memory){
+    memory.displacement += offsetof(vm_value, as);
+    return memory;
+}
+
+static uint64_t constant_payload(vm_value value){
+    double number;
+    uint64_t bits = 0;
+    switch(vm_type_of(value)){
+        case VM_INT:
+            return (uint64_t)vm_as_int(value);
+        case VM_FLOAT:
+            number = vm_as_float(value);
+            memcpy(&bits, &number, sizeof(bits));
+            return bits;
+        case VM_BOOL:
+            return vm_as_bool(value);
+        default:
+            return 0;
+    }
+}
+
+/**
+ * Checks that frame of variable exists and contains the slot, LF is checked once until it changes
+ * \param c
+ * \param operand
+ * \param ip
+ * \param local_checked LF is already checked
+ */
+static void emit_frame_check(jit_compiler* c, const vm_operand* operand, size_t ip, bool* local_checked){
+    if(operand->kind == VM_OPERAND_TF){
+        emit_memory(c, 0, true, 0x81, 7, context_memory(offsetof(jit_context, temporary_size))); // cmp
+        emit32(c, operand->index + 1);
+        emit_guard(c, CC_B, ip);
+    }
+    else if(operand->kind == VM_OPERAND_LF && !*local_checked){
+        emit_memory(c, 0, true, 0x81, 7, context_memory(offsetof(jit_context, local_size)));
+        emit32(c, c->local_size);
+        emit_guard(c, CC_B, ip);
+        *local_checked = true;
+    }
+}
+
+static jit_source operand_source(jit_compiler* c, const vm_operand* operand, size_t ip, bool* local_checked){
+    jit_source source = {.constant = operand->kind == VM_OPERAND_CONST};
+    if(source.constant){
+        source.value = operand->constant;
+    }
+    else{
+        emit_frame_check(c, operand, ip, local_checked);
+        source.memory = slot_memory(operand);
+    }
+    return source;
+}
+
+static jit_source stack_source(int32_t displacement){
+    return (jit_source){.constant = false, .memory = stack_memory(displacement)};
+}
+
+static void emit_load_payload(jit_compiler* c, int reg, const jit_source* source){
+    if(source->constant){
+        emit_load_immediate(c, reg, constant_payload(source->value));
+    }
+    else{
+        emit_memory(c, 0, true, 0x8B, reg, payload_memory(source->memory)); // mov reg, [payload]
+    }
+}
+
+static void emit_store(jit_compiler* c, jit_memory destination, int reg, vm_type type){
+    emit_memory(c, 0, true, 0x89, reg, payload_memory(destination));
+    emit_memory(c, 0, false, 0xC6, 0, destination); // mov byte [tag], type
+    emit(c, type);
+}
+
+static void emit_type_guard(jit_compiler* c, jit_memory memory, vm_type type, size_t ip){
+    emit_memory(c, 0, false, 0x80, 7, memory); // cmp byte [tag], type
+    emit(c, type);
+    emit_guard(c, CC_NE, ip);
+}
+
+// Type of variable has to be in range first..last of vm_type
+static void emit_type_range_guard(jit_compiler* c, jit_memory memory, vm_type first, vm_type last, size_t ip){
+    emit_memory(c, 0, false, 0x0FB6, RAX, memory); // movzx eax, byte [tag]
+    emit_registers(c, 0, false, 0x83, 5, RAX);     // sub eax, first
+    emit(c, first);
+    emit_registers(c, 0, false, 0x83, 7, RAX);     // cmp eax, last - first
+    emit(c, last - first);
+    emit_guard(c, CC_A, ip);
+}
+
+// Variable can be overwritten without releasing a string
+static void emit_writable_guard(jit_compiler* c, jit_memory memory, size_t ip){
+    emit_type_range_guard(c, memory, VM_UNDEFINED, VM_BOOL, ip);
+}
+
+/**
+ * Copies value, variables are copied only when they do not need reference counting
+ */
+static void emit_move(jit_compiler* c, const jit_source* source, jit_memory destination, size_t ip){
+    if(source->constant){
+        emit_load_payload(c, RAX, source);
+        emit_store(c, destination, RAX, vm_type_of(source->value));
+        return;
+    }
+    emit_type_range_guard(c, source->memory, VM_NIL, VM_BOOL, ip);
+    emit_memory(c, 0, false, 0x0F10, XMM0, source->memory);  // movups xmm0, [source]
+    emit_memory(c, 0, false, 0x0F11, XMM0, destination);     // movups [destination], xmm0
+}
+
+static void emit_stack_guard(jit_compiler* c, size_t count, size_t ip){
+    emit_registers(c, 0, true, 0x81, 7, REG_STACK_USED); // cmp rbp, count * size
+    emit32(c, count * sizeof(vm_value));
+    emit_guard(c, CC_B, ip);
+}
+
+static void emit_stack_adjust(jit_compiler* c, int count){
+    emit_registers(c, 0, true, 0x81, count > 0 ? 0 : 5, REG_STACK_USED); // add | sub rbp, size
+    emit32(c, (count > 0 ? count : -count) * sizeof(vm_value));
+}
+
+// Sets eax to 0 | 1 by condition
+static void emit_set(jit_compiler* c, int condition){
+    emit_registers(c, 0, false, 0x0F90 | condition, 0, RAX);   // setcc al
+    emit_registers(c, 0, false, 0x0FB6, RAX, RAX);             // movzx eax, al
+}
+
+// Operations
+
+/**
+ * Operation of two operands of known type, result is stored to destination or left in RAX
+ */
+static void emit_operation(jit_compiler* c, jit_operation operation, vm_type type,
+                           const jit_source* a, const jit_source* b, const jit_memory* destination, size_t ip){
+    emit_load_payload(c, RAX, a);
+    emit_load_payload(c, RCX, b);
+    size_t divide, done;
+    if(type == VM_INT){
+        switch(operation){
+            case OP_ADD:
+                emit_registers(c, 0, true, 0x01, RCX, RAX); // add rax, rcx
+                break;
+            case OP_SUB:
+                emit_registers(c, 0, true, 0x29, RCX, RAX); // sub rax, rcx
+                break;
+            case OP_MUL:
+                emit_registers(c, 0, true, 0x0FAF, RAX, RCX); // imul rax, rcx
+                break;
+            case OP_IDIV:
+                emit_registers(c, 0, true, 0x85, RCX, RCX); // test rcx, rcx
+                emit_guard(c, CC_E, ip);
+                // Division by -1 is negation, idiv traps on overflow
+                emit_registers(c, 0, true, 0x83, 7, RCX);   // cmp rcx, -1
+                emit(c, 0xFF);
+                divide = emit_forward(c, CC_NE);
+                emit_registers(c, 0, true, 0xF7, 3, RAX);   // neg rax
+                done = emit_forward(c, CC_ALWAYS);
+                patch_here(c, divide);
+                emit(c, 0x48);                              // cqo
+                emit(c, 0x99);
+                emit_registers(c, 0, true, 0xF7, 7, RCX);   // idiv rcx
+                patch_here(c, done);
+                break;
+            default:
+                emit_registers(c, 0, true, 0x39, RCX, RAX); // cmp rax, rcx
+                emit_set(c, operation == OP_LT ? CC_L : operation == OP_GT ? CC_G : CC_E);
+                break;
+        }
+    }
+    else if(type == VM_FLOAT){
+        if(operation == OP_DIV){
+            // Both zeros have all bits except sign cleared
+            emit_registers(c, 0, true, 0x89, RCX, RDX); // mov rdx, rcx
+            emit_registers(c, 0, true, 0x01, RDX, RDX); // add rdx, rdx
+            emit_guard(c, CC_E, ip);
+        }
+        emit_registers(c, 0x66, true, 0x0F6E, XMM0, RAX); // movq xmm0, rax
+        emit_registers(c, 0x66, true, 0x0F6E, XMM1, RCX); // movq xmm1, rcx
+        switch(operation){
+            case OP_LT:
+                emit_registers(c, 0x66, false, 0x0F2E, XMM1, XMM0); // ucomisd xmm1, xmm0, unordered is false
+                emit_set(c, CC_A);
+                break;
+            case OP_GT:
+                emit_registers(c, 0x66, false, 0x0F2E, XMM0, XMM1);
+                emit_set(c, CC_A);
+                break;
+            case OP_EQ:
+                emit_registers(c, 0x66, false, 0x0F2E, XMM0, XMM1);
+                emit_registers(c, 0, false, 0x0F90 | CC_E, 0, RAX);  // sete al
+                emit_registers(c, 0, false, 0x0F90 | CC_NP, 0, RCX); // setnp cl
+                emit_registers(c, 0, false, 0x20, RCX, RAX);         // and al, cl
+                emit_registers(c, 0, false, 0x0FB6, RAX, RAX);       // movzx eax, al
+                break;
+            default:
+                // addsd, subsd, mulsd, divsd xmm0, xmm1
+                emit_registers(c, 0xF2, false, operation == OP_ADD ? 0x0F58 : operation == OP_SUB ? 0x0F5C :
+                               operation == OP_MUL ? 0x0F59 : 0x0F5E, XMM0, XMM1);
+                emit_registers(c, 0x66, true, 0x0F7E, XMM0, RAX); // movq rax, xmm0
+                break;
+        }
+    }
+    else{
+        emit_registers(c, 0, false, 0x38, RCX, RAX); // cmp al, cl
+        emit_set(c, CC_E);
+    }
+    if(destination != NULL){
+        emit_store(c, *destination, RAX, operation >= OP_LT ? VM_BOOL : type);
+    }
+}
+
+/**
+ * Binary operation with operand types checked at runtime. Code is generated for every type the operation accepts,
+ * other types exit to the interpreter.
+ */
+static void emit_binary(jit_compiler* c, jit_operation operation, const jit_source* a, const jit_source* b,
+                        const jit_memory* destination, size_t ip){
+    vm_type types[3];
+    int count = 0;
+    vm_type accepted[] = {VM_INT, VM_FLOAT, VM_BOOL};
+    for(int i = 0; i < 3; i++){
+        vm_type type = accepted[i];
+        if((type == VM_INT && operation == OP_DIV) || (type == VM_FLOAT && operation == OP_IDIV) ||
+           (type == VM_BOOL && operation != OP_EQ)){
+            continue;
+        }
+        // Constant operand decides the type
+        if((a->constant && !vm_is(a->value, type)) || (b->constant && !vm_is(b->value, type))){
+            continue;
+        }
+        types[count++] = type;
+    }
+    if(count == 0){
+        emit_guard(c, CC_ALWAYS, ip);
+        return;
+    }
+    size_t done[3];
+    for(int i = 0; i < count; i++){
+        bool last = i == count - 1;
+        size_t next = 0;
+        if(!a->constant){
+            emit_memory(c, 0, false, 0x80, 7, a->memory); // cmp byte [tag], type
+            emit(c, types[i]);
+            if(last){
+                emit_guard(c, CC_NE, ip);
+            }
+            else{
+                next = emit_forward(c, CC_NE);
+            }
+        }
+        if(!b->constant){
+            emit_type_guard(c, b->memory, types[i], ip);
+        }
+        emit_operation(c, operation, types[i], a, b, destination, ip);
+        if(!last){
+            // Constant operand leaves only one candidate, so the first operand is a variable here
+            done[i] = emit_forward(c, CC_ALWAYS);
+            patch_here(c, next);
+        }
+    }
+    for(int i = 0; i < count - 1; i++){
+        patch_here(c, done[i]);
+    }
+}
+
+/**
+ * Operation of binary instruction
+ * \param op
+ * \param operation
+ * \param proven VM_INT | VM_FLOAT for instructions specialized by the loader | VM_UNDECLARED
+ * \param stack stack variant
+ * \return instruction is binary arithmetic or relation
+ */
+static bool binary_operation(int op, jit_operation* operation, vm_type* proven, bool* stack){
+    static const struct{
+        int op;
+        jit_operation operation;
+        vm_type proven;
+        bool stack;
+    } table[] = {
+        {IR_ADD, OP_ADD, VM_UNDECLARED, false}, {IR_SUB, OP_SUB, VM_UNDECLARED, false},
+        {IR_MUL, OP_MUL, VM_UNDECLARED, false}, {IR_DIV, OP_DIV, VM_UNDECLARED, false},
+        {IR_IDIV, OP_IDIV, VM_UNDECLARED, false}, {IR_LT, OP_LT, VM_UNDECLARED, false},
+        {IR_GT, OP_GT, VM_UNDECLARED, false}, {IR_EQ, OP_EQ, VM_UNDECLARED, false},
+        {IR_ADDS, OP_ADD, VM_UNDECLARED, true}, {IR_SUBS, OP_SUB, VM_UNDECLARED, true},
+        {IR_MULS, OP_MUL, VM_UNDECLARED, true}, {IR_DIVS, OP_DIV, VM_UNDECLARED, true},
+        {IR_IDIVS, OP_IDIV, VM_UNDECLARED, true}, {IR_LTS, OP_LT, VM_UNDECLARED, true},
+        {IR_GTS, OP_GT, VM_UNDECLARED, true}, {IR_EQS, OP_EQ, VM_UNDECLARED, true},
+        {VM_ADDS_I32, OP_ADD, VM_INT, true}, {VM_SUBS_I32, OP_SUB, VM_INT, true},
+        {VM_MULS_I32, OP_MUL, VM_INT, true}, {VM_IDIVS_I32, OP_IDIV, VM_INT, true},
+        {VM_LTS_I32, OP_LT, VM_INT, true}, {VM_GTS_I32, OP_GT, VM_INT, true}, {VM_EQS_I32, OP_EQ, VM_INT, true},
+        {VM_ADDS_F64, OP_ADD, VM_FLOAT, true}, {VM_SUBS_F64, OP_SUB, VM_FLOAT, true},
+        {VM_MULS_F64, OP_MUL, VM_FLOAT, true}, {VM_DIVS_F64, OP_DIV, VM_FLOAT, true},
+        {VM_LTS_F64, OP_LT, VM_FLOAT, true}, {VM_GTS_F64, OP_GT, VM_FLOAT, true}, {VM_EQS_F64, OP_EQ, VM_FLOAT, true},
+    };
+    for(size_t i = 0; i < sizeof(table) / sizeof(table[0]); i++){
+        if(table[i].op == op){
+            *operation = table[i].operation;
+            *proven = table[i].proven;
+            *stack = table[i].stack;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Instructions
+
+// Instructions executed by the helper of the interpreter
+static bool is_helper_instruction(int op){
+    return op == IR_CREATEFRAME || op == IR_PUSHFRAME || op == IR_POPFRAME || op == IR_CALL || op == IR_RETURN ||
+           op == IR_CLEARS || op == IR_READ || op == IR_WRITE;
+}
+
+static bool is_string_constant(const vm_operand* operand){
+    return operand->kind == VM_OPERAND_CONST && vm_is(operand->constant, VM_STRING);
+}
+
+/**
+ * Instruction has a template or it is executed by the helper
+ */
+static bool is_supported(const vm_instruction* instruction){
+    jit_operation operation;
+    vm_type proven;
+    bool stack;
+    for(int i = 0; i < IR_MAX_OPERANDS; i++){
+        vm_operand_kind kind = instruction->args[i].kind;
+        // Slot displacement has to fit to 32 bits
+        if((kind == VM_OPERAND_GF || kind == VM_OPERAND_LF || kind == VM_OPERAND_TF) && instruction->args[i].index > (1u << 24)){
+            return false;
+        }
+    }
+    switch(instruction->op){
+        case IR_MOVE:
+            return !is_string_constant(&instruction->args[1]);
+        case IR_PUSHS:
+        case VM_FUSED_BINARY:
+        case VM_FUSED_BRANCH:
+            return !is_string_constant(&instruction->args[0]);
+        case IR_POPS:
+        case IR_DEFVAR:
+        case IR_NOTS:
+        case IR_ORS:
+        case IR_INT2FLOAT:
+        case IR_FLOAT2INT:
+        case IR_JUMP:
+        case IR_JUMPIFEQ:
+        case IR_JUMPIFNEQ:
+            return true;
+        default:
+            return is_helper_instruction(instruction->op) || binary_operation(instruction->op, &operation, &proven, &stack);
+    }
+}
+
+/**
+ * Instructions following instruction in native code, return addresses of calls are entries instead
+ * \param c
+ * \param i
+ * \param out
+ * \return count of successors
+ */
+static int successors(const jit_compiler* c, size_t i, size_t out[2]){
+    const vm_instruction* instruction = &c->program->code[i];
+    if(!is_supported(instruction)){
+        return 0;
+    }
+    switch(instruction->op){
+        case IR_JUMP:
+            out[0] = instruction->args[0].index;
+            return 1;
+        case IR_JUMPIFEQ:
+        case IR_JUMPIFNEQ:
+            out[0] = i + 1;
+            out[1] = instruction->args[0].index;
+            return 2;
+        case IR_CALL:
+            // Recursion stays in native code
+            out[0] = instruction->args[0].index;
+            return instruction->args[0].index == c->start ? 1 : 0;
+        case IR_RETURN:
+            return 0;
+        default:
+            out[0] = i + 1;
+            return 1;
+    }
+}
+
+static bool uses_local_frame(const vm_instruction* instruction){
+    for(int i = 0; i < IR_MAX_OPERANDS; i++){
+        if(instruction->args[i].kind == VM_OPERAND_LF){
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Finds instructions reachable from start, entries and the size of LF used by the region
+ * \param c
+ */
+static void find_region(jit_compiler* c){
+    const vm_code* program = c->program;
+    size_t limit = c->start + JIT_REGION_LIMIT < program->count ? c->start + JIT_REGION_LIMIT : program->count;
+    size_t furthest = c->start;
+    size_t i;
+    c->reachable[0] = true;
+    c->entry[0] = true;
+    for(i = c->start; i < limit && i <= furthest; i++){
+        if(!c->reachable[i - c->start]){
+            continue;
+        }
+        const vm_instruction* instruction = &program->code[i];
+        size_t next[2];
+        int count = successors(c, i, next);
+        if(instruction->op == IR_CALL && i + 1 < limit){
+            next[count++] = i + 1;
+            c->entry[i + 1 - c->start] = true;
+        }
+        for(int j = 0; j < count; j++){
+            if(next[j] > i && next[j] < limit){
+                c->reachable[next[j] - c->start] = true;
+                furthest = next[j] > furthest ? next[j] : furthest;
+            }
+        }
+        if(is_supported(instruction) && !is_helper_instruction(instruction->op)){
+            for(int j = 0; j < IR_MAX_OPERANDS; j++){
+                if(instruction->args[j].kind == VM_OPERAND_LF && instruction->args[j].index + 1 > c->local_size){
+                    c->local_size = instruction->args[j].index + 1;
+                }
+            }
+        }
+    }
+    c->end = i;
+}
+
+/**
+ * Finds instructions where LF was checked on all paths since it last changed, the check is then omitted
+ * \param c
+ */
+static void find_local_checks(jit_compiler* c){
+    size_t count = c->end - c->start;
+    for(size_t i = 0; i < count; i++){
+        c->local_checked[i] = c->reachable[i] && !c->entry[i];
+    }
+    bool changed = true;
+    while(changed){
+        changed = false;
+        for(size_t i = 0; i < count; i++){
+            if(!c->reachable[i]){
+                continue;
+            }
+            const vm_instruction* instruction = &c->program->code[c->start + i];
+            bool checked = c->local_checked[i];
+            if(instruction->op == IR_PUSHFRAME || instruction->op == IR_POPFRAME){
+                checked = false;
+            }
+            else if(!is_helper_instruction(instruction->op) && uses_local_frame(instruction)){
+                checked = true;
+            }
+            size_t next[2];
+            int next_count = successors(c, c->start + i, next);
+            for(int j = 0; j < next_count; j++){
+                if(in_region(c, next[j]) && c->local_checked[next[j] - c->start] && !checked){
+                    c->local_checked[next[j] - c->start] = false;
+                    changed = true;
+                }
+            }
+        }
+    }
+}
+
+static void emit_reload(jit_compiler* c){
+    emit_memory(c, 0, true, 0x8B, REG_LOCAL, context_memory(offsetof(jit_context, local)));
+    emit_memory(c, 0, true, 0x8B, REG_TEMPORARY, context_memory(offsetof(jit_context, temporary)));
+    emit_memory(c, 0, true, 0x8B, REG_STACK, context_memory(offsetof(jit_context, stack)));
+    emit_memory(c, 0, true, 0x8B, REG_STACK_USED, context_memory(offsetof(jit_context, stack_used)));
+}
+
+// Calls helper executing the instruction, RAX is the next instruction
+static void emit_helper(jit_compiler* c, size_t ip){
+    emit_memory(c, 0, true, 0x89, REG_STACK_USED, context_memory(offsetof(jit_context, stack_used)));
+    emit_registers(c, 0, true, 0x89, REG_CONTEXT, RDI); // mov rdi, rbx
+    emit_load_immediate(c, RSI, ip);
+    emit_memory(c, 0, false, 0xFF, 2, context_memory(offsetof(jit_context, helper))); // call [helper]
+    emit_reload(c);
+    emit_registers(c, 0, true, 0x83, 7, RAX); // cmp rax, JIT_ERROR
+    emit(c, 0xFF);
+    emit_jump(c, CC_E, FIXUP_EPILOGUE, 0);
+}
+
+/**
+ * Emits template of instruction
+ * \param c
+ * \param ip
+ * \param local_checked LF was checked before the instruction
+ */
+static void emit_instruction(jit_compiler* c, size_t ip, bool local_checked){
+    const vm_instruction* instruction = &c->program->code[ip];
+    const vm_operand* args = instruction->args;
+    jit_operation operation;
+    vm_type proven;
+    bool stack;
+    jit_source a, b;
+    jit_memory destination;
+    if(!is_supported(instruction)){
+        emit_guard(c, CC_ALWAYS, ip);
+        return;
+    }
+    switch(instruction->op){
+        case IR_MOVE:
+            emit_frame_check(c, &args[0], ip, &local_checked);
+            a = operand_source(c, &args[1], ip, &local_checked);
+            destination = slot_memory(&args[0]);
+            emit_writable_guard(c, destination, ip);
+            emit_move(c, &a, destination, ip);
+            return;
+        case IR_PUSHS:
+        case VM_FUSED_BINARY:
+        case VM_FUSED_BRANCH:
+            // Superinstructions are executed as their first instruction
+            a = operand_source(c, &args[0], ip, &local_checked);
+            emit_memory(c, 0, true, 0x3B, REG_STACK_USED, context_memory(offsetof(jit_context, stack_size))); // cmp rbp, size
+            emit_guard(c, CC_AE, ip);
+            emit_move(c, &a, stack_memory(0), ip);
+            emit_stack_adjust(c, 1);
+            return;
+        case IR_POPS:
+            emit_frame_check(c, &args[0], ip, &local_checked);
+            destination = slot_memory(&args[0]);
+            emit_stack_guard(c, 1, ip);
+            emit_writable_guard(c, destination, ip);
+            // String moves from the stack to the variable without reference counting
+            emit_memory(c, 0, false, 0x0F10, XMM0, stack_memory(-(int32_t)sizeof(vm_value)));
+            emit_memory(c, 0, false, 0x0F11, XMM0, destination);
+            emit_stack_adjust(c, -1);
+            return;
+        case IR_DEFVAR:
+            emit_frame_check(c, &args[0], ip, &local_checked);
+            destination = slot_memory(&args[0]);
+            emit_type_guard(c, destination, VM_UNDECLARED, ip);
+            emit_memory(c, 0, false, 0xC6, 0, destination);
+            emit(c, VM_UNDEFINED);
+            return;
+        case IR_NOTS:
+            emit_stack_guard(c, 1, ip);
+            destination = stack_memory(-(int32_t)sizeof(vm_value));
+            emit_type_guard(c, destination, VM_BOOL, ip);
+            emit_memory(c, 0, false, 0x80, 6, payload_memory(destination)); // xor byte [payload], 1
+            emit(c, 1);
+            return;
+        case IR_ORS:
+            emit_stack_guard(c, 2, ip);
+            destination = stack_memory(-2 * (int32_t)sizeof(vm_value));
+            emit_type_guard(c, destination, VM_BOOL, ip);
+            emit_type_guard(c, stack_memory(-(int32_t)sizeof(vm_value)), VM_BOOL, ip);
+            emit_memory(c, 0, false, 0x0FB6, RAX, payload_memory(destination));                             // movzx eax, byte
+            emit_memory(c, 0, false, 0x0A, RAX, payload_memory(stack_memory(-(int32_t)sizeof(vm_value)))); // or al, byte
+            emit_memory(c, 0, true, 0x89, RAX, payload_memory(destination));
+            emit_stack_adjust(c, -1);
+            return;
+        case IR_INT2FLOAT:
+        case IR_FLOAT2INT:
+            emit_frame_check(c, &args[0], ip, &local_checked);
+            a = operand_source(c, &args[1], ip, &local_checked);
+            destination = slot_memory(&args[0]);
+            emit_writable_guard(c, destination, ip);
+            vm_type from = instruction->op == IR_INT2FLOAT ? VM_INT : VM_FLOAT;
+            if(a.constant && !vm_is(a.value, from)){
+                emit_guard(c, CC_ALWAYS, ip);
+                return;
+            }
+            if(!a.constant){
+                emit_type_guard(c, a.memory, from, ip);
+            }
+            emit_load_payload(c, RAX, &a);
+            if(instruction->op == IR_INT2FLOAT){
+                emit_registers(c, 0xF2, true, 0x0F2A, XMM0, RAX); // cvtsi2sd xmm0, rax
+                emit_registers(c, 0x66, true, 0x0F7E, XMM0, RAX); // movq rax, xmm0
+                emit_store(c, destination, RAX, VM_FLOAT);
+            }
+            else{
+                emit_registers(c, 0x66, true, 0x0F6E, XMM0, RAX); // movq xmm0, rax
+                emit_registers(c, 0xF2, true, 0x0F2C, RAX, XMM0); // cvttsd2si rax, xmm0
+                emit_store(c, destination, RAX, VM_INT);
+            }
+            return;
+        case IR_JUMP:
+            emit_branch(c, CC_ALWAYS, args[0].index);
+            return;
+        case IR_JUMPIFEQ:
+        case IR_JUMPIFNEQ:
+            a = operand_source(c, &args[1], ip, &local_checked);
+            b = operand_source(c, &args[2], ip, &local_checked);
+            bool jump_if_equal = instruction->op == IR_JUMPIFEQ;
+            if((a.constant && vm_is(a.value, VM_NIL)) || (b.constant && vm_is(b.value, VM_NIL))){
+                // Comparison with nil is equality of types, values without type are errors
+                const jit_source* other = a.constant && vm_is(a.value, VM_NIL) ? &b : &a;
+                if(other->constant){
+                    if(vm_is(other->value, VM_NIL) == jump_if_equal){
+                        emit_branch(c, CC_ALWAYS, args[0].index);
+                    }
+                    return;
+                }
+                emit_memory(c, 0, false, 0x0FB6, RAX, other->memory); // movzx eax, byte [tag]
+                emit_registers(c, 0, false, 0x83, 7, RAX);            // cmp eax, VM_UNDEFINED
+                emit(c, VM_UNDEFINED);
+                emit_guard(c, CC_BE, ip);
+                emit_registers(c, 0, false, 0x83, 7, RAX);            // cmp eax, VM_NIL
+                emit(c, VM_NIL);
+                emit_branch(c, jump_if_equal ? CC_E : CC_NE, args[0].index);
+                return;
+            }
+            emit_binary(c, OP_EQ, &a, &b, NULL, ip);
+            emit_registers(c, 0, false, 0x85, RAX, RAX); // test eax, eax
+            emit_branch(c, jump_if_equal ? CC_NE : CC_E, args[0].index);
+            return;
+        case IR_CLEARS:
+            // Values on the stack may be strings
+            emit_registers(c, 0, true, 0x85, REG_STACK_USED, REG_STACK_USED); // test rbp, rbp
+            size_t empty = emit_forward(c, CC_E);
+            emit_helper(c, ip);
+            patch_here(c, empty);
+            return;
+        case IR_CALL:
+            emit_helper(c, ip);
+            emit_branch(c, CC_ALWAYS, args[0].index);
+            return;
+        case IR_RETURN:
+            emit_helper(c, ip);
+            int returns = 0;
+            for(size_t i = c->start; i < c->end && returns < JIT_RETURN_LIMIT; i++){
+                if(c->entry[i - c->start] && i > c->start){
+                    emit_prefix(c, 0, true, 0, NO_INDEX, RAX); // cmp rax, imm32
+                    emit(c, 0x3D);
+                    emit32(c, i);
+                    emit_branch(c, CC_E, i);
+                    returns++;
+                }
+            }
+            emit_registers(c, 0, true, 0x0FBA, 5, RAX); // bts rax, 62
+            emit(c, 62);
+            emit_jump(c, CC_ALWAYS, FIXUP_EPILOGUE, 0);
+            return;
+        default:
+            break;
+    }
+    if(is_helper_instruction(instruction->op)){
+        emit_helper(c, ip);
+        return;
+    }
+    if(!binary_operation(instruction->op, &operation, &proven, &stack)){
+        emit_guard(c, CC_ALWAYS, ip);
+        return;
+    }
+    if(stack){
+        emit_stack_guard(c, 2, ip);
+        a = stack_source(-2 * (int32_t)sizeof(vm_value));
+        b = stack_source(-(int32_t)sizeof(vm_value));
+        destination = a.memory;
+        if(proven != VM_UNDECLARED){
+            emit_operation(c, operation, proven, &a, &b, &destination, ip);
+        }
+        else{
+            emit_binary(c, operation, &a, &b, &destination, ip);
+        }
+        emit_stack_adjust(c, -1);
+        return;
+    }
+    emit_frame_check(c, &args[0], ip, &local_checked);
+    a = operand_source(c, &args[1], ip, &local_checked);
+    b = operand_source(c, &args[2], ip, &local_checked);
+    destination = slot_memory(&args[0]);
+    emit_writable_guard(c, destination, ip);
+    emit_binary(c, operation, &a, &b, &destination, ip);
+}
+
+static void emit_prologue(jit_compiler* c, size_t entry){
+    emit_push(c, RBX);
+    emit_push(c, RBP);
+    emit_push(c, R12);
+    emit_push(c, R13);
+    emit_push(c, R14);
+    emit_push(c, R15);
+    emit_registers(c, 0, true, 0x83, 5, RSP); // sub rsp, 8 aligns calls of the helper
+    emit(c, 8);
+    emit_registers(c, 0, true, 0x89, RDI, REG_CONTEXT); // mov rbx, rdi
+    emit_memory(c, 0, true, 0x8B, REG_GLOBAL, context_memory(offsetof(jit_context, global)));
+    emit_reload(c);
+    emit_jump(c, CC_ALWAYS, FIXUP_INSTRUCTION, entry);
+}
+
+static void emit_epilogue(jit_compiler* c){
+    emit_memory(c, 0, true, 0x89, REG_STACK_USED, context_memory(offsetof(jit_context, stack_used)));
+    emit_registers(c, 0, true, 0x83, 0, RSP); // add rsp, 8
+    emit(c, 8);
+    emit_pop(c, R15);
+    emit_pop(c, R14);
+    emit_pop(c, R13);
+    emit_pop(c, R12);
+    emit_pop(c, RBP);
+    emit_pop(c, RBX);
+    emit(c, 0xC3); // ret
+}
+
+/**
+ * Emits region with its entries, exits and epilogue
+ * \param c
+ * \param prologues native code of entries, indexed from start
+ */
+static void emit_region(jit_compiler* c, size_t* prologues){
+    for(size_t i = c->start; i < c->end; i++){
+        if(c->reachable[i - c->start]){
+            c->offsets[i - c->start] = c->length;
+            emit_instruction(c, i, c->local_checked[i - c->start]);
+        }
+    }
+    emit_jump(c, CC_ALWAYS, FIXUP_TRANSFER, c->end);
+    for(size_t i = c->start; i < c->end; i++){
+        if(c->entry[i - c->start]){
+            prologues[i - c->start] = c->length;
+            emit_prologue(c, i);
+        }
+    }
+    size_t epilogue = c->length;
+    emit_epilogue(c);
+    // Exits are out of line, fixups of exits are appended while they are resolved
+    size_t count = c->fixup_count;
+    for(size_t i = 0; i < count && !c->failed; i++){
+        jit_fixup fixup = c->fixups[i];
+        switch(fixup.kind){
+            case FIXUP_INSTRUCTION:
+                patch32(c, fixup.position, c->offsets[fixup.target - c->start] - (fixup.position + 4));
+                break;
+            case FIXUP_EPILOGUE:
+                patch32(c, fixup.position, epilogue - (fixup.position + 4));
+                break;
+            default:
+                patch_here(c, fixup.position);
+                emit_load_immediate(c, RAX, fixup.kind == FIXUP_TRANSFER ? fixup.target | JIT_TRANSFER : fixup.target);
+                size_t jump = emit_forward(c, CC_ALWAYS);
+                patch32(c, jump, epilogue - (jump + 4));
+                break;
+        }
+    }
+}
+
+// Interface
+
+int jit_init(jit_state* jit, size_t count){
+    jit->entries = calloc(count, sizeof(jit_function));
+    jit->countdown = malloc(sizeof(int) * count);
+    jit->regions = NULL;
+    jit->region_count = jit->region_capacity = 0;
+    if(jit->entries == NULL || jit->countdown == NULL){
+        jit_free(jit);
+        return VM_ERR_INTERNAL;
+    }
+    for(size_t i = 0; i < count; i++){
+        jit->countdown[i] = JIT_THRESHOLD;
+    }
+    return 0;
+}
+
+/**
+ * Copies code to executable memory
+ * \param jit
+ * \param code
+ * \param length
+ * \return executable copy | NULL
+ */
+static uint8_t* jit_install(jit_state* jit, const uint8_t* code, size_t length){
+    if(jit->region_count == jit->region_capacity){
+        size_t capacity = jit->region_capacity ? jit->region_capacity * 2 : 16;
+        jit_region* regions = realloc(jit->regions, sizeof(jit_region) * capacity);
+        if(regions == NULL){
+            return NULL;
+        }
+        jit->regions = regions;
+        jit->region_capacity = capacity;
+    }
+    void* memory = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(memory == MAP_FAILED){
+        return NULL;
+    }
+    memcpy(memory, code, length);
+    // Memory is never writable and executable at once
+    if(mprotect(memory, length, PROT_READ | PROT_EXEC) != 0){
+        munmap(memory, length);
+        return NULL;
+    }
+    jit->regions[jit->region_count++] = (jit_region){.memory = memory, .size = length};
+    return memory;
+}
+
+jit_function jit_compile(jit_state* jit, const vm_code* code, size_t start){
+    if(!is_supported(&code->code[start])){
+        return NULL;
+    }
+    jit_compiler c = {.program = code, .start = start};
+    size_t limit = JIT_REGION_LIMIT + 1;
+    c.reachable = calloc(limit, sizeof(bool));
+    c.entry = calloc(limit, sizeof(bool));
+    c.local_checked = calloc(limit, sizeof(bool));
+    c.offsets = calloc(limit, sizeof(size_t));
+    size_t* prologues = calloc(limit, sizeof(size_t));
+    uint8_t* native = NULL;
+    if(c.reachable != NULL && c.entry != NULL && c.local_checked != NULL && c.offsets != NULL && prologues != NULL){
+        find_region(&c);
+        find_local_checks(&c);
+        emit_region(&c, prologues);
+        if(!c.failed){
+            native = jit_install(jit, c.code, c.length);
+        }
+    }
+    if(native != NULL){
+        for(size_t i = c.start; i < c.end; i++){
+            if(c.entry[i - c.start] && jit->entries[i] == NULL){
+                // Object pointer can not be cast to function pointer in ISO C, POSIX guarantees the representation
+                void* address = native + prologues[i - c.start];
+                memcpy(&jit->entries[i], &address, sizeof(address));
+            }
+        }
+    }
+    free(c.code);
+    free(c.fixups);
+    free(c.reachable);
+    free(c.entry);
+    free(c.local_checked);
+    free(c.offsets);
+    free(prologues);
+    return jit->entries[start];
+}
+
+void jit_free(jit_state* jit){
+    for(size_t i = 0; i < jit->region_count; i++){
+        munmap(jit->regions[i].memory, jit->regions[i].size);
+    }
+    free(jit->regions);
+    free(jit->entries);
+    free(jit->countdown);
+    jit->regions = NULL;
+    jit->entries = NULL;
+    jit->countdown = NULL;
+    jit->region_count = jit->region_capacity = 0;
+}
+
+#else
+
+// Native code is not generated on this platform
+typedef int jit_unavailable;
+
+#endif
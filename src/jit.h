@@ -0,0 +1,119 @@
+/**
+ * Název projektu: Implementace překladače imperativního jazyka IFJ24.
+ *
+ * @file jit.h
+ */
+
+#ifndef JIT_H
+#define JIT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "loader.h"
+
+// Native code is generated for x86-64 System V ABI and 16 byte tagged values
+#if defined(__x86_64__) && defined(__linux__) && defined(__GNUC__) && !defined(VM_NAN_BOXING)
+#define VM_JIT
+#endif
+
+// Count of calls, returns or backward jumps to an instruction before code starting there is compiled
+#ifndef JIT_THRESHOLD
+#define JIT_THRESHOLD 500
+#endif
+
+// Result of native code: runtime error reported by the helper
+#define JIT_ERROR SIZE_MAX
+// Flag of result of native code: execution continues outside of the region, not after a failed guard
+#define JIT_TRANSFER ((size_t)1 << 62)
+
+struct vm_state;
+
+/*
+ * State of the interpreter shared with native code. Native code keeps it in registers,
+ * it is synchronized only around calls of the helper and when native code returns.
+ */
+typedef struct jit_context{
+    vm_value* global;       // GF slots
+    vm_value* local;        // Slots of the current LF | NULL
+    size_t local_size;
+    vm_value* temporary;    // TF slots | NULL
+    size_t temporary_size;
+    vm_value* stack;        // Data stack
+    size_t stack_used;      // Used part of the data stack in bytes
+    size_t stack_size;      // Capacity of the data stack in bytes
+    struct vm_state* vm;
+    /*
+     * Executes instruction at given index in the interpreter (frames, calls, clears and I/O) and refreshes the context,
+     * returns index of the next instruction | JIT_ERROR with error set
+     */
+    size_t (*helper)(struct jit_context* context, size_t ip);
+    int error;
+} jit_context;
+
+/*
+ * Compiled region, returns index of the instruction where the interpreter continues,
+ * with JIT_TRANSFER flag when the instruction may start another region
+ */
+typedef size_t (*jit_function)(jit_context* context);
+
+// Executable memory of one region
+typedef struct jit_region{
+    void* memory;
+    size_t size;
+} jit_region;
+
+typedef struct jit_state{
+    jit_function* entries;  // Native code entered at instruction | NULL
+    int* countdown;         // Executions left before compilation of instruction, 0 when its compilation failed
+    jit_region* regions;
+    size_t region_count, region_capacity;
+} jit_state;
+
+/**
+ * Prepares counters of all instructions of the loaded code
+ * \param jit
+ * \param count count of instructions
+ * \return 0: success, VM_ERR_INTERNAL: memory allocation error
+ */
+int jit_init(jit_state* jit, size_t count);
+
+/**
+ * Compiles region of code starting at the given instruction and reachable from it,
+ * the region ends with instructions leaving the function. Instruction after every call in the region
+ * becomes another entry of the region.
+ * \param jit
+ * \param code
+ * \param start
+ * \return native code entered at start | NULL when the instruction can not be compiled
+ */
+jit_function jit_compile(jit_state* jit, const vm_code* code, size_t start);
+
+/**
+ * Frees compiled code
+ * \param jit
+ */
+void jit_free(jit_state* jit);
+
+/**
+ * Native code of instruction, counts executions of the instruction and compiles it when it becomes hot
+ * \param jit initialized state | state with NULL entries when the compiler is disabled
+ * \param code
+ * \param target instruction reached by call, return or backward jump
+ * \return native code | NULL
+ */
+static inline jit_function jit_lookup(jit_state* jit, const vm_code* code, size_t target){
+    if(jit->entries == NULL){
+        return NULL;
+    }
+    if(jit->entries[target] != NULL){
+        return jit->entries[target];
+    }
+    if(jit->countdown[target] == 0 || --jit->countdown[target] > 0){
+        return NULL;
+    }
+    return jit_compile(jit, code, target);
+}
+
+#endif
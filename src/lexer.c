@@ -11,57 +11,124 @@
 #include <stdbool.h>
 #include <ctype.h>
 #include <string.h>
+#include <pthread.h>
+#include <sched.h>
 
 #include "lexer.h"
+#include "compiler.h"
 #include "compiler_error.h"
+#include "stats.h"
 
 #define NOF_KEY_WORDS 13
 #define BACKSLASH_SIGNS 5
 
-scanner_t scanner = {0};
 
 const char *keywords[] = {"const", "else", "fn", "if", "i32", "f64", "null", "pub", "return", "u8", "var", "void", "while"};
 
 char special_chars[] = {'"', 'n', 'r', 't', '\\'};
 char special_chars_backslash[] = {'\"', '\n', '\r', '\t', '\\'};
 
-void init_scanner(void) { 
-    scanner.p_state = STATE_START;
-    scanner.row = 1;
-    scanner.col = 0;
-    scanner.head_pos = 0;
+void init_scanner(FILE *source) { 
+    ctx->scanner.source = source;
+    ctx->scanner.p_state = STATE_START;
+    ctx->scanner.row = 1;
+    ctx->scanner.col = 0;
+    ctx->scanner.line_length = 0;
+    ctx->scanner.head_pos = 0;
+}
+
+bool keep_lexeme(char *lexeme) {
+    if (ctx->scanner.lexeme_count == ctx->scanner.lexeme_capacity) {
+        size_t capacity = ctx->scanner.lexeme_capacity ? ctx->scanner.lexeme_capacity * 2 : 1024;
+        char **lexemes = realloc(ctx->scanner.lexemes, capacity * sizeof(char *));
+        if (lexemes == NULL) {
+            free(lexeme);
+            ctx->error = ERR_COMPILER_INTERNAL;
+            return false;
+        }
+        ctx->scanner.lexemes = lexemes;
+        ctx->scanner.lexeme_capacity = capacity;
+    }
+    ctx->scanner.lexemes[ctx->scanner.lexeme_count++] = lexeme;
+    return true;
+}
+
+size_t lexeme_mark(void) {
+    return ctx->scanner.lexeme_count;
+}
+
+void release_lexemes(size_t mark) {
+    while (ctx->scanner.lexeme_count > mark) {
+        free(ctx->scanner.lexemes[--ctx->scanner.lexeme_count]);
+    }
+}
+
+void dispose_scanner(void) {
+    stop_scanner_thread();
+    release_lexemes(0);
+    free(ctx->scanner.lexemes);
+    ctx->scanner.lexemes = NULL;
+    ctx->scanner.lexeme_capacity = 0;
 }
 
 bool valid_hex(char a){
     return (a >= '0' && a <= '9') || (a >= 'A' && a <= 'F') || (a >= 'a' && a <= 'f');
 }
 
+/* Reads next character of the source code, moves row and column */
+static int next_char(void) {
+    int c = getc(ctx->scanner.source);
+    if (c == '\n') {
+        ++ctx->scanner.row;
+        ctx->scanner.line_length = ctx->scanner.col;
+        ctx->scanner.col = 0;
+    } else if (c != EOF) {
+        ++ctx->scanner.col;
+    }
+    ++ctx->scanner.head_pos;
+    return c;
+}
+
+/* Puts the character back to the stream, row and column move back, only one character can be put back */
+static void unget_char(int c) {
+    --ctx->scanner.head_pos;
+    if (c == EOF) {
+        return;
+    }
+    ungetc(c, ctx->scanner.source);
+    if (c == '\n') {
+        --ctx->scanner.row;
+        ctx->scanner.col = ctx->scanner.line_length;
+    } else {
+        --ctx->scanner.col;
+    }
+}
+
 /* Main function, performs lexical analysis, in succes returns result token, else exits with lexical error */
-token_t get_token(void) {
+static token_t scan_token(void) {
     token_t token; /* New token is created every function call */
     token.id = TOKEN_DEFAULT; /* Default placeholder */
     d_array_init(&token.lexeme, 16); /* Each token has its own array of chars (string), necessary for keyword/identifier tokens */
 
-    scanner.p_state = STATE_START; 
+    ctx->scanner.p_state = STATE_START; 
+    ctx->scanner.message = NULL;
 
     int c = 0;
 
     while(true) {
 
-        c = getc(stdin);
+        c = next_char();
 
-        if(c == '\n') { /* row&column calculation */
-            ++scanner.row;
-            scanner.col = 0;
+        if (ctx->scanner.p_state == STATE_START) { /* Token starts with the last character read in the start state */
+            token.row = ctx->scanner.row;
+            token.col = ctx->scanner.col;
         }
-        ++scanner.col;
-        ++scanner.head_pos;
 
-        switch(scanner.p_state) {
+        switch(ctx->scanner.p_state) {
             case STATE_START:
                 /* Simple states */
                 if (isspace(c)) {
-                    scanner.p_state = STATE_START;
+                    ctx->scanner.p_state = STATE_START;
                 }  else if (c == EOF) {
                     token.id = TOKEN_EOF;
                     return token;
@@ -114,35 +181,35 @@ token_t get_token(void) {
 
                     /* Complex states */
                 else if (c == '/') { // Division op. or comment
-                    scanner.p_state = STATE_COMMENT_DIV;
+                    ctx->scanner.p_state = STATE_COMMENT_DIV;
                 } else if (c == '=') { // = or ==
-                    scanner.p_state = STATE_EQUAL_ASSIGN;
+                    ctx->scanner.p_state = STATE_EQUAL_ASSIGN;
                 } else if (c == '!') { // Can be only !=
-                    scanner.p_state = STATE_NOT_EQUAL;
+                    ctx->scanner.p_state = STATE_NOT_EQUAL;
                 } else if (c == '<') { // < or <=
-                    scanner.p_state = STATE_LESS_LEQ;
+                    ctx->scanner.p_state = STATE_LESS_LEQ;
                 } else if (c == '>') { // > or >=
-                    scanner.p_state = STATE_GREATER_GREQ;
+                    ctx->scanner.p_state = STATE_GREATER_GREQ;
                 } else if (c == '0') {
                     d_array_append(&token.lexeme, c);
-                    scanner.p_state = STATE_DIGIT_ZERO;
+                    ctx->scanner.p_state = STATE_DIGIT_ZERO;
                 }
 
                     /* Literals */
                 else if (isdigit(c)) {
                     d_array_append(&token.lexeme, c);
-                    scanner.p_state = STATE_DIGIT;
+                    ctx->scanner.p_state = STATE_DIGIT;
                 } else if (c == '"') {
                     token.id = TOKEN_LITERAL_STRING;
-                    scanner.p_state = STATE_STRING_START;
+                    ctx->scanner.p_state = STATE_STRING_START;
                 } else if (c == '\\') {
-                    c = getc(stdin);
+                    c = next_char();
                     if (c == '\\') {
                         token.id = TOKEN_LITERAL_STRING;
-                        scanner.p_state = STATE_MULTILINE_STRING_START;
+                        ctx->scanner.p_state = STATE_MULTILINE_STRING_START;
                     } else {
                         token.id = TOKEN_ERROR;
-                        error = ERR_LEXICAL;
+                        ctx->error = ERR_LEXICAL;
                         return token;
                     }
                 }
@@ -150,17 +217,17 @@ token_t get_token(void) {
                     /* Identifiers or keywords */
                 else if (c == '@') {
                     d_array_append(&token.lexeme, c);
-                    scanner.p_state = STATE_PROLOG;
+                    ctx->scanner.p_state = STATE_PROLOG;
                 } else if (c == '_') {
                     d_array_append(&token.lexeme, c);
-                    scanner.p_state = STATE_UNDERSCORE;
+                    ctx->scanner.p_state = STATE_UNDERSCORE;
                 } else if (is_identifier(c)) {
                     d_array_append(&token.lexeme, c);
                     token.id = TOKEN_IDENTIFIER;
-                    scanner.p_state = STATE_KW_IDENT;
+                    ctx->scanner.p_state = STATE_KW_IDENT;
                 } else {
                     token.id = TOKEN_ERROR;
-                    error = ERR_LEXICAL;
+                    ctx->error = ERR_LEXICAL;
                     return token;
                 }
 
@@ -171,13 +238,13 @@ token_t get_token(void) {
                 // Single line comment
                 if (c == '/') {
                     ignore_comment();
-                    scanner.p_state = STATE_START;
+                    ctx->scanner.p_state = STATE_START;
                 } else { // division operator
                     token.id = TOKEN_DIVISION;
 
                     //scanner.p_state = STATE_START;
 
-                    ungetc(c, stdin);    // Necessary to put loaded char back to stream
+                    unget_char(c);    // Necessary to put loaded char back to stream
 
                     return token;
                 }
@@ -192,7 +259,7 @@ token_t get_token(void) {
                 } else {
                     token.id = TOKEN_ASSIGNMENT;
                     //scanner.p_state = STATE_START;
-                    ungetc(c, stdin);
+                    unget_char(c);
                     return token;
                 }
                 break;
@@ -206,8 +273,8 @@ token_t get_token(void) {
                 } else { // Standalone '!' is not any lexeme
                     token.id = TOKEN_ERROR;
                     //scanner.p_state = STATE_START;
-                    error = ERR_LEXICAL;
-                    ungetc(c, stdin);
+                    ctx->error = ERR_LEXICAL;
+                    unget_char(c);
                     return token;
                 }
 
@@ -221,7 +288,7 @@ token_t get_token(void) {
                 } else {
                     token.id = TOKEN_LESS;
                     //scanner.p_state = STATE_START;
-                    ungetc(c, stdin);
+                    unget_char(c);
                     return token;
                 }
 
@@ -235,7 +302,7 @@ token_t get_token(void) {
                 } else {
                     token.id = TOKEN_GREATER;
                     //scanner.p_state = STATE_START;
-                    ungetc(c, stdin);
+                    unget_char(c);
                     return token;
                 }
                 break;
@@ -245,10 +312,10 @@ token_t get_token(void) {
                 if (isalnum(c) || c == '_') {
                     d_array_append(&token.lexeme, c);
                     token.id = TOKEN_IDENTIFIER;
-                    scanner.p_state = STATE_KW_IDENT;
+                    ctx->scanner.p_state = STATE_KW_IDENT;
                 } else {
                     token.id = TOKEN_DISCARD_RESULT;
-                    ungetc(c, stdin);
+                    unget_char(c);
                     return token;
                 }
                 break;
@@ -259,7 +326,7 @@ token_t get_token(void) {
                     d_array_append(&token.lexeme, c);
                 } else {
                     //scanner.p_state = STATE_START;
-                    ungetc(c, stdin);
+                    unget_char(c);
                     d_array_append(&token.lexeme, '\0');
 
                     for (int i = 0; i < NOF_KEY_WORDS; i++) {
@@ -277,19 +344,19 @@ token_t get_token(void) {
             case STATE_DIGIT_ZERO:
                 if (isdigit(c)) {
                     token.id = TOKEN_ERROR;
-                    error = ERR_LEXICAL;
-                    fprintf(stderr, RED_BOLD("error")": A non-zero literal must not start with a 0\n");
-                    ungetc(c, stdin);
+                    ctx->error = ERR_LEXICAL;
+                    ctx->scanner.message = RED_BOLD("error")": A non-zero literal must not start with a 0\n";
+                    unget_char(c);
                     return token;
                 } else if (c == '.') {
                     d_array_append(&token.lexeme, c);
-                    scanner.p_state = STATE_FLOATING_POINT;
+                    ctx->scanner.p_state = STATE_FLOATING_POINT;
                 } else if (c == 'e') {
                     d_array_append(&token.lexeme, c);
-                    scanner.p_state = STATE_EXPONENT;
+                    ctx->scanner.p_state = STATE_EXPONENT;
                 } else {
                     token.id = TOKEN_LITERAL_I32;
-                    ungetc(c, stdin);
+                    unget_char(c);
                     d_array_append(&token.lexeme, '\0');
                     return token;
                 }
@@ -300,14 +367,14 @@ token_t get_token(void) {
                     d_array_append(&token.lexeme, c);
                 } else if (c == '.') {
                     d_array_append(&token.lexeme, c);
-                    scanner.p_state = STATE_FLOATING_POINT;
+                    ctx->scanner.p_state = STATE_FLOATING_POINT;
                 } else if (c == 'e' || c == 'E') {
                     d_array_append(&token.lexeme, c);
-                    scanner.p_state = STATE_EXPONENT;
+                    ctx->scanner.p_state = STATE_EXPONENT;
                 }
                 else {
                     token.id = TOKEN_LITERAL_I32;
-                    ungetc(c, stdin);
+                    unget_char(c);
                     d_array_append(&token.lexeme, '\0');
                     return token;
                 }
@@ -316,15 +383,15 @@ token_t get_token(void) {
             case STATE_FLOATING_POINT:
                 if (isdigit(c)) {
                     d_array_append(&token.lexeme, c);
-                    scanner.p_state = STATE_DECIMAL_PART;
+                    ctx->scanner.p_state = STATE_DECIMAL_PART;
                 } else if (c == 'e' || c == 'E') {
                     d_array_append(&token.lexeme, c);
-                    scanner.p_state = STATE_EXPONENT;
+                    ctx->scanner.p_state = STATE_EXPONENT;
                 } else {
                     token.id = TOKEN_ERROR;
-                    error = ERR_LEXICAL;
-                    fprintf(stderr, RED_BOLD("error")": invalid decimal base\n");
-                    ungetc(c, stdin);
+                    ctx->error = ERR_LEXICAL;
+                    ctx->scanner.message = RED_BOLD("error")": invalid decimal base\n";
+                    unget_char(c);
                     return token;
                 }
                 break;
@@ -334,10 +401,10 @@ token_t get_token(void) {
                     d_array_append(&token.lexeme, c);
                 } else if (c == 'e' || c == 'E') {
                     d_array_append(&token.lexeme, c);
-                    scanner.p_state = STATE_EXPONENT;
+                    ctx->scanner.p_state = STATE_EXPONENT;
                 } else {
                     token.id = TOKEN_LITERAL_F64;
-                    ungetc(c, stdin);
+                    unget_char(c);
                     d_array_append(&token.lexeme, '\0');
                     return token;
                 }
@@ -346,15 +413,15 @@ token_t get_token(void) {
             case STATE_EXPONENT:
                 if (isdigit(c)) {
                     d_array_append(&token.lexeme, c);
-                    scanner.p_state = STATE_EXPONENT_FINAL;
+                    ctx->scanner.p_state = STATE_EXPONENT_FINAL;
                 } else if (c == '+' || c == '-') {
                     d_array_append(&token.lexeme, c);
-                    scanner.p_state = STATE_EXPONENT_POSITIVE_NEGATIVE;
+                    ctx->scanner.p_state = STATE_EXPONENT_POSITIVE_NEGATIVE;
                 } else {
                     token.id = TOKEN_ERROR;
-                    error = ERR_LEXICAL;
-                    fprintf(stderr, RED_BOLD("error")": invalid decimal base\n");
-                    ungetc(c, stdin);
+                    ctx->error = ERR_LEXICAL;
+                    ctx->scanner.message = RED_BOLD("error")": invalid decimal base\n";
+                    unget_char(c);
                     return token;
                 }
                 break;
@@ -362,12 +429,12 @@ token_t get_token(void) {
             case STATE_EXPONENT_POSITIVE_NEGATIVE:
                 if (isdigit(c)) {
                     d_array_append(&token.lexeme, c);
-                    scanner.p_state = STATE_EXPONENT_FINAL;
+                    ctx->scanner.p_state = STATE_EXPONENT_FINAL;
                 } else {
                     token.id = TOKEN_ERROR;
-                    error = ERR_LEXICAL;
-                    fprintf(stderr, RED_BOLD("error")": invalid decimal base\n");
-                    ungetc(c, stdin);
+                    ctx->error = ERR_LEXICAL;
+                    ctx->scanner.message = RED_BOLD("error")": invalid decimal base\n";
+                    unget_char(c);
                     return token;
                 }
                 break;
@@ -377,7 +444,7 @@ token_t get_token(void) {
                     d_array_append(&token.lexeme, c);
                 } else {
                     token.id = TOKEN_LITERAL_F64;
-                    ungetc(c, stdin);
+                    unget_char(c);
                     d_array_append(&token.lexeme, '\0');
                     return token;
                 }
@@ -388,7 +455,7 @@ token_t get_token(void) {
                 if (isalpha(c)) {
                     d_array_append(&token.lexeme, c);
                 } else {
-                    ungetc(c, stdin);
+                    unget_char(c);
 
                     d_array_append(&token.lexeme, '\0');
 
@@ -396,8 +463,8 @@ token_t get_token(void) {
                         token.id = TOKEN_PROLOG;
                     } else {
                         token.id = TOKEN_ERROR;
-                        error = ERR_LEXICAL;
-                        fprintf(stderr, RED_BOLD("error")": invalid builtin function\n");
+                        ctx->error = ERR_LEXICAL;
+                        ctx->scanner.message = RED_BOLD("error")": invalid builtin function\n";
                     }
 
                     //d_array_remove(&token.lexeme, token.lexeme.length - 1);
@@ -411,7 +478,7 @@ token_t get_token(void) {
                     d_array_append(&token.lexeme, '\0');
                     return token;
                 } else if (c == '\\') {
-                    c = getc(stdin);
+                    c = next_char();
                     int initial_array_size = token.lexeme.length;
                     for (int i = 0; i < BACKSLASH_SIGNS; i++) {
                         if (special_chars[i] == c) {
@@ -420,12 +487,12 @@ token_t get_token(void) {
                         } else if ('x' == c) {
                             char hex_chars[3] = {0};
                             for (int hex_number = 0; hex_number < 2; hex_number++) {
-                                c = getc(stdin);
+                                c = next_char();
                                 if (valid_hex(c)) {
                                     hex_chars[hex_number] = c;
                                 } else {
                                     token.id = TOKEN_ERROR;
-                                    error = ERR_LEXICAL;
+                                    ctx->error = ERR_LEXICAL;
                                     return token;
                                 }
                             }
@@ -437,14 +504,14 @@ token_t get_token(void) {
                     }
                     if (initial_array_size == token.lexeme.length) {
                         token.id = TOKEN_ERROR;
-                        error = ERR_LEXICAL;
+                        ctx->error = ERR_LEXICAL;
                         return token;
                     }
                 } else if (c >= 32 && c <= 126) {
                     d_array_append(&token.lexeme, c);
                 } else {
                     token.id = TOKEN_ERROR;
-                    error = ERR_LEXICAL;
+                    ctx->error = ERR_LEXICAL;
                     return token;
                 }
                 break;
@@ -452,7 +519,7 @@ token_t get_token(void) {
             case STATE_MULTILINE_STRING_START:
                 if (c == '\\') {
                     d_array_append(&token.lexeme, '\\');
-                    c = getc(stdin);
+                    c = next_char();
                     int initial_array_size = token.lexeme.length;
                     for (int i = 0; i < BACKSLASH_SIGNS; i++) {
                         if (special_chars[i] == c) {
@@ -461,12 +528,12 @@ token_t get_token(void) {
                         } else if ('x' == c) {
                             d_array_append(&token.lexeme, c);
                             for (int hex_number = 0; hex_number < 2; hex_number++) {
-                                c = getc(stdin);
+                                c = next_char();
                                 if (valid_hex(c)) {
                                     d_array_append(&token.lexeme, c);
                                 } else {
                                     token.id = TOKEN_ERROR;
-                                    error = ERR_LEXICAL;
+                                    ctx->error = ERR_LEXICAL;
                                     return token;
                                 }
                             }
@@ -475,47 +542,47 @@ token_t get_token(void) {
                     }
                     if (initial_array_size == token.lexeme.length) {
                         token.id = TOKEN_ERROR;
-                        error = ERR_LEXICAL;
+                        ctx->error = ERR_LEXICAL;
                         return token;
                     }
                 } else if (c >= 32 && c <= 126) {
                     d_array_append(&token.lexeme, c);
                 } else if (c == '\n') {
-                    scanner.p_state = STATE_NEXT_MULTILINE;
+                    ctx->scanner.p_state = STATE_NEXT_MULTILINE;
                 }    
                   else if (c == EOF) {
-                    scanner.p_state = STATE_NEXT_MULTILINE;
+                    ctx->scanner.p_state = STATE_NEXT_MULTILINE;
                 } else {
                     token.id = TOKEN_ERROR;
-                    error = ERR_LEXICAL;
+                    ctx->error = ERR_LEXICAL;
                     return token;
                 }
                 break;
 
             case STATE_NEXT_MULTILINE:
                 while(isspace(c)){
-                    c = getc(stdin);
+                    c = next_char();
                 }
                 if(c == '\\'){
-                    c = getc(stdin);
+                    c = next_char();
                     if(c == '\\'){
                         d_array_append(&token.lexeme, '\n');
-                        scanner.p_state = STATE_MULTILINE_STRING_START;
+                        ctx->scanner.p_state = STATE_MULTILINE_STRING_START;
                     }
                 } else if(!isspace(c) || c == EOF){
-                    ungetc(c, stdin);
+                    unget_char(c);
                     d_array_append(&token.lexeme, '\0');
                     return token;
                 } else {
                     token.id = TOKEN_ERROR;
-                    error = ERR_LEXICAL;
+                    ctx->error = ERR_LEXICAL;
                     return token;
                 }
                 break;
 
             default:
                 token.id = TOKEN_ERROR;
-                error = ERR_LEXICAL;
+                ctx->error = ERR_LEXICAL;
                 return token;
                 break;
         }
@@ -523,13 +590,142 @@ token_t get_token(void) {
     return token;
 }
 
+/* Power of two, the ring holds a few pages of tokens so the scanner runs ahead of the parser */
+#define TOKEN_RING_SIZE 1024
+
+/* Scanned token together with the state of the scanner after it */
+typedef struct token_slot {
+    token_t token;
+    unsigned int error;     // ctx->error of the scanner thread after the token
+    const char *message;    // Diagnostic of the lexical error of the token
+} token_slot;
+
+/*
+ * Single producer single consumer ring between the scanner thread and the parser. Each index is written by one
+ * thread only, the release store of an index publishes the slots before it. The indexes are kept on separate
+ * cache lines and every side reloads the index of the other side only when its cached copy says the ring is
+ * full or empty.
+ */
+typedef struct token_ring {
+    size_t head;                // Next slot taken by the parser
+    size_t cached_tail;         // Tail seen by the parser
+    bool finished;              // Parser took the last token, end of file or lexical error
+    char padding_head[64];
+    size_t tail;                // Next slot filled by the scanner thread
+    size_t cached_head;         // Head seen by the scanner thread
+    bool stop;                  // Parser does not take any more tokens
+    char padding_tail[64];
+    pthread_t thread;
+    compiler_context context;   // Context of the scanner thread, its errors are passed in the slots
+    token_slot slots[TOKEN_RING_SIZE];
+} token_ring;
+
+static void *scanner_thread(void *argument) {
+    token_ring *ring = argument;
+    ctx = &ring->context;
+    size_t tail = 0;
+    while (true) {
+        while (tail - ring->cached_head == TOKEN_RING_SIZE) {
+            if (__atomic_load_n(&ring->stop, __ATOMIC_ACQUIRE)) {
+                return NULL;
+            }
+            sched_yield();
+            ring->cached_head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+        }
+        token_slot *slot = &ring->slots[tail & (TOKEN_RING_SIZE - 1)];
+        slot->token = scan_token();
+        slot->error = ctx->error;
+        slot->message = ctx->scanner.message;
+        // The slot belongs to the parser after the store
+        bool last = slot->token.id == TOKEN_EOF || slot->token.id == TOKEN_ERROR;
+        __atomic_store_n(&ring->tail, ++tail, __ATOMIC_RELEASE);
+        if (last || __atomic_load_n(&ring->stop, __ATOMIC_RELAXED)) {
+            return NULL;
+        }
+    }
+}
+
+bool start_scanner_thread(void) {
+    token_ring *ring = malloc(sizeof(token_ring));
+    if (ring == NULL) {
+        return false;
+    }
+    ring->head = ring->cached_tail = ring->tail = ring->cached_head = 0;
+    ring->finished = ring->stop = false;
+    ring->context = (compiler_context){
+        .optimization = ctx->optimization, .messages = ctx->messages, .errors = ctx->errors, .scanner = ctx->scanner,
+    };
+    ring->context.scanner.lexemes = NULL;
+    ring->context.scanner.lexeme_count = ring->context.scanner.lexeme_capacity = 0;
+    if (pthread_create(&ring->thread, NULL, scanner_thread, ring) != 0) {
+        free(ring);
+        return false;
+    }
+    ctx->scanner.ring = ring;
+    return true;
+}
+
+void stop_scanner_thread(void) {
+    token_ring *ring = ctx->scanner.ring;
+    if (ring == NULL) {
+        return;
+    }
+    __atomic_store_n(&ring->stop, true, __ATOMIC_RELEASE);
+    pthread_join(ring->thread, NULL);
+    for (size_t i = ring->head; i != ring->tail; i++) {
+        free(ring->slots[i & (TOKEN_RING_SIZE - 1)].token.lexeme.array);
+    }
+    free(ring);
+    ctx->scanner.ring = NULL;
+}
+
+/* Takes the next token of the scanner thread, the error of the token is reported now, not when it was scanned */
+static token_t receive_token(token_ring *ring) {
+    if (ring->finished) {
+        // The scanner thread stopped, on demand scanning would return end of file again
+        token_t token = {.id = TOKEN_EOF};
+        d_array_init(&token.lexeme, 16);
+        return token;
+    }
+    while (ring->cached_tail == ring->head) {
+        ring->cached_tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+        if (ring->cached_tail == ring->head) {
+            sched_yield();
+        }
+    }
+    token_slot slot = ring->slots[ring->head & (TOKEN_RING_SIZE - 1)];
+    __atomic_store_n(&ring->head, ring->head + 1, __ATOMIC_RELEASE);
+    ring->finished = slot.token.id == TOKEN_EOF || slot.token.id == TOKEN_ERROR;
+    ctx->error = slot.error;
+    ctx->scanner.message = slot.message;
+    return slot.token;
+}
+
+/* Lexical analysis measured by --stats, with the scanner thread the time is spent waiting for tokens */
+token_t get_token(void) {
+    stats_enter(STATS_LEX);
+    token_t token = ctx->scanner.ring != NULL ? receive_token(ctx->scanner.ring) : scan_token();
+    stats_leave();
+    if (ctx->scanner.message != NULL) {
+        fputs(ctx->scanner.message, compiler_errors());
+        ctx->scanner.message = NULL;
+    }
+    ctx->scanner.token_row = token.row;
+    ctx->scanner.token_col = token.col;
+    if (!keep_lexeme(token.lexeme.array)) {
+        token.id = TOKEN_ERROR;
+    }
+    stats_count(STATS_TOKENS, 1);
+    return token;
+}
+
 void ignore_comment() {
     char c;
 
-    while((c = getc(stdin)) != '\n' && c != EOF);
+    while((c = next_char()) != '\n' && c != EOF);
 
     if(c == EOF) // Necessary to return EOF, since it is standalone token
-        ungetc(c,stdin);
+        unget_char(c);
 }
 
 /**
@@ -10,6 +10,7 @@
 #ifndef LEXER_H
 #define LEXER_H
 
+#include <stdio.h>
 #include <stdbool.h>
 #include "token.h"
 
@@ -40,16 +41,42 @@ typedef enum fsm_state {
 typedef struct scanner {
 	fsm_state p_state;		// Present state of FSM
 	unsigned int row, col;	// Current row and column in the given file
+	unsigned int line_length;	// Columns of the previous row, the position returns there when a newline is put back
+	unsigned int token_row, token_col;	// Position of the last token returned to the parser, new AST nodes take it
 	size_t head_pos;		// Position of reading head
 	token_t current_token;	// Most recent token
+	FILE *source;			// Stream with the source code
+	char **lexemes;			// Lexemes of returned tokens, the AST and symtables refer to them until they are released
+	size_t lexeme_count, lexeme_capacity;
+	const char *message;	// Diagnostic of the lexical error of the last token, printed when the parser gets the token
+	struct token_ring *ring;	// Tokens scanned ahead by the scanner thread, NULL when tokens are scanned on demand
 } scanner_t;
 
-/* Initialization of scanner*/
-void init_scanner(void);
+/* Initialization of scanner, source code is read from the given stream */
+void init_scanner(FILE *source);
 
 /* Final state machine, fetches token for syntax analyser */
 token_t get_token(void);
 
+/* Moves scanning of the source code to its own thread, get_token then takes the tokens from a lock-free ring.
+   Returns false when the thread can not be started, tokens are then scanned on demand */
+bool start_scanner_thread(void);
+
+/* Stops the scanner thread and frees the tokens the parser did not take */
+void stop_scanner_thread(void);
+
+/* Makes the scanner owner of the lexeme, returns false on allocation error */
+bool keep_lexeme(char *lexeme);
+
+/* Count of kept lexemes, lexemes kept after the mark are freed by release_lexemes */
+size_t lexeme_mark(void);
+
+/* Frees lexemes kept after the mark */
+void release_lexemes(size_t mark);
+
+/* Stops the scanner thread and frees all lexemes of the compilation */
+void dispose_scanner(void);
+
 /* Ignores every char until newline */
 void ignore_comment();
 
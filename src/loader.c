@@ -0,0 +1,399 @@
+/**
+ * Název projektu: Implementace překladače imperativního jazyka IFJ24.
+ *
+ * @file loader.c
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "loader.h"
+#include "options.h"
+#include "vm.h"
+
+// Prefix of function labels generated by codegen
+#define FUNCTION_PREFIX "FUN_"
+
+// Slots of variables of one frame layout
+typedef struct frame_layout{
+    const char** names;
+    size_t count;
+    size_t capacity;
+} frame_layout;
+
+typedef struct label_entry{
+    const char* name;
+    size_t target;  // Index of the first instruction after the label in loaded code
+    size_t layout;  // Frame layout of function label
+} label_entry;
+
+// State of the loader
+typedef struct loader_state{
+    const ir_program* program;
+    vm_code* code;
+    label_entry* labels;        // Sorted by name
+    size_t label_count;
+    frame_layout* layouts;      // Global frame, code before the first function and one layout per function
+    size_t layout_count;
+    size_t local_layout;        // Layout of LF in the current function
+    size_t temporary_layout;    // Layout of the current TF
+} loader_state;
+
+// Layout of GF
+#define GLOBAL_LAYOUT 0
+// Layout of code before the first function
+#define TOP_LEVEL_LAYOUT 1
+
+static int compare_labels(const void* a, const void* b){
+    return strcmp(((const label_entry*)a)->name, ((const label_entry*)b)->name);
+}
+
+static bool is_function_label(const char* name){
+    return strncmp(name, FUNCTION_PREFIX, strlen(FUNCTION_PREFIX)) == 0;
+}
+
+static bool is_loaded(ir_opcode op){
+    return op != IR_LABEL && op != IR_COMMENT;
+}
+
+/**
+ * Finds label
+ * \param loader
+ * \param name
+ * \return label | NULL if it is not defined
+ */
+static label_entry* find_label(loader_state* loader, const char* name){
+    label_entry key = {.name = name};
+    return bsearch(&key, loader->labels, loader->label_count, sizeof(label_entry), compare_labels);
+}
+
+/**
+ * Finds slot of variable in layout, the variable gets a new slot when it is not there
+ * \param layout
+ * \param name
+ * \param out slot index
+ * \return 0: success, VM_ERR_INTERNAL: memory allocation error
+ */
+static int layout_slot(frame_layout* layout, const char* name, size_t* out){
+    for(size_t i = 0; i < layout->count; i++){
+        if(strcmp(layout->names[i], name) == 0){
+            *out = i;
+            return 0;
+        }
+    }
+    if(layout->count == layout->capacity){
+        size_t capacity = layout->capacity ? layout->capacity * 2 : 8;
+        const char** names = realloc(layout->names, sizeof(const char*) * capacity);
+        if(names == NULL){
+            return VM_ERR_INTERNAL;
+        }
+        layout->names = names;
+        layout->capacity = capacity;
+    }
+    layout->names[layout->count] = name;
+    *out = layout->count++;
+    return 0;
+}
+
+/**
+ * Collects labels with their targets and creates layout for every function
+ * \param loader
+ * \return 0: success, VM_ERR_SEMANTIC: label redefinition, VM_ERR_INTERNAL
+ */
+static int collect_labels(loader_state* loader){
+    const ir_program* program = loader->program;
+    size_t count = 0;
+    for(size_t i = 0; i < program->count; i++){
+        count += program->code[i].op == IR_LABEL;
+    }
+    loader->labels = malloc(sizeof(label_entry) * (count + 1));
+    loader->layouts = calloc(count + 2, sizeof(frame_layout));
+    if(loader->labels == NULL || loader->layouts == NULL){
+        return VM_ERR_INTERNAL;
+    }
+    loader->layout_count = TOP_LEVEL_LAYOUT + 1;
+    size_t target = 0;
+    for(size_t i = 0; i < program->count; i++){
+        const ir_instruction* instruction = &program->code[i];
+        if(instruction->op == IR_LABEL){
+            label_entry* label = &loader->labels[loader->label_count++];
+            label->name = instruction->args[0].value.name;
+            label->target = target;
+            label->layout = is_function_label(label->name) ? loader->layout_count++ : TOP_LEVEL_LAYOUT;
+        }
+        target += is_loaded(instruction->op);
+    }
+    qsort(loader->labels, loader->label_count, sizeof(label_entry), compare_labels);
+    for(size_t i = 1; i < loader->label_count; i++){
+        if(strcmp(loader->labels[i - 1].name, loader->labels[i].name) == 0){
+            return VM_ERR_SEMANTIC;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Finds owner of the frame created at the given createframe instruction
+ * \param loader
+ * \param index index of createframe in the source program
+ * \return layout of the called function | layout of the current function
+ */
+static size_t created_frame_layout(loader_state* loader, size_t index){
+    const ir_program* program = loader->program;
+    for(size_t i = index + 1; i < program->count; i++){
+        const ir_instruction* instruction = &program->code[i];
+        if(instruction->op == IR_CALL){
+            label_entry* callee = find_label(loader, instruction->args[0].value.name);
+            return callee != NULL ? callee->layout : loader->local_layout;
+        }
+        if(instruction->op == IR_PUSHFRAME || instruction->op == IR_CREATEFRAME ||
+           (instruction->op == IR_LABEL && is_function_label(instruction->args[0].value.name))){
+            break;
+        }
+    }
+    return loader->local_layout;
+}
+
+/**
+ * Creates string constant owned by the loaded code
+ * \param string
+ * \param out
+ * \return 0: success, VM_ERR_INTERNAL
+ */
+static int load_string(const char* string, vm_operand* out){
+    rope* constant = rope_new(string, strlen(string));
+    if(constant == NULL){
+        return VM_ERR_INTERNAL;
+    }
+    out->constant = vm_string(constant);
+    return 0;
+}
+
+/**
+ * Resolves operand
+ * \param loader
+ * \param operand
+ * \param out
+ * \return 0: success, VM_ERR_SEMANTIC: undefined label, VM_ERR_OPERAND_VALUE: int out of range, VM_ERR_INTERNAL
+ */
+static int load_operand(loader_state* loader, const ir_operand* operand, vm_operand* out){
+    label_entry* label;
+    out->kind = VM_OPERAND_CONST;
+    out->index = 0;
+    switch(operand->type){
+        case IR_NONE:
+            out->kind = VM_OPERAND_NONE;
+            return 0;
+        case IR_VAR:
+            switch(operand->frame){
+                case GLOBAL:
+                    out->kind = VM_OPERAND_GF;
+                    return layout_slot(&loader->layouts[GLOBAL_LAYOUT], operand->value.name, &out->index);
+                case LOCAL:
+                    out->kind = VM_OPERAND_LF;
+                    return layout_slot(&loader->layouts[loader->local_layout], operand->value.name, &out->index);
+                case TEMPORARY:
+                    out->kind = VM_OPERAND_TF;
+                    return layout_slot(&loader->layouts[loader->temporary_layout], operand->value.name, &out->index);
+            }
+            return VM_ERR_INTERNAL;
+        case IR_INT:
+            if(!vm_int_fits(operand->value.int_val)){
+                return VM_ERR_OPERAND_VALUE;
+            }
+            out->constant = vm_int(operand->value.int_val);
+            return 0;
+        case IR_FLOAT:
+            out->constant = vm_float(operand->value.float_val);
+            return 0;
+        case IR_BOOL:
+            out->constant = vm_bool(operand->value.bool_val);
+            return 0;
+        case IR_STRING:
+            return load_string(operand->value.string, out);
+        case IR_NIL:
+            out->constant = vm_simple(VM_NIL);
+            return 0;
+        case IR_TYPE_NAME:
+            return load_string(operand->value.name, out);
+        case IR_LABEL_NAME:
+            label = find_label(loader, operand->value.name);
+            if(label == NULL){
+                return VM_ERR_SEMANTIC;
+            }
+            out->kind = VM_OPERAND_TARGET;
+            out->index = label->target;
+            return 0;
+    }
+    return VM_ERR_INTERNAL;
+}
+
+/**
+ * Specialized instruction for proven operand type
+ * \param op
+ * \param type
+ * \return vm_opcode | op when there is no specialized instruction
+ */
+static int specialized_opcode(ir_opcode op, ir_value_type type){
+    static const struct{
+        ir_opcode op;
+        ir_value_type type;
+        vm_opcode specialized;
+    } specialized[] = {
+        {IR_ADDS, IR_TYPE_I32, VM_ADDS_I32}, {IR_SUBS, IR_TYPE_I32, VM_SUBS_I32}, {IR_MULS, IR_TYPE_I32, VM_MULS_I32},
+        {IR_IDIVS, IR_TYPE_I32, VM_IDIVS_I32}, {IR_LTS, IR_TYPE_I32, VM_LTS_I32}, {IR_GTS, IR_TYPE_I32, VM_GTS_I32},
+        {IR_EQS, IR_TYPE_I32, VM_EQS_I32},
+        {IR_ADDS, IR_TYPE_F64, VM_ADDS_F64}, {IR_SUBS, IR_TYPE_F64, VM_SUBS_F64}, {IR_MULS, IR_TYPE_F64, VM_MULS_F64},
+        {IR_DIVS, IR_TYPE_F64, VM_DIVS_F64}, {IR_LTS, IR_TYPE_F64, VM_LTS_F64}, {IR_GTS, IR_TYPE_F64, VM_GTS_F64},
+        {IR_EQS, IR_TYPE_F64, VM_EQS_F64},
+        {IR_CONCAT, IR_TYPE_STR, VM_CONCAT_STR},
+    };
+    for(size_t i = 0; i < sizeof(specialized) / sizeof(specialized[0]); i++){
+        if(specialized[i].op == op && specialized[i].type == type){
+            return specialized[i].specialized;
+        }
+    }
+    return op;
+}
+
+/**
+ * Translates instructions, createframe gets index of layout of the created frame
+ * \param loader
+ * \return 0: success, VM_ERR_SEMANTIC: undefined label, VM_ERR_OPERAND_VALUE: int constant out of range, VM_ERR_INTERNAL
+ */
+static int load_instructions(loader_state* loader){
+    const ir_program* program = loader->program;
+    vm_code* code = loader->code;
+    // One more instruction for the final exit
+    code->code = malloc(sizeof(vm_instruction) * (program->count + 1));
+    code->source = malloc(sizeof(size_t) * (program->count + 1));
+    if(code->code == NULL || code->source == NULL){
+        return VM_ERR_INTERNAL;
+    }
+    loader->local_layout = TOP_LEVEL_LAYOUT;
+    loader->temporary_layout = TOP_LEVEL_LAYOUT;
+    for(size_t i = 0; i < program->count; i++){
+        const ir_instruction* instruction = &program->code[i];
+        if(instruction->op == IR_LABEL && is_function_label(instruction->args[0].value.name)){
+            // Frame of the function is created by the caller as TF or by the function itself
+            loader->local_layout = find_label(loader, instruction->args[0].value.name)->layout;
+            loader->temporary_layout = loader->local_layout;
+        }
+        if(!is_loaded(instruction->op)){
+            continue;
+        }
+        if(instruction->op == IR_CREATEFRAME){
+            loader->temporary_layout = created_frame_layout(loader, i);
+        }
+        else if(instruction->op == IR_POPFRAME){
+            loader->temporary_layout = loader->local_layout;
+        }
+        // Partially loaded instruction is freed with the code in case of an error
+        vm_instruction* loaded = &code->code[code->count];
+        memset(loaded, 0, sizeof(vm_instruction));
+        loaded->op = specialized_opcode(instruction->op, instruction->operand_type);
+        code->source[code->count++] = i;
+        for(int j = 0; j < IR_MAX_OPERANDS; j++){
+            int err = load_operand(loader, &instruction->args[j], &loaded->args[j]);
+            if(err){
+                return err;
+            }
+        }
+        if(instruction->op == IR_CREATEFRAME){
+            loaded->args[0].index = loader->temporary_layout;
+        }
+    }
+    // Program ends with exit int@0 when it reaches its end
+    vm_instruction* end = &code->code[code->count];
+    memset(end, 0, sizeof(vm_instruction));
+    end->op = IR_EXIT;
+    end->args[0].kind = VM_OPERAND_CONST;
+    end->args[0].constant = vm_int(0);
+    code->source[code->count++] = program->count;
+
+    // Sizes of frames are known after all variables are resolved
+    for(size_t i = 0; i < code->count; i++){
+        if(code->code[i].op == IR_CREATEFRAME){
+            code->code[i].args[0].index = loader->layouts[code->code[i].args[0].index].count;
+        }
+    }
+    code->global_size = loader->layouts[GLOBAL_LAYOUT].count;
+    return 0;
+}
+
+static bool is_same_variable(const vm_operand* a, const vm_operand* b){
+    return a->kind == b->kind && a->kind != VM_OPERAND_CONST && a->index == b->index;
+}
+
+static bool is_stack_relation(int op){
+    return op == IR_LTS || op == IR_GTS || op == IR_EQS ||
+           op == VM_LTS_I32 || op == VM_GTS_I32 || op == VM_EQS_I32 || op == VM_LTS_F64 || op == VM_GTS_F64 || op == VM_EQS_F64;
+}
+
+static bool is_stack_arithmetic(int op){
+    return op == IR_ADDS || op == IR_SUBS || op == IR_MULS || op == IR_DIVS || op == IR_IDIVS ||
+           (op >= VM_ADDS_I32 && op <= VM_DIVS_F64 && !is_stack_relation(op));
+}
+
+/**
+ * Marks sequences of stack code evaluating binary expression to variable, which are the most
+ * frequent sequences in the generated code, as superinstructions. Only the first instruction of sequence
+ * is changed, the rest stays as a target of jumps and for operands the superinstruction can not handle.
+ * \param code
+ */
+static void fuse_instructions(vm_code* code){
+    for(size_t i = 0; i + 4 < code->count; i++){
+        vm_instruction* sequence = &code->code[i];
+        if(sequence[0].op != IR_PUSHS || sequence[1].op != IR_PUSHS || sequence[3].op != IR_POPS ||
+           !(is_stack_arithmetic(sequence[2].op) || is_stack_relation(sequence[2].op))){
+            continue;
+        }
+        sequence[0].op = VM_FUSED_BINARY;
+        const vm_instruction* jump = &sequence[4];
+        if(is_stack_relation(sequence[2].op) && (jump->op == IR_JUMPIFEQ || jump->op == IR_JUMPIFNEQ) &&
+           is_same_variable(&jump->args[1], &sequence[3].args[0]) &&
+           jump->args[2].kind == VM_OPERAND_CONST && vm_is(jump->args[2].constant, VM_BOOL)){
+            sequence[0].op = VM_FUSED_BRANCH;
+        }
+    }
+}
+
+int vm_load(const ir_program* program, opt_level optimization, vm_code* out){
+    loader_state loader = {.program = program, .code = out};
+    out->code = NULL;
+    out->source = NULL;
+    out->count = 0;
+    out->global_size = 0;
+    int err = collect_labels(&loader);
+    if(!err){
+        err = load_instructions(&loader);
+    }
+    if(!err && optimization >= OPT_BASIC){
+        fuse_instructions(out);
+    }
+    for(size_t i = 0; i < loader.layout_count; i++){
+        free(loader.layouts[i].names);
+    }
+    free(loader.layouts);
+    free(loader.labels);
+    if(err){
+        vm_free_code(out);
+    }
+    return err;
+}
+
+void vm_free_code(vm_code* code){
+    for(size_t i = 0; i < code->count; i++){
+        for(int j = 0; j < IR_MAX_OPERANDS; j++){
+            const vm_operand* operand = &code->code[i].args[j];
+            if(operand->kind == VM_OPERAND_CONST && vm_is(operand->constant, VM_STRING)){
+                rope_release(vm_as_string(operand->constant));
+            }
+        }
+    }
+    free(code->code);
+    free(code->source);
+    code->code = NULL;
+    code->source = NULL;
+    code->count = 0;
+}
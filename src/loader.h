@@ -0,0 +1,93 @@
+/**
+ * Název projektu: Implementace překladače imperativního jazyka IFJ24.
+ *
+ * @file loader.h
+ */
+
+#ifndef LOADER_H
+#define LOADER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "ir.h"
+#include "options.h"
+#include "value.h"
+
+typedef enum vm_operand_kind{
+    VM_OPERAND_NONE,
+    VM_OPERAND_GF,      // Slot in global frame
+    VM_OPERAND_LF,      // Slot in local frame
+    VM_OPERAND_TF,      // Slot in temporary frame
+    VM_OPERAND_CONST,   // Literal, strings are owned by the source program
+    VM_OPERAND_TARGET,  // Instruction index of label
+} vm_operand_kind;
+
+// Operand with names resolved at load time
+typedef struct vm_operand{
+    vm_operand_kind kind;
+    size_t index;       // Slot, jump target, frame size of createframe
+    vm_value constant;  // In case of VM_OPERAND_CONST
+} vm_operand;
+
+// Instructions of the interpreter created by the loader, they follow the IR opcodes
+typedef enum vm_opcode{
+    /*
+     * Superinstructions created from frequent sequences of stack code,
+     * the replaced instructions stay in place after the superinstruction.
+     */
+    VM_FUSED_BINARY = IR_OPCODE_COUNT, // pushs a; pushs b; <arithmetic or relational>s; pops x
+    VM_FUSED_BRANCH,                   // VM_FUSED_BINARY with relation followed by jumpifeq/jumpifneq on x and bool
+    // Instructions with operand types proven by the compiler, operands are not checked
+    VM_ADDS_I32,
+    VM_SUBS_I32,
+    VM_MULS_I32,
+    VM_IDIVS_I32,
+    VM_LTS_I32,
+    VM_GTS_I32,
+    VM_EQS_I32,
+    VM_ADDS_F64,
+    VM_SUBS_F64,
+    VM_MULS_F64,
+    VM_DIVS_F64,
+    VM_LTS_F64,
+    VM_GTS_F64,
+    VM_EQS_F64,
+    VM_CONCAT_STR,
+    VM_OPCODE_COUNT
+} vm_opcode;
+
+typedef struct vm_instruction{
+    const void* handler; // Address of the handler in threaded interpreter
+    int op;              // ir_opcode | vm_opcode
+    vm_operand args[IR_MAX_OPERANDS];
+} vm_instruction;
+
+// Loaded program without labels and comments, the last instruction is exit int@0
+typedef struct vm_code{
+    vm_instruction* code;
+    size_t* source;     // Index of the instruction in the source program
+    size_t count;
+    size_t global_size; // Count of GF slots
+} vm_code;
+
+/**
+ * Resolves labels to instruction indexes and variables to frame slots.
+ *
+ * LF variables are numbered per function, the function owning a frame created by createframe is the
+ * function called by the next call instruction, or the current function when pushframe comes first.
+ * Instructions with proven operand types are specialized, superinstructions are created with -O1.
+ * \param program source program, has to outlive the loaded code
+ * \param optimization optimization level the program was compiled at
+ * \param out
+ * \return 0: success, 52: undefined or redefined label, 57: int constant out of range of the values, 99: memory allocation error
+ */
+int vm_load(const ir_program* program, opt_level optimization, vm_code* out);
+
+/**
+ * Frees loaded code
+ * \param code
+ */
+void vm_free_code(vm_code* code);
+
+#endif
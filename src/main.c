@@ -13,28 +13,122 @@
 #include <stdbool.h>
 #include <string.h>
 
+#include "cache.h"
+#include "compiler.h"
 #include "compiler_error.h"
-#include "lexer.h"
-#include "dynamic_array.h"
-#include "syna.h"
-#include "precedent.h"
-#include "binary_tree.h"
-#include "token.h"
+#include "metrics.h"
+#include "options.h"
+#include "server.h"
+#include "stream.h"
+#include "vm.h"
+#include "stats.h"
 
-int main (void) {
-	/* Init. of scanner struct */
-	init_scanner();
+int main (int argc, char **argv) {
+	/* Command line options */
+	if (!parse_options(argc, argv)) {
+		print_usage(argv[0]);
+		return ERR_COMPILER_INTERNAL;
+	}
+	if (options.batch != NULL) {
+		return compile_batch(options.batch, options.jobs);
+	}
+	if (options.server != NULL) {
+		return compile_server(options.server, options.jobs);
+	}
+	stats_start();
+
+	/* Source code is read from file or stdin */
+	FILE *source = stdin;
+	if (options.source != NULL && (source = fopen(options.source, "r")) == NULL) {
+		fprintf(stderr, "cannot open '%s'\n", options.source);
+		return ERR_COMPILER_INTERNAL;
+	}
+
+	/* Printed code of an unchanged program is taken from the cache without compilation */
+	if (options.cache != NULL && !options.run) {
+		unsigned int result = cache_compile(options.cache, options.cache_size << 20, source, stdout);
+		fflush(stdout);
+		if (source != stdin) {
+			fclose(source);
+		}
+		if (result) {
+			print_error(result);
+		}
+		stats_report(stderr);
+		return result;
+	}
 
-	if (error) {
-		print_error(error);
+	/* Table of source positions of the printed instructions */
+	FILE *table = NULL;
+	if (options.line_table != NULL && (table = fopen(options.line_table, "w")) == NULL) {
+		fprintf(stderr, "cannot open '%s'\n", options.line_table);
+		if (source != stdin) {
+			fclose(source);
+		}
+		return ERR_COMPILER_INTERNAL;
 	}
 
-	token_t test = {.id = TOKEN_DEFAULT};
-	init_parser(test);
+	/* Functions are printed as soon as they are generated */
+	if (options.stream) {
+		unsigned int result = compile_stream(source, options.optimization, stdout, table);
+		fflush(stdout);
+		if (source != stdin) {
+			fclose(source);
+		}
+		if (table != NULL && fclose(table) != 0 && !result) {
+			result = ERR_COMPILER_INTERNAL;
+		}
+		if (result) {
+			print_error(result);
+		}
+		stats_report(stderr);
+		return result;
+	}
+
+	ir_program program;
+	unsigned int result = compile(source, options.optimization, &program);
+
+	if (source != stdin) {
+		fclose(source);
+	}
+
+	if (result) {
+		if (table != NULL) {
+			fclose(table);
+		}
+		print_error(result);
+		stats_report(stderr);
+		return result;
+	}
+
+	if (options.metrics != STATS_NONE && !metrics_report(&program, options.metrics, stderr)) {
+		fprintf(stderr, "cannot compute metrics of the generated code\n");
+	}
 
-	if (error) {
-		print_error(error);
+	/* Execute or print the generated program */
+	int exit_code = 0;
+	if (options.run) {
+		stats_enter(STATS_RUN);
+		exit_code = vm_run(&program, options.optimization);
+		stats_leave();
+	} else {
+		stats_enter(STATS_OUTPUT);
+		if (table != NULL || options.line_comments) {
+			/* Instructions start on the line after the header */
+			fputs(".IFJcode24\n", stdout);
+			ir_print_mapped(&program, stdout, 2, options.line_comments, table);
+		} else {
+			ir_print(&program, stdout);
+		}
+		fflush(stdout);
+		if (table != NULL && fclose(table) != 0) {
+			fprintf(stderr, "cannot write '%s'\n", options.line_table);
+			exit_code = ERR_COMPILER_INTERNAL;
+		}
+		stats_leave();
 	}
+	ir_dispose(&program);
+	stats_report(stderr);
 
-	return error;
+	return exit_code;
 }
\ No newline at end of file
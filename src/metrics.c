@@ -0,0 +1,416 @@
+/**
+ * Název projektu: Implementace překladače imperativního jazyka IFJ24.
+ *
+ * @file metrics.c
+ */
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "metrics.h"
+
+// Label of a function, the rest of the label is the name of the function
+#define METRICS_FUNCTION_PREFIX "FUN_"
+
+// Passes over a function and rounds over all functions, a loop or recursion still growing the stack after them is unbounded
+#define METRICS_PASSES 64
+
+// Depth of label that was not reached by any jump yet
+#define METRICS_UNKNOWN LONG_MIN
+
+typedef struct metrics_function{
+    const char* name;
+    size_t start, end;                  // Instructions of the function
+    size_t opcodes[IR_OPCODE_COUNT];
+    long effect;                        // Depth of the stack at return relative to the entry
+    long peak;                          // Maximum depth relative to the entry, including called functions
+    bool unbounded;                     // The stack grows without a limit in a loop or recursion
+} metrics_function;
+
+typedef struct metrics_label{
+    const char* name;
+    size_t index;
+} metrics_label;
+
+typedef struct metrics_t{
+    const ir_program* program;
+    metrics_function* functions;
+    size_t function_count;
+    size_t* targets;                    // Instruction index of the label of a jump or call, SIZE_MAX when not found
+    metrics_function** callees;         // Called function of every call instruction
+    long* depths;                       // Depth at every label of the analysed function
+} metrics_t;
+
+static int metrics_compare_labels(const void* first, const void* second){
+    return strcmp(((const metrics_label*)first)->name, ((const metrics_label*)second)->name);
+}
+
+static bool metrics_is_function(const ir_instruction* instruction){
+    return instruction->op == IR_LABEL && strncmp(instruction->args[0].value.name, METRICS_FUNCTION_PREFIX,
+                                                  strlen(METRICS_FUNCTION_PREFIX)) == 0;
+}
+
+/**
+ * Splits the program into functions, counts opcodes and resolves targets of jumps and calls
+ * \param metrics
+ * \return true: success, false: memory allocation error
+ */
+static bool metrics_split(metrics_t* metrics){
+    const ir_program* program = metrics->program;
+    size_t label_count = 0, function_count = 1;
+    for(size_t i = 0; i < program->count; i++){
+        if(program->code[i].op == IR_LABEL){
+            label_count++;
+            function_count += metrics_is_function(&program->code[i]);
+        }
+    }
+    metrics_label* labels = malloc((label_count + 1) * sizeof(metrics_label));
+    metrics->functions = calloc(function_count, sizeof(metrics_function));
+    metrics->targets = malloc((program->count + 1) * sizeof(size_t));
+    metrics->callees = calloc(program->count + 1, sizeof(metrics_function*));
+    metrics->depths = malloc((program->count + 1) * sizeof(long));
+    if(labels == NULL || metrics->functions == NULL || metrics->targets == NULL || metrics->callees == NULL
+       || metrics->depths == NULL){
+        free(labels);
+        return false;
+    }
+
+    // Code before the first function initializes globals and calls main
+    metrics_function* function = &metrics->functions[0];
+    function->name = "(init)";
+    metrics->function_count = 1;
+    label_count = 0;
+    for(size_t i = 0; i < program->count; i++){
+        const ir_instruction* instruction = &program->code[i];
+        if(metrics_is_function(instruction)){
+            function->end = i;
+            function = &metrics->functions[metrics->function_count++];
+            function->name = instruction->args[0].value.name + strlen(METRICS_FUNCTION_PREFIX);
+            function->start = i;
+        }
+        if(instruction->op == IR_LABEL){
+            labels[label_count++] = (metrics_label){.name = instruction->args[0].value.name, .index = i};
+        }
+        function->opcodes[instruction->op]++;
+    }
+    function->end = program->count;
+    qsort(labels, label_count, sizeof(metrics_label), metrics_compare_labels);
+
+    for(size_t i = 0; i < program->count; i++){
+        const ir_instruction* instruction = &program->code[i];
+        metrics->targets[i] = SIZE_MAX;
+        if(instruction->op != IR_JUMP && instruction->op != IR_JUMPIFEQ && instruction->op != IR_JUMPIFNEQ
+           && instruction->op != IR_CALL){
+            continue;
+        }
+        metrics_label key = {.name = instruction->args[0].value.name};
+        metrics_label* label = bsearch(&key, labels, label_count, sizeof(metrics_label), metrics_compare_labels);
+        if(label != NULL){
+            metrics->targets[i] = label->index;
+        }
+    }
+    // Calls are resolved to the functions starting at their labels
+    for(size_t i = 0; i < program->count; i++){
+        if(program->code[i].op != IR_CALL || metrics->targets[i] == SIZE_MAX){
+            continue;
+        }
+        size_t low = 1, high = metrics->function_count;
+        while(low < high){
+            size_t middle = low + (high - low) / 2;
+            if(metrics->functions[middle].start < metrics->targets[i]){
+                low = middle + 1;
+            }
+            else{
+                high = middle;
+            }
+        }
+        if(low < metrics->function_count && metrics->functions[low].start == metrics->targets[i]){
+            metrics->callees[i] = &metrics->functions[low];
+        }
+    }
+    free(labels);
+    return true;
+}
+
+/**
+ * Change of the stack depth by an instruction without a call
+ * \param op
+ * \param depth depth before the instruction
+ * \return depth after the instruction
+ */
+static long metrics_stack_effect(ir_opcode op, long depth){
+    switch(op){
+        case IR_PUSHS:
+            return depth + 1;
+        case IR_POPS:
+            return depth - 1;
+        case IR_CLEARS:
+            return 0;
+        // Two operands are replaced by the result
+        case IR_ADDS:
+        case IR_SUBS:
+        case IR_MULS:
+        case IR_DIVS:
+        case IR_IDIVS:
+        case IR_LTS:
+        case IR_GTS:
+        case IR_EQS:
+        case IR_ORS:
+            return depth - 1;
+        default:
+            return depth;
+    }
+}
+
+// Merges depth of an edge into the label, returns true when the label got deeper
+static bool metrics_merge(metrics_t* metrics, metrics_function* function, size_t label, long depth){
+    if(label < function->start || label >= function->end || metrics->depths[label] >= depth){
+        return false;
+    }
+    metrics->depths[label] = depth;
+    return true;
+}
+
+/**
+ * Finds stack effect and peak of the function from the current estimates of the called functions
+ * \param metrics
+ * \param function
+ * \return true: effect, peak or unboundedness of the function changed
+ */
+static bool metrics_analyze(metrics_t* metrics, metrics_function* function){
+    const ir_instruction* code = metrics->program->code;
+    for(size_t i = function->start; i < function->end; i++){
+        metrics->depths[i] = METRICS_UNKNOWN;
+    }
+    long effect = 0, peak = 0;
+    bool unbounded = function->unbounded, changed = true;
+    // Depths of labels only grow, the last pass without a change has the final depths
+    for(int pass = 0; changed; pass++){
+        if(pass == METRICS_PASSES){
+            unbounded = true;
+            break;
+        }
+        changed = false;
+        effect = METRICS_UNKNOWN;
+        peak = 0;
+        long depth = 0;
+        bool reachable = true;
+        for(size_t i = function->start; i < function->end; i++){
+            const ir_instruction* instruction = &code[i];
+            if(instruction->op == IR_LABEL){
+                if(reachable){
+                    changed |= metrics_merge(metrics, function, i, depth);
+                }
+                reachable = metrics->depths[i] != METRICS_UNKNOWN;
+                depth = metrics->depths[i];
+            }
+            if(!reachable){
+                continue;
+            }
+            metrics_function* callee = metrics->callees[i];
+            switch(instruction->op){
+                case IR_CALL:
+                    if(callee != NULL){
+                        peak = depth + callee->peak > peak ? depth + callee->peak : peak;
+                        unbounded |= callee->unbounded;
+                        depth += callee->effect;
+                    }
+                    break;
+                case IR_JUMP:
+                    changed |= metrics_merge(metrics, function, metrics->targets[i], depth);
+                    reachable = false;
+                    break;
+                case IR_JUMPIFEQ:
+                case IR_JUMPIFNEQ:
+                    changed |= metrics_merge(metrics, function, metrics->targets[i], depth);
+                    break;
+                case IR_RETURN:
+                    effect = depth > effect ? depth : effect;
+                    reachable = false;
+                    break;
+                case IR_EXIT:
+                    reachable = false;
+                    break;
+                default:
+                    depth = metrics_stack_effect(instruction->op, depth);
+                    break;
+            }
+            peak = depth > peak ? depth : peak;
+        }
+    }
+    if(effect == METRICS_UNKNOWN){
+        effect = 0;
+    }
+    changed = effect != function->effect || unbounded != function->unbounded || (!unbounded && peak != function->peak);
+    function->effect = effect;
+    function->peak = peak;
+    function->unbounded = unbounded;
+    return changed;
+}
+
+/**
+ * Orders functions so that called functions come before their callers, except in recursion
+ * \param metrics
+ * \param order array for function_count functions
+ * \return true: success, false: memory allocation error
+ */
+static bool metrics_order(metrics_t* metrics, metrics_function** order){
+    typedef struct metrics_visit{
+        metrics_function* function;
+        size_t next;                    // Next instruction searched for calls
+    } metrics_visit;
+    metrics_visit* stack = malloc(metrics->function_count * sizeof(metrics_visit));
+    bool* visited = calloc(metrics->function_count, sizeof(bool));
+    if(stack == NULL || visited == NULL){
+        free(stack);
+        free(visited);
+        return false;
+    }
+    size_t count = 0;
+    for(size_t root = 0; root < metrics->function_count; root++){
+        if(visited[root]){
+            continue;
+        }
+        visited[root] = true;
+        size_t depth = 0;
+        stack[depth++] = (metrics_visit){.function = &metrics->functions[root], .next = metrics->functions[root].start};
+        while(depth > 0){
+            metrics_visit* visit = &stack[depth - 1];
+            metrics_function* callee = NULL;
+            while(visit->next < visit->function->end && callee == NULL){
+                callee = metrics->callees[visit->next++];
+                if(callee != NULL && visited[callee - metrics->functions]){
+                    callee = NULL;
+                }
+            }
+            if(callee != NULL){
+                visited[callee - metrics->functions] = true;
+                stack[depth++] = (metrics_visit){.function = callee, .next = callee->start};
+            }
+            else{
+                order[count++] = visit->function;
+                depth--;
+            }
+        }
+    }
+    free(stack);
+    free(visited);
+    return true;
+}
+
+/**
+ * Estimates stack depths of all functions
+ * \param metrics
+ * \return true: success, false: memory allocation error
+ */
+static bool metrics_stack(metrics_t* metrics){
+    metrics_function** order = malloc(metrics->function_count * sizeof(metrics_function*));
+    if(order == NULL || !metrics_order(metrics, order)){
+        free(order);
+        return false;
+    }
+    bool changed = true;
+    for(int round = 0; changed; round++){
+        changed = false;
+        for(size_t i = 0; i < metrics->function_count; i++){
+            // Recursion that has not settled grows the stack with every call
+            if(round >= METRICS_PASSES && !order[i]->unbounded && metrics_analyze(metrics, order[i])){
+                order[i]->unbounded = true;
+                changed = true;
+            }
+            else if(round < METRICS_PASSES){
+                changed |= metrics_analyze(metrics, order[i]);
+            }
+        }
+    }
+    free(order);
+    return true;
+}
+
+static void metrics_print_text(const metrics_function* function, FILE* out){
+    fprintf(out, "%-24s %12zu %7zu %6zu %6zu %6zu %6zu ", function->name,
+            function->end - function->start - function->opcodes[IR_COMMENT], function->opcodes[IR_DEFVAR],
+            function->opcodes[IR_LABEL], function->opcodes[IR_CALL], function->opcodes[IR_PUSHS],
+            function->opcodes[IR_POPS]);
+    if(function->unbounded){
+        fprintf(out, "%9s\n ", "unbounded");
+    }
+    else{
+        fprintf(out, "%9ld\n ", function->peak);
+    }
+    for(int op = 0; op < IR_OPCODE_COUNT; op++){
+        if(op != IR_COMMENT && function->opcodes[op] > 0){
+            fprintf(out, " %s %zu", ir_opcode_name(op), function->opcodes[op]);
+        }
+    }
+    putc('\n', out);
+}
+
+static void metrics_print_json(const metrics_function* function, FILE* out){
+    fputs("{\"name\": \"", out);
+    // Names come from labels, they need no escaping
+    fputs(function->name, out);
+    fprintf(out, "\", \"instructions\": %zu, \"defvar\": %zu, \"label\": %zu, \"call\": %zu, \"pushs\": %zu, "
+            "\"pops\": %zu, \"max_stack\": ", function->end - function->start - function->opcodes[IR_COMMENT],
+            function->opcodes[IR_DEFVAR], function->opcodes[IR_LABEL], function->opcodes[IR_CALL],
+            function->opcodes[IR_PUSHS], function->opcodes[IR_POPS]);
+    if(function->unbounded){
+        fputs("null", out);
+    }
+    else{
+        fprintf(out, "%ld", function->peak);
+    }
+    fputs(", \"opcodes\": {", out);
+    bool first = true;
+    for(int op = 0; op < IR_OPCODE_COUNT; op++){
+        if(op != IR_COMMENT && function->opcodes[op] > 0){
+            fprintf(out, "%s\"%s\": %zu", first ? "" : ", ", ir_opcode_name(op), function->opcodes[op]);
+            first = false;
+        }
+    }
+    fputs("}}", out);
+}
+
+bool metrics_report(const ir_program* program, stats_format format, FILE* out){
+    metrics_t metrics = {.program = program};
+    bool success = metrics_split(&metrics) && metrics_stack(&metrics);
+    if(success){
+        // The whole program is entered by the code before the first function
+        metrics_function total = metrics.functions[0];
+        total.name = "program";
+        total.start = 0;
+        total.end = program->count;
+        for(size_t i = 1; i < metrics.function_count; i++){
+            for(int op = 0; op < IR_OPCODE_COUNT; op++){
+                total.opcodes[op] += metrics.functions[i].opcodes[op];
+            }
+        }
+        if(format == STATS_JSON){
+            fputs("{\"functions\": [", out);
+            for(size_t i = 0; i < metrics.function_count; i++){
+                fputs(i > 0 ? ", " : "", out);
+                metrics_print_json(&metrics.functions[i], out);
+            }
+            fputs("], \"program\": ", out);
+            metrics_print_json(&total, out);
+            fputs("}\n", out);
+        }
+        else{
+            fprintf(out, "%-24s %12s %7s %6s %6s %6s %6s %9s\n", "function", "instructions", "defvar", "label",
+                    "call", "pushs", "pops", "max_stack");
+            for(size_t i = 0; i < metrics.function_count; i++){
+                metrics_print_text(&metrics.functions[i], out);
+            }
+            metrics_print_text(&total, out);
+        }
+        fflush(out);
+    }
+    free(metrics.functions);
+    free(metrics.targets);
+    free(metrics.callees);
+    free(metrics.depths);
+    return success;
+}
@@ -0,0 +1,32 @@
+/**
+ * Název projektu: Implementace překladače imperativního jazyka IFJ24.
+ *
+ * @file metrics.h
+ */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdio.h>
+
+#include "ir.h"
+#include "options.h"
+
+/*
+ * Static metrics of the generated code reported by --emit-metrics. The instruction stream is split into the code
+ * before the first function and the functions starting at their FUN_ labels. Every part reports its instructions
+ * by opcode and the estimated maximum depth of the data stack, including the functions it calls. The depth is found
+ * by following jumps inside of the function, the stack effect of a call is the depth of the callee at its return.
+ * Recursion or loops that grow the stack without a limit are reported as unbounded.
+ */
+
+/**
+ * Prints metrics of the generated program
+ * \param program
+ * \param format STATS_TEXT table for humans, STATS_JSON single JSON object
+ * \param out
+ * \return true: success, false: memory allocation error
+ */
+bool metrics_report(const ir_program* program, stats_format format, FILE* out);
+
+#endif
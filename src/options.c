@@ -0,0 +1,134 @@
+/** 
+ * Název projektu: Implementace překladače imperativního jazyka IFJ24.
+ * 
+ * @file options.c
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cache.h"
+#include "options.h"
+
+/* Global compiler options, defaults are used when no arguments are given */
+options_t options = {.optimization = OPT_BASIC, .run = false, .jit = true, .stream = false, .lexer_thread = false, .stats = STATS_NONE, .metrics = STATS_NONE, .source = NULL,
+	.batch = NULL, .server = NULL, .cache = NULL, .line_table = NULL, .line_comments = false, .cache_size = CACHE_DEFAULT_SIZE, .jobs = 0};
+
+bool parse_options(int argc, char **argv) {
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-O0") == 0) {
+			options.optimization = OPT_NONE;
+		} else if (strcmp(argv[i], "-O1") == 0) {
+			options.optimization = OPT_BASIC;
+		} else if (strcmp(argv[i], "--run") == 0) {
+			options.run = true;
+		} else if (strcmp(argv[i], "--stats") == 0 || strcmp(argv[i], "--stats=text") == 0) {
+			options.stats = STATS_TEXT;
+		} else if (strcmp(argv[i], "--stats=json") == 0) {
+			options.stats = STATS_JSON;
+		} else if (strcmp(argv[i], "--emit-metrics") == 0 || strcmp(argv[i], "--emit-metrics=text") == 0) {
+			options.metrics = STATS_TEXT;
+		} else if (strcmp(argv[i], "--emit-metrics=json") == 0) {
+			options.metrics = STATS_JSON;
+		} else if (strcmp(argv[i], "--no-jit") == 0) {
+			options.jit = false;
+		} else if (strcmp(argv[i], "--stream") == 0) {
+			options.stream = true;
+		} else if (strcmp(argv[i], "--lexer-thread") == 0) {
+			options.lexer_thread = true;
+		} else if (strcmp(argv[i], "--batch") == 0 && i + 1 < argc) {
+			options.batch = argv[++i];
+		} else if (strcmp(argv[i], "--server") == 0 && i + 1 < argc) {
+			options.server = argv[++i];
+		} else if (strcmp(argv[i], "--line-table") == 0 && i + 1 < argc) {
+			options.line_table = argv[++i];
+		} else if (strcmp(argv[i], "--line-comments") == 0) {
+			options.line_comments = true;
+		} else if (strcmp(argv[i], "--cache") == 0 && i + 1 < argc) {
+			options.cache = argv[++i];
+		} else if (strcmp(argv[i], "--cache-size") == 0 && i + 1 < argc) {
+			char *end;
+			long size = strtol(argv[++i], &end, 10);
+			if (*end != '\0' || size < 1) {
+				fprintf(stderr, "invalid cache size '%s'\n", argv[i]);
+				return false;
+			}
+			options.cache_size = (size_t)size;
+		} else if ((strcmp(argv[i], "-j") == 0 || strcmp(argv[i], "--jobs") == 0) && i + 1 < argc) {
+			char *end;
+			long jobs = strtol(argv[++i], &end, 10);
+			if (*end != '\0' || jobs < 1 || jobs > 1024) {
+				fprintf(stderr, "invalid count of jobs '%s'\n", argv[i]);
+				return false;
+			}
+			options.jobs = (int)jobs;
+		} else if (argv[i][0] != '-' && options.source == NULL) {
+			options.source = argv[i];
+		} else {
+			fprintf(stderr, "unknown option '%s'\n", argv[i]);
+			return false;
+		}
+	}
+
+	/* Batch and server write their outputs to files or clients, they do not run the programs nor measure single compilation */
+	if (options.batch != NULL && options.server != NULL) {
+		fprintf(stderr, "--batch can not be combined with --server\n");
+		return false;
+	}
+	if ((options.batch != NULL || options.server != NULL)
+	    && (options.source != NULL || options.run || options.stats != STATS_NONE || options.metrics != STATS_NONE)) {
+		fprintf(stderr, "%s can not be combined with a source file, --run, --stats or --emit-metrics\n",
+		        options.batch != NULL ? "--batch" : "--server");
+		return false;
+	}
+
+	/* Streaming prints functions as they are generated, the whole program is never kept in memory */
+	if (options.stream && (options.run || options.cache != NULL || options.batch != NULL || options.server != NULL)) {
+		fprintf(stderr, "--stream can not be combined with --run, --cache, --batch or --server\n");
+		return false;
+	}
+
+	/* Metrics are computed from the whole generated program */
+	if (options.metrics != STATS_NONE && (options.cache != NULL || options.stream)) {
+		fprintf(stderr, "--emit-metrics can not be combined with --cache or --stream\n");
+		return false;
+	}
+
+	/* Source positions describe printed IFJcode24, the cache keeps code without them */
+	if ((options.line_table != NULL || options.line_comments)
+	    && (options.run || options.cache != NULL || options.batch != NULL || options.server != NULL)) {
+		fprintf(stderr, "--line-table and --line-comments can not be combined with --run, --cache, --batch or --server\n");
+		return false;
+	}
+
+	return true;
+}
+
+void print_usage(const char *program) {
+	fprintf(stderr, "usage: %s [-O0|-O1] [--run] [--no-jit] [--stats[=json]] [--emit-metrics[=json]] [--cache dir | --stream] [--lexer-thread]\n"
+	        "       [--line-table file] [--line-comments] [program.zig] < input\n", program);
+	fprintf(stderr, "       %s [-O0|-O1] --batch list [-j N]\n", program);
+	fprintf(stderr, "       %s [-O0|-O1] --server socket [-j N]\n", program);
+	fprintf(stderr, "  -O0    disable optimizations of the generated code\n");
+	fprintf(stderr, "  -O1    enable loop rotation and other local optimizations (default)\n");
+	fprintf(stderr, "  --run  execute the program in the built-in interpreter instead of printing IFJcode24\n");
+	fprintf(stderr, "  --no-jit  interpret all code, hot code is compiled to native code by default on x86-64\n");
+	fprintf(stderr, "  --stats[=text|json]  print time, allocations and counts of compiler phases to stderr\n");
+	fprintf(stderr, "  --emit-metrics[=text|json]  print instructions by opcode and estimated data stack depth\n");
+	fprintf(stderr, "                              of every generated function to stderr\n");
+	fprintf(stderr, "  --cache dir  reuse IFJcode24 of unchanged programs compiled by this build from dir\n");
+	fprintf(stderr, "  --cache-size N  remove least recently used entries above N MiB (default %d)\n", CACHE_DEFAULT_SIZE);
+	fprintf(stderr, "  --stream  generate and free every function as soon as it is parsed, memory depends on\n");
+	fprintf(stderr, "            the largest function instead of the whole program\n");
+	fprintf(stderr, "  --lexer-thread  scan the source code on its own thread, tokens are passed to the parser\n");
+	fprintf(stderr, "                  through a lock-free ring\n");
+	fprintf(stderr, "  --line-table file  write line of IFJcode24, source row and column of every instruction to file\n");
+	fprintf(stderr, "  --line-comments  print source row and column as # comments before the instructions\n");
+	fprintf(stderr, "  --batch list  compile every file listed on a line of list, program of file.zig is written\n");
+	fprintf(stderr, "                to file.code and exit code of its compilation to file.rc\n");
+	fprintf(stderr, "  --server socket  compile programs sent to Unix socket until SIGINT or SIGTERM, a client writes\n");
+	fprintf(stderr, "                source code and shuts down writing, it reads the exit code on a line and IFJcode24\n");
+	fprintf(stderr, "  -j, --jobs N  worker threads of --batch and --server, count of processors by default\n");
+	fprintf(stderr, "source code is read from program.zig, or from stdin when no file is given\n");
+}
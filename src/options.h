@@ -0,0 +1,58 @@
+/** 
+ * Název projektu: Implementace překladače imperativního jazyka IFJ24.
+ * 
+ * @file options.h
+ */
+#ifndef OPTIONS_H
+#define OPTIONS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Optimization levels of the generated code */
+typedef enum opt_level {
+	OPT_NONE = 0,	/* -O0 straightforward translation of the AST */
+	OPT_BASIC = 1	/* -O1 loop rotation and other local optimizations (default) */
+} opt_level;
+
+/* Output format of compiler statistics */
+typedef enum stats_format {
+	STATS_NONE = 0,	/* statistics are not collected */
+	STATS_TEXT,		/* --stats table for humans */
+	STATS_JSON		/* --stats=json single JSON object for CI */
+} stats_format;
+
+/* Command line options of the compiler */
+typedef struct options {
+	opt_level optimization;	/* Optimization level of the generated code */
+	bool run;				/* Execute the program instead of printing IFJcode24 */
+	bool jit;				/* Compile hot code of the interpreter to native code */
+	bool stream;			/* Generate and free every function as soon as it is parsed */
+	bool lexer_thread;		/* Scan the source code on its own thread ahead of the parser */
+	stats_format stats;		/* Report time and memory of compiler phases to stderr */
+	stats_format metrics;	/* Report static metrics of the generated code to stderr */
+	const char *source;		/* Path to the source code, NULL for stdin */
+	const char *batch;		/* Path to list of source files compiled by --batch, NULL for single compilation */
+	const char *server;		/* Path to Unix socket of --server, NULL when the compiler does not serve */
+	const char *cache;		/* Directory of cached compilations, NULL without cache */
+	const char *line_table;	/* Path of the table mapping lines of IFJcode24 to the source code, NULL without it */
+	bool line_comments;		/* Print source positions as comments of IFJcode24 */
+	size_t cache_size;		/* Size limit of the cache directory in MiB */
+	int jobs;				/* Worker threads of --batch and --server, 0 for count of processors */
+} options_t;
+
+/* Shared global compiler options */
+extern options_t options;
+
+/**
+ * Parses command line arguments into global options
+ * \param argc argument count
+ * \param argv argument vector
+ * \return True: Success, False: Unknown or invalid option
+ */
+bool parse_options(int argc, char **argv);
+
+/* prints command line usage */
+void print_usage(const char *program);
+
+#endif
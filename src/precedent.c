@@ -10,6 +10,7 @@
 #include <string.h>
 #include <ctype.h>
 
+#include "compiler.h"
 #include "compiler_error.h"
 
 #include "precedent.h"
@@ -17,6 +18,7 @@
 #include "token.h"
 #include "binary_tree.h"
 #include "syna.h"
+#include "stats.h"
 
 #define PT_SIZE 7
 
@@ -26,13 +28,6 @@
 #define PUSH_SYMBOL(symbol_id) push(&sym_stack, (symbol) {.id = symbol_id, .token = {.id = TOKEN_DEFAULT, .lexeme = {.array = NULL}}, .type = NON_OPERAND})
 
 bool precedence_debug = false;
-int relative_op_count = 0;
-
-struct TScope current_symtable_scope;
-
-TData retrieved_data;
-
-TSymtable* identifier_residence;
 
 /* Simple term precedence table
 * Priority depends on operator type and its association
@@ -124,27 +119,27 @@ symbol token_to_symbol(token_t term) {
 	/* Logic OP */
 	case TOKEN_EQUAL: 				// ==
 		symbol.id = EQ;
-		relative_op_count++;
+		ctx->relative_op_count++;
 		break;
 	case TOKEN_NOT_EQUAL: 			// !=
 		symbol.id = NEQ;
-		relative_op_count++;
+		ctx->relative_op_count++;
 		break;
 	case TOKEN_LESS: 				// <
 		symbol.id = LS;
-		relative_op_count++;
+		ctx->relative_op_count++;
 		break;
 	case TOKEN_GREATER:	 			// >
 		symbol.id = GR;
-		relative_op_count++;
+		ctx->relative_op_count++;
 		break;
 	case TOKEN_GREATER_EQUAL: 		// >=
 		symbol.id = GRE;
-		relative_op_count++;
+		ctx->relative_op_count++;
 		break;
 	case TOKEN_LESS_EQUAL: 			// <=
 		symbol.id = LSE;
-		relative_op_count++;			// I_LOGIC = 2
+		ctx->relative_op_count++;			// I_LOGIC = 2
 		break;
 
 	case TOKEN_BRACKET_ROUND_LEFT:	// (
@@ -158,17 +153,17 @@ symbol token_to_symbol(token_t term) {
 	
 	        //Checking the existance of the variable and changing it's is_used value to true
 	        
-	        if((identifier_residence = declaration_var_check(current_symtable_scope, term.lexeme.array)) == NULL){
-                    error = ERR_UNDEFINED_IDENTIFIER;
+	        if((ctx->identifier_residence = declaration_var_check(ctx->current_symtable_scope, term.lexeme.array)) == NULL){
+                    ctx->error = ERR_UNDEFINED_IDENTIFIER;
                     return symbol;
                 }
                 
-                symtable_get_data(identifier_residence, term.lexeme.array, &retrieved_data);
+                symtable_get_data(ctx->identifier_residence, term.lexeme.array, &ctx->retrieved_data);
                 
-                retrieved_data.variable.is_used = true;
+                ctx->retrieved_data.variable.is_used = true;
                 
-                if(!symtable_insert(identifier_residence, term.lexeme.array, retrieved_data)){
-                    error = ERR_COMPILER_INTERNAL;
+                if(!symtable_insert(ctx->identifier_residence, term.lexeme.array, ctx->retrieved_data)){
+                    ctx->error = ERR_COMPILER_INTERNAL;
                     return symbol;
                 }
 	
@@ -265,8 +260,8 @@ int get_node_type(int term, int select) {
 void equal(stack_t *stack, symbol next_symbol) {
 	push(stack, next_symbol);
 
-	if (error) {
-		fprintf(stderr, "error: equal precedence error");
+	if (ctx->error) {
+		fprintf(compiler_errors(), "error: equal precedence error");
 	}
 }
 
@@ -275,8 +270,8 @@ void shift(stack_t *stack, symbol next_symbol) {
 	insert_shift(stack);	// Inserts shift symbol
 	push(stack, next_symbol);	// Pushes next symbol
 
-	if (error) {
-		fprintf(stderr, "error: equal precedence error");
+	if (ctx->error) {
+		fprintf(compiler_errors(), "error: equal precedence error");
 	}
 }
 
@@ -294,6 +289,8 @@ void reduction(stack_t *stack, int expresion_length) {
 			E.node->data.nodeData.value.identifier = E.token.lexeme.array;
 		else
 			E.node->data.nodeData.value.literal = E.token.lexeme.array;
+		E.node->row = E.token.row;
+		E.node->col = E.token.col;
 
 		E.id = E_OPERAND;
 		push(stack, E);
@@ -326,24 +323,26 @@ void reduction(stack_t *stack, int expresion_length) {
 		E.node = create_node(get_node_type(op.id, OPERATOR));
 		E.node->left = E1.node;
 		E.node->right = E2.node;
+		E.node->row = op.token.row;
+		E.node->col = op.token.col;
 
 		/* If E1 or E2 is not non-term, throw syntax error */
 		if ((E1.id != E_OPERAND && E1.id != E_EXP) || (E2.id != E_OPERAND && E2.id != E_EXP)) {
-			error = ERR_SYNTAX;
+			ctx->error = ERR_SYNTAX;
 			return;
 		}
 
 		/* Operators can't be applied on string, []u8, null type  */
 /*		if ((E1.type == STRING_T || E2.type == STRING_T) || (E1.type == U8_T || E2.type == U8_T) || (E1.type == NULL_T || E2.type == NULL_T)) {
-			printf("error: invalid type used in expression!\n");
+			fprintf(compiler_messages(), "error: invalid type used in expression!\n");
 			error = ERR_TYPE_COMPATABILITY;
 			return;
 		}*/
 
 		push(stack, E);
 	} else {
-		printf("error: invalid subexpression!\n");
-		error = ERR_SYNTAX;
+		fprintf(compiler_messages(), "error: invalid subexpression!\n");
+		ctx->error = ERR_SYNTAX;
 	}
 }
 
@@ -363,9 +362,9 @@ token_t fetch_token(t_buf* token_buffer) {
 
 /* Precedent analysis core function */
 /* Checks expression in assignment, condition, return */
-TNode* precedent(t_buf* token_buffer, token_id end_marker, struct TScope cur_scope) {
-	relative_op_count = 0;
-    current_symtable_scope = cur_scope;
+static TNode* precedent_analysis(t_buf* token_buffer, token_id end_marker, struct TScope cur_scope) {
+	ctx->relative_op_count = 0;
+    ctx->current_symtable_scope = cur_scope;
 	stack_t sym_stack;
 	init_stack(&sym_stack);
 	PUSH_SYMBOL(END);
@@ -377,7 +376,7 @@ TNode* precedent(t_buf* token_buffer, token_id end_marker, struct TScope cur_sco
 	top_term = get_topmost_term(&sym_stack); // $ at the bottom of the stack
 	next_term = token_to_symbol((token = fetch_token(token_buffer))); // anything from the input
 	
-	if(error)
+	if(ctx->error)
 	    return NULL;
 
 	while (expr_solved == false) { // Repeat until $ = $ -> stack top = input term
@@ -409,16 +408,16 @@ TNode* precedent(t_buf* token_buffer, token_id end_marker, struct TScope cur_sco
 			read_enable = false; /* Will reduce until SHIFT or solved expression */
 			break;
 		case 'e':
-			printf("error: invalid expression (empty expression, operator precedence error)\n");
-			error = ERR_SYNTAX;
+			fprintf(compiler_messages(), "error: invalid expression (empty expression, operator precedence error)\n");
+			ctx->error = ERR_SYNTAX;
 			break;
 		default:
-			printf("error: invalid expression (precedence unexpected error)\n");
-			error = ERR_COMPILER_INTERNAL;
+			fprintf(compiler_messages(), "error: invalid expression (precedence unexpected error)\n");
+			ctx->error = ERR_COMPILER_INTERNAL;
 			break;
 		}
 
-		if (error) // Error occured
+		if (ctx->error) // Error occured
 			break;
 
 		top_term = get_topmost_term(&sym_stack);
@@ -426,13 +425,13 @@ TNode* precedent(t_buf* token_buffer, token_id end_marker, struct TScope cur_sco
 		if (read_enable) {
 			next_term = token_to_symbol((token = fetch_token(token_buffer)));
 			
-			if (relative_op_count > 1) {
-				printf("error: too many relative operators\n");
-				error = ERR_SYNTAX;
+			if (ctx->relative_op_count > 1) {
+				fprintf(compiler_messages(), "error: too many relative operators\n");
+				ctx->error = ERR_SYNTAX;
 			}
 		}
 			
-		if (error) {
+		if (ctx->error) {
 			break;
 		}
 
@@ -441,8 +440,8 @@ TNode* precedent(t_buf* token_buffer, token_id end_marker, struct TScope cur_sco
 	}
 
 
-	if (error) {
-		printf(RED("error")": Expression syntax error\n");
+	if (ctx->error) {
+		fprintf(compiler_messages(), RED("error")": Expression syntax error\n");
 		return NULL;
 	}
 
@@ -460,13 +459,21 @@ TNode* precedent(t_buf* token_buffer, token_id end_marker, struct TScope cur_sco
 
 	/* Expression can be solved, but can still be incorrect with missing end marker */
 	if (token.id != end_marker) {
-		printf(RED("error")": missing semicolon or parenthesis at the end of expression!\n");
-		error = ERR_SYNTAX;
+		fprintf(compiler_messages(), RED("error")": missing semicolon or parenthesis at the end of expression!\n");
+		ctx->error = ERR_SYNTAX;
 	}
 
 	return expression_root;
 }
 
+/* Precedence analysis measured by --stats */
+TNode* precedent(t_buf* token_buffer, token_id end_marker, struct TScope cur_scope) {
+	stats_enter(STATS_PRECEDENCE);
+	TNode *expression_root = precedent_analysis(token_buffer, end_marker, cur_scope);
+	stats_leave();
+	return expression_root;
+}
+
 
 // Symbol stack functions
 /**
@@ -511,8 +518,8 @@ void push(struct stack *s, symbol symbol) {
 			//print_stack_state(s);
 		}
 	} else {
-		fprintf(stderr, "error: stack item allocation has failed!\n");
-		error = ERR_COMPILER_INTERNAL;
+		fprintf(compiler_errors(), "error: stack item allocation has failed!\n");
+		ctx->error = ERR_COMPILER_INTERNAL;
 	}
 }
 
@@ -541,9 +548,9 @@ symbol pop(struct stack *s) {
 	}
 
 	/* Trying to pop from an empty stack, throws error */
-	fprintf(stderr, "error: trying to pop an empty stack!\n");
+	fprintf(compiler_errors(), "error: trying to pop an empty stack!\n");
 	symbol.id = ERROR;
-	error = ERR_COMPILER_INTERNAL;
+	ctx->error = ERR_COMPILER_INTERNAL;
 	return symbol;
 }
 
@@ -572,8 +579,8 @@ symbol get_topmost_term(struct stack *s) {
 	}
 
 	if (sym.id == ERROR) {
-		fprintf(stderr, "error: There is no terminal in this stack!\n");
-		error = ERR_COMPILER_INTERNAL;
+		fprintf(compiler_errors(), "error: There is no terminal in this stack!\n");
+		ctx->error = ERR_COMPILER_INTERNAL;
 	}
 
 	if (debug_mode) {
@@ -604,7 +611,7 @@ int reduction_count(struct stack *s) {
 	}
 
 	if (count != 1 && count != 3) {
-		fprintf(stderr, "error: Expression error, invalid count of symbols to reduce!\n");
+		fprintf(compiler_errors(), "error: Expression error, invalid count of symbols to reduce!\n");
 		return -1;
 	}
 
@@ -632,8 +639,8 @@ void insert_shift(struct stack *s) {
 			s->top->next = item;       //T <-- '<' <-- E
 		} else {
 			/* malloc error */
-			fprintf(stderr, "error: stack item allocation has failed in insert_shift!\n");
-			error = ERR_COMPILER_INTERNAL;
+			fprintf(compiler_errors(), "error: stack item allocation has failed in insert_shift!\n");
+			ctx->error = ERR_COMPILER_INTERNAL;
 		}
 	} else push(s, shift);// If top item is terminal
 }
@@ -0,0 +1,160 @@
+/**
+ * Název projektu: Implementace překladače imperativního jazyka IFJ24.
+ *
+ * @file rope.c
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "rope.h"
+
+// Shorter concatenations of flat strings are copied instead of creating a node
+#define ROPE_FLAT_LIMIT 64
+
+rope* rope_take(char* buffer, size_t length){
+    rope* string = malloc(sizeof(rope));
+    if(string == NULL){
+        free(buffer);
+        return NULL;
+    }
+    string->refs = 1;
+    string->length = length;
+    string->capacity = length + 1;
+    string->data = buffer;
+    string->left = NULL;
+    string->right = NULL;
+    return string;
+}
+
+rope* rope_new(const char* string, size_t length){
+    char* buffer = malloc(length + 1);
+    if(buffer == NULL){
+        return NULL;
+    }
+    memcpy(buffer, string, length);
+    buffer[length] = '\0';
+    return rope_take(buffer, length);
+}
+
+rope* rope_concat(rope* left, rope* right){
+    if(right->length == 0){
+        return rope_retain(left);
+    }
+    if(left->length == 0){
+        return rope_retain(right);
+    }
+    size_t length = left->length + right->length;
+    if(length < ROPE_FLAT_LIMIT && left->data != NULL && right->data != NULL){
+        char* buffer = malloc(length + 1);
+        if(buffer == NULL){
+            return NULL;
+        }
+        memcpy(buffer, left->data, left->length);
+        memcpy(buffer + left->length, right->data, right->length + 1);
+        return rope_take(buffer, length);
+    }
+    rope* node = malloc(sizeof(rope));
+    if(node == NULL){
+        return NULL;
+    }
+    node->refs = 1;
+    node->length = length;
+    node->capacity = 0;
+    node->data = NULL;
+    node->left = rope_retain(left);
+    node->right = rope_retain(right);
+    return node;
+}
+
+const char* rope_flatten(rope* string){
+    if(string->data != NULL){
+        return string->data;
+    }
+    char* buffer = malloc(string->length + 1);
+    // Parts waiting to be copied, deep ropes are traversed without recursion
+    size_t capacity = 16, count = 0;
+    rope** pending = malloc(sizeof(rope*) * capacity);
+    if(buffer == NULL || pending == NULL){
+        free(buffer);
+        free(pending);
+        return NULL;
+    }
+    size_t position = 0;
+    pending[count++] = string;
+    while(count > 0){
+        rope* part = pending[--count];
+        if(part->data != NULL){
+            memcpy(buffer + position, part->data, part->length);
+            position += part->length;
+            continue;
+        }
+        if(count + 2 > capacity){
+            rope** grown = realloc(pending, sizeof(rope*) * capacity * 2);
+            if(grown == NULL){
+                free(buffer);
+                free(pending);
+                return NULL;
+            }
+            pending = grown;
+            capacity *= 2;
+        }
+        pending[count++] = part->right;
+        pending[count++] = part->left;
+    }
+    free(pending);
+    buffer[position] = '\0';
+    rope_release(string->left);
+    rope_release(string->right);
+    string->left = NULL;
+    string->right = NULL;
+    string->data = buffer;
+    string->capacity = string->length + 1;
+    return buffer;
+}
+
+bool rope_append(rope* string, rope* suffix){
+    if(rope_flatten(string) == NULL || rope_flatten(suffix) == NULL){
+        return false;
+    }
+    size_t length = string->length + suffix->length;
+    if(length + 1 > string->capacity){
+        size_t capacity = string->capacity * 2 > length + 1 ? string->capacity * 2 : length + 1;
+        char* data = realloc(string->data, capacity);
+        if(data == NULL){
+            return false;
+        }
+        string->data = data;
+        string->capacity = capacity;
+    }
+    // Suffix can be the string itself
+    memcpy(string->data + string->length, suffix->data, suffix->length);
+    string->length = length;
+    string->data[length] = '\0';
+    return true;
+}
+
+void rope_release(rope* string){
+    // Freed concatenation nodes linked through left, their right parts are released afterwards
+    rope* freed = NULL;
+    while(true){
+        if(string != NULL && --string->refs == 0){
+            if(string->data == NULL){
+                rope* left = string->left;
+                string->left = freed;
+                freed = string;
+                string = left;
+                continue;
+            }
+            free(string->data);
+            free(string);
+        }
+        if(freed == NULL){
+            return;
+        }
+        rope* node = freed;
+        freed = node->left;
+        string = node->right;
+        free(node);
+    }
+}
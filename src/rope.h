@@ -0,0 +1,77 @@
+/**
+ * Název projektu: Implementace překladače imperativního jazyka IFJ24.
+ *
+ * @file rope.h
+ */
+
+#ifndef ROPE_H
+#define ROPE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/*
+ * Immutable reference counted string of the interpreter.
+ * Concatenation creates a node referencing both parts, the node is flattened to one buffer
+ * the first time its characters are needed. String with a single reference can be appended in place.
+ */
+typedef struct rope{
+    size_t refs;
+    size_t length;
+    size_t capacity;    // Size of data buffer
+    char* data;         // NUL terminated characters | NULL for not yet flattened concatenation
+    struct rope* left;  // Parts of concatenation
+    struct rope* right;
+} rope;
+
+/**
+ * Creates flat string from copy of characters
+ * \param string
+ * \param length
+ * \return string with one reference | NULL in case of a memory allocation error
+ */
+rope* rope_new(const char* string, size_t length);
+
+/**
+ * Creates flat string owning the buffer
+ * \param buffer allocated NUL terminated string, freed in case of an error
+ * \param length
+ * \return string with one reference | NULL in case of a memory allocation error
+ */
+rope* rope_take(char* buffer, size_t length);
+
+/**
+ * Concatenation of two strings, the result references both strings
+ * \param left
+ * \param right
+ * \return string with one reference | NULL in case of a memory allocation error
+ */
+rope* rope_concat(rope* left, rope* right);
+
+/**
+ * Appends string to the end of string with a single reference
+ * \param string
+ * \param suffix
+ * \return success
+ */
+bool rope_append(rope* string, rope* suffix);
+
+/**
+ * Flattens string to a single buffer
+ * \param string
+ * \return NUL terminated characters | NULL in case of a memory allocation error
+ */
+const char* rope_flatten(rope* string);
+
+static inline rope* rope_retain(rope* string){
+    string->refs++;
+    return string;
+}
+
+/**
+ * Drops reference, the string is freed with its parts when it was the last one
+ * \param string
+ */
+void rope_release(rope* string);
+
+#endif
@@ -12,18 +12,17 @@
 #include <stdio.h>
 
 #include "semantic.h"
+#include "compiler.h"
 #include "compiler_error.h"
 #include "binary_tree.h"
 #include "symtable.h"
 #include "syna.h"
 #include "codegen.h"
+#include "stats.h"
 
 /* Utility macros */
-#define check_error() do { if (error) return; } while (0)
+#define check_error() do { if (ctx->error) return; } while (0)
 
-/* Global variables */
-bool hasReturn = false;
-TSymtable *globalSymTable;
 
 /* Functions for Semantic Analysis on assembled Abstract Syntax Tree  */
 
@@ -32,8 +31,8 @@ void semantic_analysis(TBinaryTree* AST) {
     check_error();
 
     if (AST->root == NULL) {
-        printf(RED_BOLD("error")": AST is NULL\n");
-        error = ERR_COMPILER_INTERNAL;
+        fprintf(compiler_messages(), RED_BOLD("error")": AST is NULL\n");
+        ctx->error = ERR_COMPILER_INTERNAL;
         return;
     }
 
@@ -42,9 +41,9 @@ void semantic_analysis(TBinaryTree* AST) {
     //BT_print_tree(*program); // debug print of the AST before semantic checks
 
     /* Get global symtable from Program/Root Node */
-    globalSymTable = (*program)->data.nodeData.program.globalSymTable;
+    ctx->globalSymTable = (*program)->data.nodeData.program.globalSymTable;
 
-    main_function_semantics(globalSymTable);
+    main_function_semantics(ctx->globalSymTable);
     check_error();
 
     /* Check functions with semantic rules */
@@ -56,12 +55,14 @@ void semantic_analysis(TBinaryTree* AST) {
         FunctionSemantics(func);
         check_error();
 
-        hasReturn = false; //set hasReturn to false for next function
+        ctx->hasReturn = false; //set hasReturn to false for next function
         func = func->left;
     }
     //BT_print_tree(*program); // Final tree passed to code generator
     //debug_print_keys((*program)->data.nodeData.program.globalSymTable);
+    stats_enter(STATS_CODEGEN);
     codegen(AST);
+    stats_leave();
     check_error();
 }
 
@@ -78,8 +79,8 @@ void FunctionSemantics(TNode* func) {
     check_error();
 
     /* Check return statement missing if its not void function */
-    if (hasReturn == false && func->data.nodeData.function.type != VOID_TYPE) {
-        error = ERR_RETURN_VALUE_EXPRESSION;
+    if (ctx->hasReturn == false && func->data.nodeData.function.type != VOID_TYPE) {
+        ctx->error = ERR_RETURN_VALUE_EXPRESSION;
         return;
     }
 }
@@ -94,8 +95,8 @@ void CommandSemantics(TNode* Command, scope_t* current_scope, TNode* func) {
         TNode* command_instance = Command->left; // Get real command from the wrapper
 
         if (command_instance == NULL) {
-            printf(RED_BOLD("error")": Empty command in semantic analysis\n");
-            error = ERR_COMPILER_INTERNAL;
+            fprintf(compiler_messages(), RED_BOLD("error")": Empty command in semantic analysis\n");
+            ctx->error = ERR_COMPILER_INTERNAL;
             return;
         }
 
@@ -139,8 +140,8 @@ void CommandSemantics(TNode* Command, scope_t* current_scope, TNode* func) {
             check_error();
 
             if (info.type != VOID_T) { // If the functions return type is NOT void, the return value cannot be ignored.
-                printf("error: function return value ignored, all non-void values must be used\n");
-                error = ERR_PARAM_TYPE_RETURN_VAL;
+                fprintf(compiler_messages(), "error: function return value ignored, all non-void values must be used\n");
+                ctx->error = ERR_PARAM_TYPE_RETURN_VAL;
                 return;
             }
             break;
@@ -150,7 +151,7 @@ void CommandSemantics(TNode* Command, scope_t* current_scope, TNode* func) {
             TNode *expression = command_instance->left; // Get expression from left child-node of the command
             /* Checks if the expression in a return statement is missing or is there an extra expression when the function has void return type */
             if ( (expression == NULL && func->data.nodeData.function.type != VOID_TYPE) || (expression != NULL && func->data.nodeData.function.type == VOID_TYPE) ) {
-                error = ERR_RETURN_VALUE_EXPRESSION;
+                ctx->error = ERR_RETURN_VALUE_EXPRESSION;
                 return;
             }
 
@@ -160,17 +161,17 @@ void CommandSemantics(TNode* Command, scope_t* current_scope, TNode* func) {
                 check_error();
 
                 if (expression) {
-                    int function_return_type = get_func_type(globalSymTable, func->data.nodeData.function.identifier);
+                    int function_return_type = get_func_type(ctx->globalSymTable, func->data.nodeData.function.identifier);
                     check_error();
 
                     if (expr_data.type != function_return_type) {
-                        error = ERR_PARAM_TYPE_RETURN_VAL;
+                        ctx->error = ERR_PARAM_TYPE_RETURN_VAL;
                         return;
                     }
                 }
             }
 
-            hasReturn = true; // Set the flag to true, since the function has atleast one return statement/command
+            ctx->hasReturn = true; // Set the flag to true, since the function has atleast one return statement/command
             break;
         }
 
@@ -182,7 +183,7 @@ void CommandSemantics(TNode* Command, scope_t* current_scope, TNode* func) {
     }
     /* Scope ends here  */
     if (!check_is_used(current_scope->current_scope)) { // Check if every const is used, var used and mutated
-        error = ERR_UNUSED_VAR;
+        ctx->error = ERR_UNUSED_VAR;
         return;
     }
     //printf("------------\n"); debug_print_keys(current_scope->current_scope); // debug print of current scopes variables stored in symtable and their properties
@@ -203,7 +204,7 @@ void check_head_type(TNode* body, scope_t *scope) {
 
     if ( body->data.nodeData.body.is_nullable ) {
         if ( !expr_data.is_optional_null ) { // variable is not correct type
-            error = ERR_TYPE_COMPATABILITY;
+            ctx->error = ERR_TYPE_COMPATABILITY;
             return;
         } else { // if (id) |ID| --> update ID datatype with non-null ids datatype
             //printf("%s",expr_data.optional_null_id);
@@ -213,35 +214,35 @@ void check_head_type(TNode* body, scope_t *scope) {
 
             /* get variable data in condition */
             if (id_defined(scope, variable_id, &local) == false) {
-                printf("error: var/const %s in condition undefined\n", variable_id);
-                error = ERR_UNDEFINED_IDENTIFIER;
+                fprintf(compiler_messages(), "error: var/const %s in condition undefined\n", variable_id);
+                ctx->error = ERR_UNDEFINED_IDENTIFIER;
                 return;
             }
             if (symtable_get_data(local, variable_id, &null_var_data) == false) {
-                error = ERR_COMPILER_INTERNAL;
+                ctx->error = ERR_COMPILER_INTERNAL;
                 return;
             }/* |not_null_variable| data*/
             if (id_defined(scope, not_null_id, &local) == false) {
-                printf("error: not_null variable undefined\n");
-                error = ERR_UNDEFINED_IDENTIFIER;
+                fprintf(compiler_messages(), "error: not_null variable undefined\n");
+                ctx->error = ERR_UNDEFINED_IDENTIFIER;
                 return;
             }
             if (symtable_get_data(local, not_null_id, &not_null_inheritor_data) == false) {
-                error = ERR_COMPILER_INTERNAL;
+                ctx->error = ERR_COMPILER_INTERNAL;
                 return;
             }
             /* Assign inherited datatype without null */
             not_null_inheritor_data.variable.type = null_var_data.variable.type;
             /* Update data about not_null constant */
             if (symtable_insert(local, not_null_id, not_null_inheritor_data) == false) {
-                error = ERR_COMPILER_INTERNAL;
+                ctx->error = ERR_COMPILER_INTERNAL;
                 return;
             }
         }
     } else { /* Condition is not optional null AND expression must be of truth expression type else its error */
         if ( expr_data.type != BOOL_T ) {
-            error = ERR_TYPE_COMPATABILITY;
-            printf("error: trying to put non-truth expression in condition statement\n");
+            ctx->error = ERR_TYPE_COMPATABILITY;
+            fprintf(compiler_messages(), "error: trying to put non-truth expression in condition statement\n");
             return;
         }
     }
@@ -256,23 +257,23 @@ void FunctionCallSemantics(TNode *functionCall, scope_t* current_scope, fun_info
     TNode *formal_param = functionCall->right; // Right pointer for some unknown reason
 
     /* Check if function is defined */
-    if (symtable_search(globalSymTable, function_id) == false) {
-        printf("error: function %s undefined\n", function_id);
-        error = ERR_UNDEFINED_IDENTIFIER;
+    if (symtable_search(ctx->globalSymTable, function_id) == false) {
+        fprintf(compiler_messages(), "error: function %s undefined\n", function_id);
+        ctx->error = ERR_UNDEFINED_IDENTIFIER;
         return;
     }
 
     /* Get functions metadata */
-    if (symtable_get_data(globalSymTable, function_id, &function_data) == false) {
-        error = ERR_COMPILER_INTERNAL;
+    if (symtable_get_data(ctx->globalSymTable, function_id, &function_data) == false) {
+        ctx->error = ERR_COMPILER_INTERNAL;
         return;
     }
 
     /** Check function call *formal* parameter(s) (count, type) **/
     /* Check function call *formal* parameters count */
     if (function_data.function.argument_types.length != formal_param_count(formal_param)) {
-        printf("error: invalid function call parameter count\n");
-        error = ERR_PARAM_TYPE_RETURN_VAL;
+        fprintf(compiler_messages(), "error: invalid function call parameter count\n");
+        ctx->error = ERR_PARAM_TYPE_RETURN_VAL;
         return;
     }
 
@@ -290,13 +291,13 @@ void FunctionCallSemantics(TNode *functionCall, scope_t* current_scope, fun_info
             TSymtable* local = NULL; // Local symtable where variable 'id' might be defined
 
             if (id_defined(current_scope, variable_id, &local) == false) {
-                printf("error: formal parameter %s undefined\n", variable_id);
-                error = ERR_UNDEFINED_IDENTIFIER;
+                fprintf(compiler_messages(), "error: formal parameter %s undefined\n", variable_id);
+                ctx->error = ERR_UNDEFINED_IDENTIFIER;
                 break;
             }
 
             if (symtable_get_data(local, variable_id, &var_data) == false) {
-                error = ERR_COMPILER_INTERNAL;
+                ctx->error = ERR_COMPILER_INTERNAL;
                 break;
             }
 
@@ -311,10 +312,10 @@ void FunctionCallSemantics(TNode *functionCall, scope_t* current_scope, fun_info
             /* Formal and real params may differentiate, however if its built-in function, it may accept all parameter types - 'a' (ifj.write())
             or it may accept string or []u8 slice - 'n' (ifj.string()) where its neccesary to check if the formal params are of type string or []u8 slice */
             if (real_param[param_position] != 'a' && (real_param[param_position] != 'n' || (formal_param_type != 'u' && formal_param_type != 's'))) {
-                printf("%s - ", function_id);
-                printf("[%c - %c]", formal_param_type, real_param[param_position]);
-                printf("error: formal parameter type doesn't match function definition parameter type\n");
-                error = ERR_PARAM_TYPE_RETURN_VAL;
+                fprintf(compiler_messages(), "%s - ", function_id);
+                fprintf(compiler_messages(), "[%c - %c]", formal_param_type, real_param[param_position]);
+                fprintf(compiler_messages(), "error: formal parameter type doesn't match function definition parameter type\n");
+                ctx->error = ERR_PARAM_TYPE_RETURN_VAL;
                 break;
             }
         }
@@ -350,8 +351,8 @@ void assig_check(TNode* command_instance, scope_t *scope) {
         char* function_id = function->data.nodeData.identifier.identifier;
 
         /* Get functions metadata */
-        if (symtable_get_data(globalSymTable, function_id, &function_data) == false) {
-            error = ERR_COMPILER_INTERNAL;
+        if (symtable_get_data(ctx->globalSymTable, function_id, &function_data) == false) {
+            ctx->error = ERR_COMPILER_INTERNAL;
             return;
         }
 
@@ -361,19 +362,19 @@ void assig_check(TNode* command_instance, scope_t *scope) {
 
         if (throw_away) { // function call is assigned to "_" special variable, so the type check can be skipped
             if ( function_data.function.return_type == VOID_T ) {
-                printf("error: trying to assign void type\n");
-                error = ERR_PARAM_TYPE_RETURN_VAL;
+                fprintf(compiler_messages(), "error: trying to assign void type\n");
+                ctx->error = ERR_PARAM_TYPE_RETURN_VAL;
                 return;
             }
         } else {
             if ((int) var_data.variable.type != info.type) { // types dont match
-                error = ERR_TYPE_COMPATABILITY;
-                printf("error: assignment type mismatch caused by function %s\n", function_id);
+                ctx->error = ERR_TYPE_COMPATABILITY;
+                fprintf(compiler_messages(), "error: assignment type mismatch caused by function %s\n", function_id);
                 return;
             } else {
                 if ((var_data.variable.is_null_type == false) && info.is_optional_null) { // types can be the same but differ in null includement
-                    error = ERR_TYPE_COMPATABILITY;
-                    printf("error: trying to assign optional-null type into non-null variable, type mismatch caused by function %s\n", function_id);
+                    ctx->error = ERR_TYPE_COMPATABILITY;
+                    fprintf(compiler_messages(), "error: trying to assign optional-null type into non-null variable, type mismatch caused by function %s\n", function_id);
                     return;
                 }
             }
@@ -388,14 +389,14 @@ void assig_check(TNode* command_instance, scope_t *scope) {
         if (throw_away == false) {
             if ((int) var_data.variable.type != expr_data.type) { // type of a != b
                 if ((var_data.variable.is_null_type == false) || (expr_data.type != NIL_T)) { // only acceptable if a is ?type and b is null, else error
-                    error = ERR_TYPE_COMPATABILITY;
-                    printf("error: assignment type mismatch\n");
+                    ctx->error = ERR_TYPE_COMPATABILITY;
+                    fprintf(compiler_messages(), "error: assignment type mismatch\n");
                     return;
                 }
             } else {
                 if ((var_data.variable.is_null_type == false) && expr_data.is_optional_null) { // types can be the same but differ in null includement
-                    error = ERR_TYPE_COMPATABILITY;
-                    printf("error: trying to assign optional-null type into non-null variable, type mismatch\n");
+                    ctx->error = ERR_TYPE_COMPATABILITY;
+                    fprintf(compiler_messages(), "error: trying to assign optional-null type into non-null variable, type mismatch\n");
                     return;
                 }
             }
@@ -409,22 +410,22 @@ void assig_check(TNode* command_instance, scope_t *scope) {
 void main_function_semantics(TSymtable* globalSymTable) {
     /* Check existence of main function */
     if (symtable_search(globalSymTable, "main") == false) {
-        printf("error: main function undeclared\n");
-        error = ERR_UNDEFINED_IDENTIFIER;
+        fprintf(compiler_messages(), "error: main function undeclared\n");
+        ctx->error = ERR_UNDEFINED_IDENTIFIER;
         return;
     }
 
     TData function_data;
     /* Get main function metadata */
     if (symtable_get_data(globalSymTable, "main", &function_data) == false) {
-        error = ERR_COMPILER_INTERNAL;
+        ctx->error = ERR_COMPILER_INTERNAL;
         return;
     }
 
     /* Check defined Parameters and Return value */
     if (function_data.function.argument_types.length != 0 || function_data.function.return_type != VOID_T) {
-        printf("error: main function cant have parameters and must return void\n");
-        error = ERR_PARAM_TYPE_RETURN_VAL;
+        fprintf(compiler_messages(), "error: main function cant have parameters and must return void\n");
+        ctx->error = ERR_PARAM_TYPE_RETURN_VAL;
         return;
     }
 }
@@ -438,7 +439,7 @@ void declaration_semantics(TNode* declaration, scope_t* current_scope) {
     int datatype = 0, is_optional_null = 0;
 
     if (symtable_get_data(current_scope->current_scope, variable_id, &var_data) == false) { // Get LHS var 'id' metadata from current symtable
-        error = ERR_COMPILER_INTERNAL;
+        ctx->error = ERR_COMPILER_INTERNAL;
         return;
     }
 
@@ -468,8 +469,8 @@ void declaration_semantics(TNode* declaration, scope_t* current_scope) {
     if (var_data.variable.type == UNKNOWN_T) { // Type was unknown (var/const without specified type)
 
         if (datatype == NIL_T || datatype == STR_T) {
-            printf("error: unknown type - type of the variable is not specified and cannot be inferred from the expression used\n");
-            error = ERR_UNKNOWN_TYPE;
+            fprintf(compiler_messages(), "error: unknown type - type of the variable is not specified and cannot be inferred from the expression used\n");
+            ctx->error = ERR_UNKNOWN_TYPE;
             return;
         }
 
@@ -478,20 +479,20 @@ void declaration_semantics(TNode* declaration, scope_t* current_scope) {
     }
 
     if (symtable_insert(current_scope->current_scope, variable_id, var_data) == false) {
-        error = ERR_COMPILER_INTERNAL;
+        ctx->error = ERR_COMPILER_INTERNAL;
         return;
     }
 
     if ((int) var_data.variable.type != datatype) { // a = b inequal types
         if ((var_data.variable.is_null_type == false) || (datatype != NIL_T)) { // only acceptable if a is ?type and b is null
-            printf("error: var/const datatype doesn't match expression/function return type\n");
-            error = ERR_TYPE_COMPATABILITY;
+            fprintf(compiler_messages(), "error: var/const datatype doesn't match expression/function return type\n");
+            ctx->error = ERR_TYPE_COMPATABILITY;
             return;
         }
     } else {
         if ((var_data.variable.is_null_type == false) && is_optional_null) {
-            printf("error: trying to assign optional-null type into non-null type\n");
-            error = ERR_TYPE_COMPATABILITY;
+            fprintf(compiler_messages(), "error: trying to assign optional-null type into non-null type\n");
+            ctx->error = ERR_TYPE_COMPATABILITY;
             return;
         }
     }
@@ -530,7 +531,7 @@ void expression_semantics(TNode *expression, scope_t* scope, expr_info* info) {
         info->type = NIL_T;
         break;
     case U8:  // INVALID LITERAL TYPE
-        error = ERR_TYPE_COMPATABILITY;
+        ctx->error = ERR_TYPE_COMPATABILITY;
         break;
     case STR: // STR LITERAL
         info->type = STR_T;
@@ -543,13 +544,13 @@ void expression_semantics(TNode *expression, scope_t* scope, expr_info* info) {
         char *variable_id = expression->data.nodeData.value.identifier;
 
         if (id_defined(scope, variable_id, &local) == false) {
-            printf("error: var/const %s undefined in this expression\n", variable_id);
-            error = ERR_UNDEFINED_IDENTIFIER;
+            fprintf(compiler_messages(), "error: var/const %s undefined in this expression\n", variable_id);
+            ctx->error = ERR_UNDEFINED_IDENTIFIER;
             break;
         }
 
         if (symtable_get_data(local, variable_id, &info->data) == false) {
-            error = ERR_COMPILER_INTERNAL;
+            ctx->error = ERR_COMPILER_INTERNAL;
             break;
         }
 
@@ -573,8 +574,8 @@ void expression_semantics(TNode *expression, scope_t* scope, expr_info* info) {
     case OP_MUL:
     {
         if (left.is_optional_null || right.is_optional_null) { // Unacceptable to have ?type in arithmetics
-            printf(RED_BOLD("error")": type mismatch, trying to use optional null type in arithmethics\n");
-            error = ERR_TYPE_COMPATABILITY;
+            fprintf(compiler_messages(), RED_BOLD("error")": type mismatch, trying to use optional null type in arithmethics\n");
+            ctx->error = ERR_TYPE_COMPATABILITY;
             return;
         }
 
@@ -603,8 +604,8 @@ void expression_semantics(TNode *expression, scope_t* scope, expr_info* info) {
                     char **literal = &expression->left->data.nodeData.value.literal;
 
                     if ((*literal = literal_convert_f64_to_i32(*literal)) == NULL) { // NULL => float has non zero decimal part, so it cannot be converted
-                        printf("error: expression - cannot do implicit conversion of f64 value (non-zero decimal part)\n");
-                        error = ERR_TYPE_COMPATABILITY;
+                        fprintf(compiler_messages(), "error: expression - cannot do implicit conversion of f64 value (non-zero decimal part)\n");
+                        ctx->error = ERR_TYPE_COMPATABILITY;
                         return;
                     }
 
@@ -615,8 +616,8 @@ void expression_semantics(TNode *expression, scope_t* scope, expr_info* info) {
                    char **literal = &expression->right->data.nodeData.value.literal;
 
                     if ((*literal = literal_convert_f64_to_i32(*literal)) == NULL) {  // NULL => float has non zero decimal part, so it cannot be converted
-                        printf("error: expression - cannot do implicit conversion of f64 value (non-zero decimal part)\n");
-                        error = ERR_TYPE_COMPATABILITY;
+                        fprintf(compiler_messages(), "error: expression - cannot do implicit conversion of f64 value (non-zero decimal part)\n");
+                        ctx->error = ERR_TYPE_COMPATABILITY;
                         return;
                     }
 
@@ -632,22 +633,22 @@ void expression_semantics(TNode *expression, scope_t* scope, expr_info* info) {
 
 
                     if (var_data.variable.is_constant == false) { // float operator is var, which cannot be implicitly converted
-                        printf("error: expression - cannot convert var in division\n");
-                        error = ERR_TYPE_COMPATABILITY;
+                        fprintf(compiler_messages(), "error: expression - cannot convert var in division\n");
+                        ctx->error = ERR_TYPE_COMPATABILITY;
                         return;
                     }
 
                     if (var_data.variable.comp_runtime == false) { // const value is unknown at the time of compilation
-                        printf("error: expression - cannot convert const in division (constant value is unknown at compile time)\n");
-                        error = ERR_TYPE_COMPATABILITY;
+                        fprintf(compiler_messages(), "error: expression - cannot convert const in division (constant value is unknown at compile time)\n");
+                        ctx->error = ERR_TYPE_COMPATABILITY;
                         return;
                     }
 
                     char *const_value = copy_literal(var_data.variable.value_pointer->data.nodeData.value.literal); // Extract the literal to be converted
 
                     if ((const_value = literal_convert_f64_to_i32(const_value)) == NULL) {
-                        printf("error: expression - cannot do implicit conversion of f64 value (non-zero decimal part)\n");
-                        error = ERR_TYPE_COMPATABILITY;
+                        fprintf(compiler_messages(), "error: expression - cannot do implicit conversion of f64 value (non-zero decimal part)\n");
+                        ctx->error = ERR_TYPE_COMPATABILITY;
                         return;
                     }
 
@@ -663,22 +664,22 @@ void expression_semantics(TNode *expression, scope_t* scope, expr_info* info) {
                     check_error();
 
                     if (var_data.variable.is_constant == false) {
-                        printf("error: expression - cannot convert var in division\n");
-                        error = ERR_TYPE_COMPATABILITY;
+                        fprintf(compiler_messages(), "error: expression - cannot convert var in division\n");
+                        ctx->error = ERR_TYPE_COMPATABILITY;
                         return;
                     }
 
                     if (var_data.variable.comp_runtime == false) {
-                        printf("error: expression - cannot convert const in division (constant value is unknown at compile time)\n");
-                        error = ERR_TYPE_COMPATABILITY;
+                        fprintf(compiler_messages(), "error: expression - cannot convert const in division (constant value is unknown at compile time)\n");
+                        ctx->error = ERR_TYPE_COMPATABILITY;
                         return;
                     }
 
                     char *const_value = copy_literal(var_data.variable.value_pointer->data.nodeData.value.literal);
 
                     if ((const_value = literal_convert_f64_to_i32(const_value)) == NULL) {
-                        printf("error: expression - cannot do implicit conversion of f64 value (non-zero decimal part)\n");
-                        error = ERR_TYPE_COMPATABILITY;
+                        fprintf(compiler_messages(), "error: expression - cannot do implicit conversion of f64 value (non-zero decimal part)\n");
+                        ctx->error = ERR_TYPE_COMPATABILITY;
                         return;
                     }
 
@@ -687,18 +688,18 @@ void expression_semantics(TNode *expression, scope_t* scope, expr_info* info) {
                     info->type = INTEGER_T; // Succesful conversion of f64 const, result of binary +-* operation is integer type
                 }
                 else { // No i32 literal / f64 const expression on either side to be converted, conversion error (i32/f64 is var, expression or operation result)
-                    printf(RED_BOLD("error")": arithmetic (+ - *) expression error, cannot convert non-i32 literal\n");
-                    error = ERR_TYPE_COMPATABILITY;
+                    fprintf(compiler_messages(), RED_BOLD("error")": arithmetic (+ - *) expression error, cannot convert non-i32 literal\n");
+                    ctx->error = ERR_TYPE_COMPATABILITY;
                     return;
                 }
             } else { // var must be the same type
-                printf(RED_BOLD("error")": var type mismatch\n");
-                error = ERR_TYPE_COMPATABILITY;
+                fprintf(compiler_messages(), RED_BOLD("error")": var type mismatch\n");
+                ctx->error = ERR_TYPE_COMPATABILITY;
                 return;
             }
         } else { // invalid data types in arithmetics: UNKNOWN_T, NULL_T, STR_T
-            printf(RED_BOLD("error")": expression type mismatch\n");
-            error = ERR_TYPE_COMPATABILITY;
+            fprintf(compiler_messages(), RED_BOLD("error")": expression type mismatch\n");
+            ctx->error = ERR_TYPE_COMPATABILITY;
             return;
         }
 
@@ -712,8 +713,8 @@ void expression_semantics(TNode *expression, scope_t* scope, expr_info* info) {
     case OP_DIV:
     {
         if (left.is_optional_null || right.is_optional_null) {
-            printf(RED_BOLD("error")": type mismatch, trying to use null type in arithmethics\n");
-            error = ERR_TYPE_COMPATABILITY;
+            fprintf(compiler_messages(), RED_BOLD("error")": type mismatch, trying to use null type in arithmethics\n");
+            ctx->error = ERR_TYPE_COMPATABILITY;
             return;
         }
         if ((left.type == INTEGER_T && right.type == INTEGER_T) || ((left.type == FLOAT_T && right.type == FLOAT_T))) { // i32 = i32, f64 = f64
@@ -726,8 +727,8 @@ void expression_semantics(TNode *expression, scope_t* scope, expr_info* info) {
                     char **literal = &expression->left->data.nodeData.value.literal;
 
                     if ((*literal = literal_convert_f64_to_i32(*literal)) == NULL) { // NULL => float has non zero decimal part, so it cannot be converted
-                        printf("error: expression - cannot do implicit conversion of f64 value (non-zero decimal part)\n");
-                        error = ERR_TYPE_COMPATABILITY;
+                        fprintf(compiler_messages(), "error: expression - cannot do implicit conversion of f64 value (non-zero decimal part)\n");
+                        ctx->error = ERR_TYPE_COMPATABILITY;
                         return;
                     }
 
@@ -737,8 +738,8 @@ void expression_semantics(TNode *expression, scope_t* scope, expr_info* info) {
                     char **literal = &expression->right->data.nodeData.value.literal;
 
                     if ((*literal = literal_convert_f64_to_i32(*literal)) == NULL) {  // NULL => float has non zero decimal part, so it cannot be converted
-                        printf("error: expression - cannot do implicit conversion of f64 value (non-zero decimal part)\n");
-                        error = ERR_TYPE_COMPATABILITY;
+                        fprintf(compiler_messages(), "error: expression - cannot do implicit conversion of f64 value (non-zero decimal part)\n");
+                        ctx->error = ERR_TYPE_COMPATABILITY;
                         return;
                     }
 
@@ -753,22 +754,22 @@ void expression_semantics(TNode *expression, scope_t* scope, expr_info* info) {
 
 
                     if (var_data.variable.is_constant == false) { // float operator is var, which cannot be implicitly converted
-                        printf("error: expression - cannot convert var in division\n");
-                        error = ERR_TYPE_COMPATABILITY;
+                        fprintf(compiler_messages(), "error: expression - cannot convert var in division\n");
+                        ctx->error = ERR_TYPE_COMPATABILITY;
                         return;
                     }
 
                     if (var_data.variable.comp_runtime == false) { // const value is unknown at the time of compilation
-                        printf("error: expression - cannot convert const in division (constant value is unknown at compile time)\n");
-                        error = ERR_TYPE_COMPATABILITY;
+                        fprintf(compiler_messages(), "error: expression - cannot convert const in division (constant value is unknown at compile time)\n");
+                        ctx->error = ERR_TYPE_COMPATABILITY;
                         return;
                     }
 
                     char *const_value = copy_literal(var_data.variable.value_pointer->data.nodeData.value.literal); // Extract the literal to be converted
 
                     if ((const_value = literal_convert_f64_to_i32(const_value)) == NULL) {
-                        printf("error: expression - cannot do implicit conversion of f64 value (non-zero decimal part)\n");
-                        error = ERR_TYPE_COMPATABILITY;
+                        fprintf(compiler_messages(), "error: expression - cannot do implicit conversion of f64 value (non-zero decimal part)\n");
+                        ctx->error = ERR_TYPE_COMPATABILITY;
                         return;
                     }
 
@@ -785,22 +786,22 @@ void expression_semantics(TNode *expression, scope_t* scope, expr_info* info) {
 
 
                     if (var_data.variable.is_constant == false) {
-                        printf("error: expression - cannot convert var in division\n");
-                        error = ERR_TYPE_COMPATABILITY;
+                        fprintf(compiler_messages(), "error: expression - cannot convert var in division\n");
+                        ctx->error = ERR_TYPE_COMPATABILITY;
                         return;
                     }
 
                     if (var_data.variable.comp_runtime == false) {
-                        printf("error: expression - cannot convert const in division (constant value is unknown at compile time)\n");
-                        error = ERR_TYPE_COMPATABILITY;
+                        fprintf(compiler_messages(), "error: expression - cannot convert const in division (constant value is unknown at compile time)\n");
+                        ctx->error = ERR_TYPE_COMPATABILITY;
                         return;
                     }
 
                     char *const_value = copy_literal(var_data.variable.value_pointer->data.nodeData.value.literal);
 
                     if ((const_value = literal_convert_f64_to_i32(const_value)) == NULL) {
-                        printf("error: expression - cannot do implicit conversion of f64 value (non-zero decimal part)\n");
-                        error = ERR_TYPE_COMPATABILITY;
+                        fprintf(compiler_messages(), "error: expression - cannot do implicit conversion of f64 value (non-zero decimal part)\n");
+                        ctx->error = ERR_TYPE_COMPATABILITY;
                         return;
                     }
 
@@ -808,20 +809,20 @@ void expression_semantics(TNode *expression, scope_t* scope, expr_info* info) {
                     expression->right->data.nodeData.value.literal = const_value;
 
                 } else { // No f64 literal/const expression on either side to be converted, conversion error (f64 op is either var, expression or operation result)
-                    printf(RED_BOLD("error")": arithmetic (/) expression error, cannot convert non-f64 literal/ non-const expression \n");
-                    error = ERR_TYPE_COMPATABILITY;
+                    fprintf(compiler_messages(), RED_BOLD("error")": arithmetic (/) expression error, cannot convert non-f64 literal/ non-const expression \n");
+                    ctx->error = ERR_TYPE_COMPATABILITY;
                     return;
                 }
 
                 info->type = INTEGER_T;
             } else { // var must be the same type, this type mismatch is not acceptable
-                printf(RED_BOLD("error")": var type mismatch\n");
-                error = ERR_TYPE_COMPATABILITY;
+                fprintf(compiler_messages(), RED_BOLD("error")": var type mismatch\n");
+                ctx->error = ERR_TYPE_COMPATABILITY;
                 return;
             }
         } else { // UNKNOWN_T, NULL_T, STR_T
-            printf(RED_BOLD("error")": expression type mismatch\n");
-            error = ERR_TYPE_COMPATABILITY;
+            fprintf(compiler_messages(), RED_BOLD("error")": expression type mismatch\n");
+            ctx->error = ERR_TYPE_COMPATABILITY;
             return;
         }
 
@@ -836,14 +837,14 @@ void expression_semantics(TNode *expression, scope_t* scope, expr_info* info) {
     case OP_NEQ:
     {
         if (left.type == STR_T || right.type  == STR_T) {
-            printf("error: string in relation operators expression (==, !=)\n");
-            error = ERR_TYPE_COMPATABILITY;
+            fprintf(compiler_messages(), "error: string in relation operators expression (==, !=)\n");
+            ctx->error = ERR_TYPE_COMPATABILITY;
             return;
         }
         if (left.type != right.type) {
             if (!left.is_constant_exp && !right.is_constant_exp) { // two variables with different types => error
-                printf("error: var type mismatch in relation operators expression (==, !=)\n");
-                error = ERR_TYPE_COMPATABILITY;
+                fprintf(compiler_messages(), "error: var type mismatch in relation operators expression (==, !=)\n");
+                ctx->error = ERR_TYPE_COMPATABILITY;
                 return;
             }
 
@@ -867,14 +868,14 @@ void expression_semantics(TNode *expression, scope_t* scope, expr_info* info) {
                 check_error();
 
                 if (var_data.variable.is_constant == false) { // i32 operator is var, which cannot be implicitly converted
-                    printf("error: expression - cannot convert var in (==, !=)\n");
-                    error = ERR_TYPE_COMPATABILITY;
+                    fprintf(compiler_messages(), "error: expression - cannot convert var in (==, !=)\n");
+                    ctx->error = ERR_TYPE_COMPATABILITY;
                     return;
                 }
 
                 if (var_data.variable.comp_runtime == false) { // const value is unknown at the time of compilation
-                    printf("error: expression - cannot convert const in (==, !=) (constant value is unknown at compile time)\n");
-                    error = ERR_TYPE_COMPATABILITY;
+                    fprintf(compiler_messages(), "error: expression - cannot convert const in (==, !=) (constant value is unknown at compile time)\n");
+                    ctx->error = ERR_TYPE_COMPATABILITY;
                     return;
                 }
 
@@ -893,14 +894,14 @@ void expression_semantics(TNode *expression, scope_t* scope, expr_info* info) {
                 check_error();
 
                 if (var_data.variable.is_constant == false) { // i32 operator is var, which cannot be implicitly converted
-                    printf("error: expression - cannot convert var in (==, !=)\n");
-                    error = ERR_TYPE_COMPATABILITY;
+                    fprintf(compiler_messages(), "error: expression - cannot convert var in (==, !=)\n");
+                    ctx->error = ERR_TYPE_COMPATABILITY;
                     return;
                 }
 
                 if (var_data.variable.comp_runtime == false) { // const value is unknown at the time of compilation
-                    printf("error: expression - cannot convert const in (==, !=) (constant value is unknown at compile time)\n");
-                    error = ERR_TYPE_COMPATABILITY;
+                    fprintf(compiler_messages(), "error: expression - cannot convert const in (==, !=) (constant value is unknown at compile time)\n");
+                    ctx->error = ERR_TYPE_COMPATABILITY;
                     return;
                 }
 
@@ -915,8 +916,8 @@ void expression_semantics(TNode *expression, scope_t* scope, expr_info* info) {
                 char **literal = &expression->left->data.nodeData.value.literal;
 
                 if ((*literal = literal_convert_f64_to_i32(*literal)) == NULL) { // NULL => float has non zero decimal part, so it cannot be converted
-                    printf("error: expression - cannot do implicit conversion of f64 value (non-zero decimal part)\n");
-                    error = ERR_TYPE_COMPATABILITY;
+                    fprintf(compiler_messages(), "error: expression - cannot do implicit conversion of f64 value (non-zero decimal part)\n");
+                    ctx->error = ERR_TYPE_COMPATABILITY;
                     return;
                 }
 
@@ -926,8 +927,8 @@ void expression_semantics(TNode *expression, scope_t* scope, expr_info* info) {
                 char **literal = &expression->right->data.nodeData.value.literal;
 
                 if ((*literal = literal_convert_f64_to_i32(*literal)) == NULL) { // NULL => float has non zero decimal part, so it cannot be converted
-                    printf("error: expression - cannot do implicit conversion of f64 value (non-zero decimal part)\n");
-                    error = ERR_TYPE_COMPATABILITY;
+                    fprintf(compiler_messages(), "error: expression - cannot do implicit conversion of f64 value (non-zero decimal part)\n");
+                    ctx->error = ERR_TYPE_COMPATABILITY;
                     return;
                 }
 
@@ -942,14 +943,14 @@ void expression_semantics(TNode *expression, scope_t* scope, expr_info* info) {
 
 
                 if (var_data.variable.is_constant == false) { // float operator is var, which cannot be implicitly converted
-                    printf("error: expression - cannot convert var in  relation operators (==, !=)\n");
-                    error = ERR_TYPE_COMPATABILITY;
+                    fprintf(compiler_messages(), "error: expression - cannot convert var in  relation operators (==, !=)\n");
+                    ctx->error = ERR_TYPE_COMPATABILITY;
                     return;
                 }
 
                 if (var_data.variable.comp_runtime == false) { // const value is unknown at the time of compilation
-                    printf("error: expression - cannot convert const in relation operators (==, !=) (constant value is unknown at compile time)\n");
-                    error = ERR_TYPE_COMPATABILITY;
+                    fprintf(compiler_messages(), "error: expression - cannot convert const in relation operators (==, !=) (constant value is unknown at compile time)\n");
+                    ctx->error = ERR_TYPE_COMPATABILITY;
                     return;
                 }
 
@@ -957,8 +958,8 @@ void expression_semantics(TNode *expression, scope_t* scope, expr_info* info) {
                 char *const_value = copy_literal(var_data.variable.value_pointer->data.nodeData.value.literal); // Extract the literal to be converted
 
                 if ((const_value = literal_convert_f64_to_i32(const_value)) == NULL) {
-                    printf("error: expression - cannot do implicit conversion of f64 value (non-zero decimal part)\n");
-                    error = ERR_TYPE_COMPATABILITY;
+                    fprintf(compiler_messages(), "error: expression - cannot do implicit conversion of f64 value (non-zero decimal part)\n");
+                    ctx->error = ERR_TYPE_COMPATABILITY;
                     return;
                 }
 
@@ -973,22 +974,22 @@ void expression_semantics(TNode *expression, scope_t* scope, expr_info* info) {
                 check_error();
 
                 if (var_data.variable.is_constant == false) { // float operator is var, which cannot be implicitly converted
-                    printf("error: expression - cannot convert var in  relation operators (==, !=)\n");
-                    error = ERR_TYPE_COMPATABILITY;
+                    fprintf(compiler_messages(), "error: expression - cannot convert var in  relation operators (==, !=)\n");
+                    ctx->error = ERR_TYPE_COMPATABILITY;
                     return;
                 }
 
                 if (var_data.variable.comp_runtime == false) { // const value is unknown at the time of compilation
-                    printf("error: expression - cannot convert const in relation operators (==, !=) (constant value is unknown at compile time)\n");
-                    error = ERR_TYPE_COMPATABILITY;
+                    fprintf(compiler_messages(), "error: expression - cannot convert const in relation operators (==, !=) (constant value is unknown at compile time)\n");
+                    ctx->error = ERR_TYPE_COMPATABILITY;
                     return;
                 }
 
                 char *const_value = copy_literal(var_data.variable.value_pointer->data.nodeData.value.literal); // Extract the literal to be converted
 
                 if ((const_value = literal_convert_f64_to_i32(const_value)) == NULL) {
-                    printf("error: expression - cannot do implicit conversion of f64 value (non-zero decimal part)\n");
-                    error = ERR_TYPE_COMPATABILITY;
+                    fprintf(compiler_messages(), "error: expression - cannot do implicit conversion of f64 value (non-zero decimal part)\n");
+                    ctx->error = ERR_TYPE_COMPATABILITY;
                     return;
                 }
 
@@ -997,8 +998,8 @@ void expression_semantics(TNode *expression, scope_t* scope, expr_info* info) {
             }
             else {
                 if (left.type != NIL_T || right.type != NIL_T) { // Any type can be compared to 'null'
-                    printf("error: relation operators (==, !=) type mismatch\n");
-                    error = ERR_TYPE_COMPATABILITY;
+                    fprintf(compiler_messages(), "error: relation operators (==, !=) type mismatch\n");
+                    ctx->error = ERR_TYPE_COMPATABILITY;
                     return;
                 }
             }
@@ -1019,24 +1020,24 @@ void expression_semantics(TNode *expression, scope_t* scope, expr_info* info) {
     case OP_LSE:
     {
         if (left.type == STR_T || right.type  == STR_T) {
-            printf("error: string type in relation operators expression\n");
-            error = ERR_TYPE_COMPATABILITY;
+            fprintf(compiler_messages(), "error: string type in relation operators expression\n");
+            ctx->error = ERR_TYPE_COMPATABILITY;
             return;
         }
         if (left.type == NIL_T || right.type == NIL_T) {
-            printf("error: null in relation operators expression\n");
-            error = ERR_TYPE_COMPATABILITY;
+            fprintf(compiler_messages(), "error: null in relation operators expression\n");
+            ctx->error = ERR_TYPE_COMPATABILITY;
             return;
         }
         if (left.is_optional_null || right.is_optional_null) {
-            printf(RED_BOLD("error")": type mismatch, trying to use optional null type in relation operators expression\n");
-            error = ERR_TYPE_COMPATABILITY;
+            fprintf(compiler_messages(), RED_BOLD("error")": type mismatch, trying to use optional null type in relation operators expression\n");
+            ctx->error = ERR_TYPE_COMPATABILITY;
             return;
         }
         if (left.type != right.type) {
             if (!left.is_constant_exp && !right.is_constant_exp) { // two variables with different types => error
-                printf("error: var type mismatch in relation operators expression (==, !=)\n");
-                error = ERR_TYPE_COMPATABILITY;
+                fprintf(compiler_messages(), "error: var type mismatch in relation operators expression (==, !=)\n");
+                ctx->error = ERR_TYPE_COMPATABILITY;
                 return;
             }
 
@@ -1060,14 +1061,14 @@ void expression_semantics(TNode *expression, scope_t* scope, expr_info* info) {
                 check_error();
 
                 if (var_data.variable.is_constant == false) { // i32 operator is var, which cannot be implicitly converted
-                    printf("error: expression - cannot convert var in (==, !=)\n");
-                    error = ERR_TYPE_COMPATABILITY;
+                    fprintf(compiler_messages(), "error: expression - cannot convert var in (==, !=)\n");
+                    ctx->error = ERR_TYPE_COMPATABILITY;
                     return;
                 }
 
                 if (var_data.variable.comp_runtime == false) { // const value is unknown at the time of compilation
-                    printf("error: expression - cannot convert const in (==, !=) (constant value is unknown at compile time)\n");
-                    error = ERR_TYPE_COMPATABILITY;
+                    fprintf(compiler_messages(), "error: expression - cannot convert const in (==, !=) (constant value is unknown at compile time)\n");
+                    ctx->error = ERR_TYPE_COMPATABILITY;
                     return;
                 }
 
@@ -1086,14 +1087,14 @@ void expression_semantics(TNode *expression, scope_t* scope, expr_info* info) {
                 check_error();
 
                 if (var_data.variable.is_constant == false) { // i32 operator is var, which cannot be implicitly converted
-                    printf("error: expression - cannot convert var in (==, !=)\n");
-                    error = ERR_TYPE_COMPATABILITY;
+                    fprintf(compiler_messages(), "error: expression - cannot convert var in (==, !=)\n");
+                    ctx->error = ERR_TYPE_COMPATABILITY;
                     return;
                 }
 
                 if (var_data.variable.comp_runtime == false) { // const value is unknown at the time of compilation
-                    printf("error: expression - cannot convert const in (==, !=) (constant value is unknown at compile time)\n");
-                    error = ERR_TYPE_COMPATABILITY;
+                    fprintf(compiler_messages(), "error: expression - cannot convert const in (==, !=) (constant value is unknown at compile time)\n");
+                    ctx->error = ERR_TYPE_COMPATABILITY;
                     return;
                 }
 
@@ -1108,8 +1109,8 @@ void expression_semantics(TNode *expression, scope_t* scope, expr_info* info) {
                 char **literal = &expression->left->data.nodeData.value.literal;
 
                 if ((*literal = literal_convert_f64_to_i32(*literal)) == NULL) { // NULL => float has non zero decimal part, so it cannot be converted
-                    printf("error: expression - cannot do implicit conversion of f64 value (non-zero decimal part)\n");
-                    error = ERR_TYPE_COMPATABILITY;
+                    fprintf(compiler_messages(), "error: expression - cannot do implicit conversion of f64 value (non-zero decimal part)\n");
+                    ctx->error = ERR_TYPE_COMPATABILITY;
                     return;
                 }
 
@@ -1119,8 +1120,8 @@ void expression_semantics(TNode *expression, scope_t* scope, expr_info* info) {
                 char **literal = &expression->right->data.nodeData.value.literal;
 
                 if ((*literal = literal_convert_f64_to_i32(*literal)) == NULL) { // NULL => float has non zero decimal part, so it cannot be converted
-                    printf("error: expression - cannot do implicit conversion of f64 value (non-zero decimal part)\n");
-                    error = ERR_TYPE_COMPATABILITY;
+                    fprintf(compiler_messages(), "error: expression - cannot do implicit conversion of f64 value (non-zero decimal part)\n");
+                    ctx->error = ERR_TYPE_COMPATABILITY;
                     return;
                 }
 
@@ -1135,14 +1136,14 @@ void expression_semantics(TNode *expression, scope_t* scope, expr_info* info) {
 
 
                 if (var_data.variable.is_constant == false) { // float operator is var, which cannot be implicitly converted
-                    printf("error: expression - cannot convert var in  relation operators (==, !=)\n");
-                    error = ERR_TYPE_COMPATABILITY;
+                    fprintf(compiler_messages(), "error: expression - cannot convert var in  relation operators (==, !=)\n");
+                    ctx->error = ERR_TYPE_COMPATABILITY;
                     return;
                 }
 
                 if (var_data.variable.comp_runtime == false) { // const value is unknown at the time of compilation
-                    printf("error: expression - cannot convert const in relation operators (==, !=) (constant value is unknown at compile time)\n");
-                    error = ERR_TYPE_COMPATABILITY;
+                    fprintf(compiler_messages(), "error: expression - cannot convert const in relation operators (==, !=) (constant value is unknown at compile time)\n");
+                    ctx->error = ERR_TYPE_COMPATABILITY;
                     return;
                 }
 
@@ -1150,8 +1151,8 @@ void expression_semantics(TNode *expression, scope_t* scope, expr_info* info) {
                 char *const_value = copy_literal(var_data.variable.value_pointer->data.nodeData.value.literal); // Extract the literal to be converted
 
                 if ((const_value = literal_convert_f64_to_i32(const_value)) == NULL) {
-                    printf("error: expression - cannot do implicit conversion of f64 value (non-zero decimal part)\n");
-                    error = ERR_TYPE_COMPATABILITY;
+                    fprintf(compiler_messages(), "error: expression - cannot do implicit conversion of f64 value (non-zero decimal part)\n");
+                    ctx->error = ERR_TYPE_COMPATABILITY;
                     return;
                 }
 
@@ -1166,22 +1167,22 @@ void expression_semantics(TNode *expression, scope_t* scope, expr_info* info) {
                 check_error();
 
                 if (var_data.variable.is_constant == false) { // float operator is var, which cannot be implicitly converted
-                    printf("error: expression - cannot convert var in  relation operators (==, !=)\n");
-                    error = ERR_TYPE_COMPATABILITY;
+                    fprintf(compiler_messages(), "error: expression - cannot convert var in  relation operators (==, !=)\n");
+                    ctx->error = ERR_TYPE_COMPATABILITY;
                     return;
                 }
 
                 if (var_data.variable.comp_runtime == false) { // const value is unknown at the time of compilation
-                    printf("error: expression - cannot convert const in relation operators (==, !=) (constant value is unknown at compile time)\n");
-                    error = ERR_TYPE_COMPATABILITY;
+                    fprintf(compiler_messages(), "error: expression - cannot convert const in relation operators (==, !=) (constant value is unknown at compile time)\n");
+                    ctx->error = ERR_TYPE_COMPATABILITY;
                     return;
                 }
 
                 char *const_value = copy_literal(var_data.variable.value_pointer->data.nodeData.value.literal); // Extract the literal to be converted
 
                 if ((const_value = literal_convert_f64_to_i32(const_value)) == NULL) {
-                    printf("error: expression - cannot do implicit conversion of f64 value (non-zero decimal part)\n");
-                    error = ERR_TYPE_COMPATABILITY;
+                    fprintf(compiler_messages(), "error: expression - cannot do implicit conversion of f64 value (non-zero decimal part)\n");
+                    ctx->error = ERR_TYPE_COMPATABILITY;
                     return;
                 }
 
@@ -1189,8 +1190,8 @@ void expression_semantics(TNode *expression, scope_t* scope, expr_info* info) {
                 expression->right->data.nodeData.value.literal = const_value;
             }
             else {
-                printf("error: relation operators (==, !=) type mismatch\n");
-                error = ERR_TYPE_COMPATABILITY;
+                fprintf(compiler_messages(), "error: relation operators (==, !=) type mismatch\n");
+                ctx->error = ERR_TYPE_COMPATABILITY;
                 return;
             }
         }
@@ -1206,6 +1207,12 @@ void expression_semantics(TNode *expression, scope_t* scope, expr_info* info) {
     default:
         break;
     }
+
+    /* Resolved type is kept in the AST, so the code generator can select type specific instructions */
+    expression->value_type = info->type;
+    expression->value_nullable = info->is_optional_null;
+    literal_value_type(expression->left);
+    literal_value_type(expression->right);
     //BT_print_tree(expression);
 }
 
@@ -1323,14 +1330,14 @@ void set_to_used(TSymtable* symtable, char* identifier) {
     TData data;
 
     if (symtable_get_data(symtable, identifier, &data) == false) {
-        error = ERR_COMPILER_INTERNAL;
+        ctx->error = ERR_COMPILER_INTERNAL;
         return;
     }
 
     data.variable.is_used = true;
 
     if (symtable_insert(symtable, identifier, data) == false) {
-        error = ERR_COMPILER_INTERNAL;
+        ctx->error = ERR_COMPILER_INTERNAL;
         return;
     }
 }
@@ -1365,7 +1372,7 @@ char *literal_convert_f64_to_i32(char *literal) {
     }
 
     if (literal[i] != '.') { //1e2 format, no '.' part
-        printf("error: missing '.' decimal separator --> %s\n", literal);
+        fprintf(compiler_messages(), "error: missing '.' decimal separator --> %s\n", literal);
         return NULL;
     }
 
@@ -1380,7 +1387,7 @@ char *literal_convert_f64_to_i32(char *literal) {
     }
 
     if (zero_decimal == false) {
-        printf("error: f2i conversion, float number has non-zero decimal part --> %s\n", literal);
+        fprintf(compiler_messages(), "error: f2i conversion, float number has non-zero decimal part --> %s\n", literal);
         return NULL;
     }
 
@@ -1397,14 +1404,14 @@ int get_func_type(TSymtable *globalSymTable, char *function_id) {
 
     /* Check if function is defined */
     if (symtable_search(globalSymTable, function_id) == false) {
-        printf("error: function %s undefined\n", function_id);
-        error = ERR_UNDEFINED_IDENTIFIER;
+        fprintf(compiler_messages(), "error: function %s undefined\n", function_id);
+        ctx->error = ERR_UNDEFINED_IDENTIFIER;
         return -1;
     }
 
     /* Get functions metadata */
     if (symtable_get_data(globalSymTable, function_id, &function_data) == false) {
-        error = ERR_COMPILER_INTERNAL;
+        ctx->error = ERR_COMPILER_INTERNAL;
         return -1;
     }
 
@@ -1422,27 +1429,40 @@ TData get_const_var_data(struct TScope* scope, char *variable_id) {
     TSymtable* local_st;
 
     if (id_defined(scope, variable_id, &local_st) == false) {
-        printf("error: var/const %s undefined\n", variable_id);
-        error = ERR_UNDEFINED_IDENTIFIER;
+        fprintf(compiler_messages(), "error: var/const %s undefined\n", variable_id);
+        ctx->error = ERR_UNDEFINED_IDENTIFIER;
         return variable_data;
     }
 
     /* Get var/const metadata */
     if (symtable_get_data(local_st, variable_id, &variable_data) == false) {
-        error = ERR_COMPILER_INTERNAL;
+        ctx->error = ERR_COMPILER_INTERNAL;
         return variable_data;
     }
 
     return variable_data;
 }
 
+/**
+* Updates resolved type of literal operand, which might have been implicitly converted by its operator
+*/
+void literal_value_type(TNode *operand) {
+    if (operand == NULL)
+        return;
+
+    if (operand->type == INT)
+        operand->value_type = INTEGER_T;
+    else if (operand->type == FL)
+        operand->value_type = FLOAT_T;
+}
+
 char *copy_literal(char *literal) {
     size_t size = strlen(literal) + 1;
 
     char *copy = (char*) malloc(size);
 
     if (copy == NULL) {
-        error = ERR_COMPILER_INTERNAL;
+        ctx->error = ERR_COMPILER_INTERNAL;
         return NULL;
     }
 
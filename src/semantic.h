@@ -176,6 +176,11 @@ char *literal_convert_f64_to_i32(char *literal);
 */
 char *copy_literal(char *literal);
 
+/**
+* Updates resolved type of i32/f64 literal operand after its implicit conversion.
+*/
+void literal_value_type(TNode *operand);
+
 // Data fetch functions
 
 /**
@@ -0,0 +1,336 @@
+/**
+ * Název projektu: Implementace překladače imperativního jazyka IFJ24.
+ *
+ * @file server.c
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "server.h"
+#include "compiler.h"
+#include "compiler_error.h"
+#include "ifj24.h"
+#include "options.h"
+
+// Accepted connections waiting for a worker, accepting blocks when the queue is full
+#define SERVER_QUEUE 64
+// Largest accepted source code in bytes
+#define SERVER_REQUEST_LIMIT (64 << 20)
+// Seconds a client has to send the whole request, and again to take the whole answer
+#define SERVER_TIMEOUT 10
+
+typedef struct server{
+    int queue[SERVER_QUEUE];    // Connections in the order of acceptance
+    size_t head, count;
+    bool stopping;              // Workers finish queued connections and exit
+    pthread_mutex_t lock;
+    pthread_cond_t ready;       // A connection was queued or the server stops
+    pthread_cond_t space;       // A worker took a connection from the full queue
+} server_t;
+
+// Source code of a request, workers keep their buffer between requests
+typedef struct server_buffer{
+    char* data;
+    size_t size, capacity;
+} server_buffer;
+
+static volatile sig_atomic_t stop_requested = 0;
+
+static void server_signal(int signal){
+    (void)signal;
+    stop_requested = 1;
+}
+
+/**
+ * Time SERVER_TIMEOUT seconds from now
+ * \return deadline on the monotonic clock
+ */
+static struct timespec server_deadline(void){
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += SERVER_TIMEOUT;
+    return deadline;
+}
+
+/**
+ * Waits until the client is ready for the events or the deadline passes. The deadline bounds the whole
+ * request, so a client sending one byte at a time can not keep the worker longer than SERVER_TIMEOUT.
+ * \param client
+ * \param events POLLIN or POLLOUT
+ * \param deadline
+ * \return true: client is ready, false: deadline passed or the connection failed
+ */
+static bool server_wait(int client, short events, const struct timespec* deadline){
+    while(true){
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        long long remaining = (deadline->tv_sec - now.tv_sec) * 1000LL + (deadline->tv_nsec - now.tv_nsec) / 1000000;
+        if(remaining <= 0){
+            return false;
+        }
+        struct pollfd descriptor = {.fd = client, .events = events};
+        int ready = poll(&descriptor, 1, (int)remaining);
+        if(ready > 0){
+            return true;
+        }
+        if(ready < 0 && errno != EINTR){
+            return false;
+        }
+    }
+}
+
+/**
+ * Reads the request until the client shuts down writing. A request over SERVER_REQUEST_LIMIT is not read
+ * to its end, a request not sent completely before the deadline is rejected.
+ * \param client
+ * \param buffer
+ * \param deadline
+ * \return NULL: success | reason of the rejected request sent to the client
+ */
+static const char* server_read(int client, server_buffer* buffer, const struct timespec* deadline){
+    buffer->size = 0;
+    while(true){
+        if(buffer->size == buffer->capacity){
+            if(buffer->capacity > SERVER_REQUEST_LIMIT){
+                return "request is larger than the limit of the server\n";
+            }
+            // One byte over the limit tells an oversized request from a request of exactly the limit
+            size_t capacity = buffer->capacity ? buffer->capacity * 2 : 64 * 1024;
+            if(capacity > SERVER_REQUEST_LIMIT + 1){
+                capacity = SERVER_REQUEST_LIMIT + 1;
+            }
+            char* data = realloc(buffer->data, capacity);
+            if(data == NULL){
+                return "server is out of memory\n";
+            }
+            buffer->data = data;
+            buffer->capacity = capacity;
+        }
+        if(!server_wait(client, POLLIN, deadline)){
+            return "request timed out\n";
+        }
+        ssize_t count = recv(client, buffer->data + buffer->size, buffer->capacity - buffer->size, MSG_DONTWAIT);
+        if(count == 0){
+            return buffer->size > SERVER_REQUEST_LIMIT ? "request is larger than the limit of the server\n" : NULL;
+        }
+        if(count < 0){
+            if(errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK){
+                continue;
+            }
+            return "cannot read the request\n";
+        }
+        buffer->size += count;
+    }
+}
+
+/**
+ * Sends the data, the connection is dropped when the client does not take them before the deadline
+ * \param client
+ * \param data
+ * \param length
+ * \param deadline
+ * \return true: success, false: the data were not sent
+ */
+static bool server_write(int client, const char* data, size_t length, const struct timespec* deadline){
+    while(length > 0){
+        if(!server_wait(client, POLLOUT, deadline)){
+            return false;
+        }
+        // Client that disconnected early must not kill the server by SIGPIPE
+        ssize_t count = send(client, data, length, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if(count < 0){
+            if(errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK){
+                continue;
+            }
+            return false;
+        }
+        data += count;
+        length -= count;
+    }
+    return true;
+}
+
+static void server_handle(int client, server_buffer* buffer){
+    ifj24_output output = {.code = NULL, .length = 0, .diagnostics = NULL, .diagnostics_length = 0,
+                           .error = ERR_COMPILER_INTERNAL};
+    struct timespec deadline = server_deadline();
+    const char* rejected = server_read(client, buffer, &deadline);
+    if(rejected == NULL){
+        ifj24_options compile_options = {.optimization = options.optimization, .lexer_thread = options.lexer_thread};
+        ifj24_compile(buffer->data, buffer->size, &output, &compile_options);
+    }
+    const char* diagnostics = rejected != NULL ? rejected : output.diagnostics;
+    size_t diagnostics_length = rejected != NULL ? strlen(rejected) : output.diagnostics_length;
+    char header[48];
+    int header_length = snprintf(header, sizeof(header), "%d %zu\n", output.error, diagnostics_length);
+    // Time of the compilation is not counted, the client has another SERVER_TIMEOUT to take the answer
+    deadline = server_deadline();
+    if(server_write(client, header, header_length, &deadline)
+       && server_write(client, diagnostics, diagnostics_length, &deadline)){
+        server_write(client, output.code, output.length, &deadline);
+    }
+    ifj24_output_free(&output);
+    close(client);
+}
+
+static void* server_worker(void* argument){
+    server_t* server = argument;
+    server_buffer buffer = {.data = NULL, .size = 0, .capacity = 0};
+    while(true){
+        pthread_mutex_lock(&server->lock);
+        while(server->count == 0 && !server->stopping){
+            pthread_cond_wait(&server->ready, &server->lock);
+        }
+        if(server->count == 0){
+            pthread_mutex_unlock(&server->lock);
+            break;
+        }
+        int client = server->queue[server->head];
+        server->head = (server->head + 1) % SERVER_QUEUE;
+        server->count--;
+        pthread_cond_signal(&server->space);
+        pthread_mutex_unlock(&server->lock);
+        server_handle(client, &buffer);
+    }
+    free(buffer.data);
+    return NULL;
+}
+
+/**
+ * Creates listening socket. A socket left by a server that did not stop cleanly is removed first,
+ * a socket of a running server is left to it.
+ * \param path
+ * \return socket | -1 on error
+ */
+static int server_listen(const char* path){
+    struct sockaddr_un address = {.sun_family = AF_UNIX};
+    if(strlen(path) >= sizeof(address.sun_path)){
+        fprintf(stderr, "socket path '%s' is too long\n", path);
+        return -1;
+    }
+    strcpy(address.sun_path, path);
+    struct stat status;
+    if(lstat(path, &status) == 0 && S_ISSOCK(status.st_mode)){
+        // Only a socket nobody listens on is stale
+        int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+        if(probe < 0){
+            perror("socket");
+            return -1;
+        }
+        int error = connect(probe, (struct sockaddr*)&address, sizeof(address)) == 0 ? 0 : errno;
+        close(probe);
+        if(error == 0){
+            fprintf(stderr, "another server is listening on '%s'\n", path);
+            return -1;
+        }
+        if(error != ECONNREFUSED && error != ENOENT){
+            fprintf(stderr, "cannot check socket '%s': %s\n", path, strerror(error));
+            return -1;
+        }
+        unlink(path);
+    }
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(listener < 0){
+        perror("socket");
+        return -1;
+    }
+    if(fcntl(listener, F_SETFL, O_NONBLOCK) != 0 || bind(listener, (struct sockaddr*)&address, sizeof(address)) != 0
+       || listen(listener, SOMAXCONN) != 0){
+        fprintf(stderr, "cannot listen on '%s': %s\n", path, strerror(errno));
+        close(listener);
+        return -1;
+    }
+    return listener;
+}
+
+int compile_server(const char* path, int jobs){
+    int listener = server_listen(path);
+    if(listener < 0){
+        return ERR_COMPILER_INTERNAL;
+    }
+    server_t server = {.head = 0, .count = 0, .stopping = false};
+    pthread_mutex_init(&server.lock, NULL);
+    pthread_cond_init(&server.ready, NULL);
+    pthread_cond_init(&server.space, NULL);
+
+    /*
+     * Signals stay blocked except inside of pselect, so a signal can not come between the check of stop_requested
+     * and waiting for a connection. Workers inherit the blocked signals.
+     */
+    struct sigaction action = {.sa_handler = server_signal};
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+    sigset_t signals, previous;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, &previous);
+    jobs = compile_jobs(jobs);
+    pthread_t* threads = malloc(sizeof(pthread_t) * jobs);
+    int started = 0;
+    while(threads != NULL && started < jobs && pthread_create(&threads[started], NULL, server_worker, &server) == 0){
+        started++;
+    }
+    int result = 0;
+    if(started == 0){
+        fprintf(stderr, "cannot start worker threads\n");
+        result = ERR_COMPILER_INTERNAL;
+    }
+
+    while(result == 0 && !stop_requested){
+        fd_set readable;
+        FD_ZERO(&readable);
+        FD_SET(listener, &readable);
+        if(pselect(listener + 1, &readable, NULL, NULL, NULL, &previous) < 0){
+            continue;
+        }
+        // The listener does not block, the client may disconnect before it is accepted
+        int client = accept(listener, NULL, NULL);
+        if(client < 0){
+            if(errno != EAGAIN && errno != EWOULDBLOCK && errno != ECONNABORTED && errno != EINTR){
+                perror("accept");
+                usleep(1000);
+            }
+            continue;
+        }
+        pthread_mutex_lock(&server.lock);
+        while(server.count == SERVER_QUEUE){
+            pthread_cond_wait(&server.space, &server.lock);
+        }
+        server.queue[(server.head + server.count) % SERVER_QUEUE] = client;
+        server.count++;
+        pthread_cond_signal(&server.ready);
+        pthread_mutex_unlock(&server.lock);
+    }
+
+    pthread_mutex_lock(&server.lock);
+    server.stopping = true;
+    pthread_cond_broadcast(&server.ready);
+    pthread_mutex_unlock(&server.lock);
+    for(int i = 0; i < started; i++){
+        pthread_join(threads[i], NULL);
+    }
+    free(threads);
+    close(listener);
+    unlink(path);
+    pthread_sigmask(SIG_SETMASK, &previous, NULL);
+    pthread_mutex_destroy(&server.lock);
+    pthread_cond_destroy(&server.ready);
+    pthread_cond_destroy(&server.space);
+    return result;
+}
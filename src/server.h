@@ -0,0 +1,28 @@
+/**
+ * Název projektu: Implementace překladače imperativního jazyka IFJ24.
+ *
+ * @file server.h
+ */
+
+#ifndef SERVER_H
+#define SERVER_H
+
+/*
+ * Compile server of --server. A client connects to the Unix socket, writes source code and shuts down writing.
+ * The server answers with a line "<exit code> <length of diagnostics>", the diagnostics of the compiler
+ * and IFJcode24 (nothing on error), then it closes the connection. Connections are compiled concurrently
+ * by a pool of worker threads. Requests over 64 MiB and requests not sent completely within 10 seconds are
+ * answered with exit code 99 and the reason in the diagnostics, a client that does not take the answer within
+ * 10 seconds is disconnected.
+ */
+
+/**
+ * Serves compilations until SIGINT or SIGTERM, the socket is removed afterwards
+ * \param path path of the Unix socket, stale socket left by a previous server is replaced, socket of a running
+ *             server is not
+ * \param jobs count of worker threads, 0 for count of online processors
+ * \return 0: server stopped on signal, ERR_COMPILER_INTERNAL: the socket could not be created
+ */
+int compile_server(const char* path, int jobs);
+
+#endif
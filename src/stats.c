@@ -0,0 +1,275 @@
+/**
+ * Název projektu: Implementace překladače imperativního jazyka IFJ24.
+ *
+ * @file stats.c
+ */
+
+#include <time.h>
+#include <sys/resource.h>
+
+#include "options.h"
+#include "stats.h"
+
+// Deepest nesting of phases, deeper phases are attributed to their parent
+#define STATS_DEPTH 16
+
+typedef struct stats_phase_data{
+    double wall, cpu;   // Seconds
+    size_t allocations;
+    size_t bytes;       // Requested by malloc, calloc and realloc
+} stats_phase_data;
+
+typedef struct stats_owner_data{
+    size_t allocations;
+    size_t bytes;
+} stats_owner_data;
+
+static const char* phase_names[STATS_PHASE_COUNT] = {
+    [STATS_OTHER] = "other",
+    [STATS_LEX] = "lex",
+    [STATS_PARSE] = "parse",
+    [STATS_PRECEDENCE] = "precedence",
+    [STATS_SEMANTIC] = "semantic",
+    [STATS_CODEGEN] = "codegen",
+    [STATS_OUTPUT] = "output",
+    [STATS_RUN] = "run",
+};
+
+static const char* owner_names[STATS_OWNER_COUNT] = {
+    [STATS_OWNER_PHASE] = "phase",
+    [STATS_OWNER_OTHER] = "other",
+    [STATS_OWNER_LEXER] = "lexer",
+    [STATS_OWNER_PARSER] = "parser",
+    [STATS_OWNER_AST] = "ast",
+    [STATS_OWNER_CODEGEN] = "codegen",
+    [STATS_OWNER_VM] = "vm",
+};
+
+static const char* counter_names[STATS_COUNTER_COUNT] = {
+    [STATS_TOKENS] = "tokens",
+    [STATS_NODES] = "ast_nodes",
+    [STATS_INSTRUCTIONS] = "ir_instructions",
+};
+
+static bool recording = false;
+// Only the thread that started recording is measured, the scanner thread of --lexer-thread allocates outside of it
+static __thread bool recording_thread = false;
+static __thread stats_owner owner = STATS_OWNER_PHASE;
+static stats_phase_data phases[STATS_PHASE_COUNT];
+static stats_owner_data owners[STATS_OWNER_COUNT];
+static size_t counters[STATS_COUNTER_COUNT];
+// Stack of entered phases, the top is the current phase
+static stats_phase nesting[STATS_DEPTH];
+static size_t depth = 0, overflow = 0;
+// Time when the current phase was resumed
+static double wall_mark, cpu_mark;
+
+static double stats_clock(clockid_t clock){
+    struct timespec now;
+    clock_gettime(clock, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+// Adds time since the mark to the current phase and moves the mark
+static void stats_account(void){
+    double wall = stats_clock(CLOCK_MONOTONIC), cpu = stats_clock(CLOCK_PROCESS_CPUTIME_ID);
+    phases[nesting[depth]].wall += wall - wall_mark;
+    phases[nesting[depth]].cpu += cpu - cpu_mark;
+    wall_mark = wall;
+    cpu_mark = cpu;
+}
+
+void stats_start(void){
+    if(options.stats == STATS_NONE){
+        return;
+    }
+    nesting[0] = STATS_OTHER;
+    depth = overflow = 0;
+    wall_mark = stats_clock(CLOCK_MONOTONIC);
+    cpu_mark = stats_clock(CLOCK_PROCESS_CPUTIME_ID);
+    recording = recording_thread = true;
+}
+
+void stats_enter(stats_phase phase){
+    if(!recording){
+        return;
+    }
+    if(depth + 1 == STATS_DEPTH){
+        overflow++;
+        return;
+    }
+    stats_account();
+    nesting[++depth] = phase;
+}
+
+void stats_leave(void){
+    if(!recording){
+        return;
+    }
+    if(overflow > 0){
+        overflow--;
+        return;
+    }
+    if(depth > 0){
+        stats_account();
+        depth--;
+    }
+}
+
+stats_owner stats_own(stats_owner new_owner){
+    stats_owner previous = owner;
+    owner = new_owner;
+    return previous;
+}
+
+void stats_count(stats_counter counter, size_t count){
+    // Threads of --batch compile without --stats and must not share the counters
+    if(recording){
+        counters[counter] += count;
+    }
+}
+
+#ifdef STATS_ALLOCATIONS
+/*
+ * Allocator calls of the compiler are redirected here by ld --wrap, allocations inside of the C library are not counted
+ */
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* pointer, size_t size);
+void* __wrap_malloc(size_t size);
+void* __wrap_calloc(size_t count, size_t size);
+void* __wrap_realloc(void* pointer, size_t size);
+
+// Subsystem owning allocations made in the phase unless the code selects other owner
+static const stats_owner phase_owners[STATS_PHASE_COUNT] = {
+    [STATS_OTHER] = STATS_OWNER_OTHER,
+    [STATS_LEX] = STATS_OWNER_LEXER,
+    [STATS_PARSE] = STATS_OWNER_PARSER,
+    [STATS_PRECEDENCE] = STATS_OWNER_PARSER,
+    [STATS_SEMANTIC] = STATS_OWNER_PARSER,
+    [STATS_CODEGEN] = STATS_OWNER_CODEGEN,
+    [STATS_OUTPUT] = STATS_OWNER_CODEGEN,
+    [STATS_RUN] = STATS_OWNER_VM,
+};
+
+static void stats_allocation(size_t size){
+    if(recording && recording_thread){
+        phases[nesting[depth]].allocations++;
+        phases[nesting[depth]].bytes += size;
+        stats_owner_data* data = &owners[owner == STATS_OWNER_PHASE ? phase_owners[nesting[depth]] : owner];
+        data->allocations++;
+        data->bytes += size;
+    }
+}
+
+void* __wrap_malloc(size_t size){
+    stats_allocation(size);
+    return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size){
+    stats_allocation(count * size);
+    return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* pointer, size_t size){
+    stats_allocation(size);
+    return __real_realloc(pointer, size);
+}
+
+#define STATS_COUNTS_ALLOCATIONS true
+#else
+#define STATS_COUNTS_ALLOCATIONS false
+#endif
+
+// Peak resident set size in KiB
+static long stats_peak_rss(void){
+    struct rusage usage;
+    return getrusage(RUSAGE_SELF, &usage) == 0 ? usage.ru_maxrss : 0;
+}
+
+static void stats_report_text(FILE* out, const stats_phase_data* total){
+    fprintf(out, "%-12s %10s %10s %12s %14s\n", "phase", "wall ms", "cpu ms", "allocations", "bytes");
+    for(int i = 0; i <= STATS_PHASE_COUNT; i++){
+        const stats_phase_data* phase = i < STATS_PHASE_COUNT ? &phases[i] : total;
+        fprintf(out, "%-12s %10.3f %10.3f", i < STATS_PHASE_COUNT ? phase_names[i] : "total", phase->wall * 1e3, phase->cpu * 1e3);
+        if(STATS_COUNTS_ALLOCATIONS){
+            fprintf(out, " %12zu %14zu\n", phase->allocations, phase->bytes);
+        }
+        else{
+            fprintf(out, " %12s %14s\n", "-", "-");
+        }
+    }
+    // Allocations by owning subsystem, the phase pseudo owner is never recorded
+    fprintf(out, "%-12s %12s %14s\n", "subsystem", "allocations", "bytes");
+    for(int i = STATS_OWNER_OTHER; i < STATS_OWNER_COUNT; i++){
+        fprintf(out, "%-12s", owner_names[i]);
+        if(STATS_COUNTS_ALLOCATIONS){
+            fprintf(out, " %12zu %14zu\n", owners[i].allocations, owners[i].bytes);
+        }
+        else{
+            fprintf(out, " %12s %14s\n", "-", "-");
+        }
+    }
+    for(int i = 0; i < STATS_COUNTER_COUNT; i++){
+        fprintf(out, "%s: %zu\n", counter_names[i], counters[i]);
+    }
+    fprintf(out, "peak_rss: %ld KiB\n", stats_peak_rss());
+}
+
+static void stats_report_json(FILE* out, const stats_phase_data* total){
+    fprintf(out, "{\"phases\": {");
+    for(int i = 0; i <= STATS_PHASE_COUNT; i++){
+        const stats_phase_data* phase = i < STATS_PHASE_COUNT ? &phases[i] : total;
+        if(i == STATS_PHASE_COUNT){
+            fprintf(out, "}, \"total\": ");
+        }
+        else{
+            fprintf(out, "%s\"%s\": ", i > 0 ? ", " : "", phase_names[i]);
+        }
+        fprintf(out, "{\"wall_ms\": %.3f, \"cpu_ms\": %.3f", phase->wall * 1e3, phase->cpu * 1e3);
+        // Allocations are null in builds without the wrapped allocator
+        if(STATS_COUNTS_ALLOCATIONS){
+            fprintf(out, ", \"allocations\": %zu, \"bytes\": %zu}", phase->allocations, phase->bytes);
+        }
+        else{
+            fprintf(out, ", \"allocations\": null, \"bytes\": null}");
+        }
+    }
+    fprintf(out, ", \"subsystems\": {");
+    for(int i = STATS_OWNER_OTHER; i < STATS_OWNER_COUNT; i++){
+        fprintf(out, "%s\"%s\": ", i > STATS_OWNER_OTHER ? ", " : "", owner_names[i]);
+        if(STATS_COUNTS_ALLOCATIONS){
+            fprintf(out, "{\"allocations\": %zu, \"bytes\": %zu}", owners[i].allocations, owners[i].bytes);
+        }
+        else{
+            fprintf(out, "{\"allocations\": null, \"bytes\": null}");
+        }
+    }
+    fputc('}', out);
+    for(int i = 0; i < STATS_COUNTER_COUNT; i++){
+        fprintf(out, ", \"%s\": %zu", counter_names[i], counters[i]);
+    }
+    fprintf(out, ", \"peak_rss_kib\": %ld}\n", stats_peak_rss());
+}
+
+void stats_report(FILE* out){
+    if(!recording){
+        return;
+    }
+    stats_account();
+    stats_phase_data total = {0};
+    for(int i = 0; i < STATS_PHASE_COUNT; i++){
+        total.wall += phases[i].wall;
+        total.cpu += phases[i].cpu;
+        total.allocations += phases[i].allocations;
+        total.bytes += phases[i].bytes;
+    }
+    if(options.stats == STATS_JSON){
+        stats_report_json(out, &total);
+    }
+    else{
+        stats_report_text(out, &total);
+    }
+    fflush(out);
+}
@@ -0,0 +1,88 @@
+/**
+ * Název projektu: Implementace překladače imperativního jazyka IFJ24.
+ *
+ * @file stats.h
+ */
+
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+/*
+ * Instrumentation of the compiler enabled by --stats. Phases nest (lexing runs inside parsing), time and allocations
+ * are attributed to the innermost phase only. Allocations are counted when the allocator is wrapped by the linker
+ * (make adds -DSTATS_ALLOCATIONS and --wrap), other builds report only times and counts.
+ * Every allocation is also attributed to the subsystem owning it. The owner follows from the current phase,
+ * code that allocates for another subsystem (AST nodes created by the parser) selects the owner by stats_own.
+ */
+
+typedef enum stats_phase{
+    STATS_OTHER,        // Startup and work between phases
+    STATS_LEX,
+    STATS_PARSE,        // Syntax analysis without expressions, symbol table setup
+    STATS_PRECEDENCE,   // Precedence analysis of expressions
+    STATS_SEMANTIC,
+    STATS_CODEGEN,
+    STATS_OUTPUT,       // Printing of IFJcode24
+    STATS_RUN,          // Built-in interpreter with --run
+    STATS_PHASE_COUNT
+} stats_phase;
+
+typedef enum stats_owner{
+    STATS_OWNER_PHASE,      // Owner given by the current phase
+    STATS_OWNER_OTHER,
+    STATS_OWNER_LEXER,      // Scanner, tokens and lexemes
+    STATS_OWNER_PARSER,     // Syntax and semantic analysis, symbol tables, scopes
+    STATS_OWNER_AST,        // Nodes of the abstract syntax tree
+    STATS_OWNER_CODEGEN,    // Code generator and the generated instructions
+    STATS_OWNER_VM,         // Built-in interpreter with --run
+    STATS_OWNER_COUNT
+} stats_owner;
+
+typedef enum stats_counter{
+    STATS_TOKENS,
+    STATS_NODES,        // AST nodes
+    STATS_INSTRUCTIONS, // Generated IFJcode24 instructions
+    STATS_COUNTER_COUNT
+} stats_counter;
+
+/**
+ * Starts measurement in STATS_OTHER phase, does nothing without --stats
+ */
+void stats_start(void);
+
+/**
+ * Enters nested phase, time of the current phase stops until stats_leave
+ * \param phase
+ */
+void stats_enter(stats_phase phase);
+
+/**
+ * Returns to the phase that was current before the matching stats_enter
+ */
+void stats_leave(void);
+
+/**
+ * Attributes allocations of the calling thread to the owner until the next call
+ * \param owner STATS_OWNER_PHASE returns to the owner of the current phase
+ * \return previous owner, passed to stats_own at the end of the allocating code
+ */
+stats_owner stats_own(stats_owner owner);
+
+/**
+ * Adds to counter
+ * \param counter
+ * \param count
+ */
+void stats_count(stats_counter counter, size_t count);
+
+/**
+ * Prints collected statistics in the format selected by --stats, does nothing without --stats
+ * \param out
+ */
+void stats_report(FILE* out);
+
+#endif
@@ -0,0 +1,455 @@
+/**
+ * Název projektu: Implementace překladače imperativního jazyka IFJ24.
+ *
+ * @file stream.c
+ */
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "stream.h"
+#include "binary_tree.h"
+#include "codegen.h"
+#include "compiler.h"
+#include "compiler_error.h"
+#include "lexer.h"
+#include "semantic.h"
+#include "stats.h"
+#include "syna.h"
+#include "token.h"
+
+typedef struct stream{
+    Tparser parser;
+    TSymtable* signatures;          // Headers of all functions found by the pre-scan and the built-in functions
+    FILE* code;                     // IFJcode24 of the generated functions, printed when the compilation succeeds
+    FILE* table;                    // Line table of the code, NULL without --line-table
+    size_t line;                    // Line of the code where the next function is printed
+    size_t declared;                // Functions with the header read by the pre-scan
+    unsigned int prescan_error;     // Error that stopped the pre-scan after the declared functions
+    unsigned int semantic_error;    // First semantic error, syntax errors in the rest of the program are reported first
+    bool main_valid;                // Semantic analysis of main would succeed, functions are not checked otherwise
+} stream_t;
+
+/**
+ * Skips body of a function after its opening {, lexemes of the body are freed.
+ * Declarations and calls are recognized from the tokens the same way codegen recognizes them in the AST.
+ * \param[out] has_locals body declares variables
+ * \param[out] has_calls body calls a function, that is not lowered inline
+ */
+static void stream_skip_body(bool* has_locals, bool* has_calls){
+    size_t mark = lexeme_mark();
+    // The last three tokens, namespace.function( is a call of a built-in function
+    token_t last[3] = {{.id = TOKEN_DEFAULT}, {.id = TOKEN_DEFAULT}, {.id = TOKEN_DEFAULT}};
+    int depth = 1;
+    while(depth > 0){
+        token_t token = get_token();
+        switch(token.id){
+            case TOKEN_ERROR:
+                release_lexemes(mark);
+                return;
+            case TOKEN_EOF:
+                ctx->error = ERR_SYNTAX;
+                release_lexemes(mark);
+                return;
+            case TOKEN_BRACKET_CURLY_LEFT:
+                depth++;
+                break;
+            case TOKEN_BRACKET_CURLY_RIGHT:
+                depth--;
+                break;
+            case TOKEN_KW_VAR:
+            case TOKEN_KW_CONST:
+            case TOKEN_PIPE:
+                *has_locals = true;
+                break;
+            case TOKEN_BRACKET_ROUND_LEFT:
+                if(last[0].id != TOKEN_IDENTIFIER){
+                    break;
+                }
+                if(last[1].id == TOKEN_ACCESS_OPERATOR && last[2].id == TOKEN_IDENTIFIER){
+                    char* function = func_id_concat(last[2].lexeme.array, last[0].lexeme.array);
+                    if(function != NULL && !is_inline_call(function)){
+                        *has_calls = true;
+                    }
+                }
+                else{
+                    *has_calls = true;
+                }
+                break;
+            default:
+                break;
+        }
+        last[2] = last[1];
+        last[1] = last[0];
+        last[0] = token;
+    }
+    release_lexemes(mark);
+}
+
+/**
+ * Pre-scan, reads headers of the functions into the signatures and declares them to codegen
+ * \param stream
+ */
+static void stream_headers(stream_t* stream){
+    Tparser* parser = &stream->parser;
+    TNode** function = &parser->AST->root->left;
+    while(true){
+        if((parser->current_token = get_token()).id == TOKEN_ERROR){
+            return;
+        }
+        switch(parser->current_token.id){
+            case TOKEN_KW_PUB: {
+                parser->state = STATE_fn;
+                function_header(parser, function);
+                if(ctx->error){
+                    return;
+                }
+                // The function is parsed again up to the error in its body
+                stream->declared++;
+                bool has_locals = false;
+                bool has_calls = false;
+                stream_skip_body(&has_locals, &has_calls);
+                if(ctx->error){
+                    return;
+                }
+                codegen_declare_function(*function, has_locals, has_calls);
+                if(ctx->error){
+                    return;
+                }
+                function = &(*function)->left;
+                break;
+            }
+            case TOKEN_KW_CONST:
+                parser->state = STATE_identifier;
+                import_func(parser, &parser->AST->root->right);
+                if(ctx->error){
+                    return;
+                }
+                break;
+            case TOKEN_EOF:
+                return;
+            default:
+                ctx->error = ERR_SYNTAX;
+                return;
+        }
+    }
+}
+
+static void stream_flush(stream_t* stream){
+    stats_enter(STATS_OUTPUT);
+    stream->line = ir_print_mapped(&ctx->generated_code, stream->code, stream->line, options.line_comments,
+                                   stream->table);
+    stats_leave();
+    stats_count(STATS_INSTRUCTIONS, ctx->generated_code.count);
+    ir_dispose(&ctx->generated_code);
+}
+
+/**
+ * Frees symtables of the blocks of the function
+ * \param node
+ */
+static void stream_free_scopes(TNode* node){
+    if(node == NULL){
+        return;
+    }
+    if(node->type == IF || node->type == WHILE || node->type == ELSE || node->type == BODY){
+        scope_t* scope = node->data.nodeData.body.current_scope;
+        if(scope != NULL){
+            symtable_free(scope->current_scope);
+            free(scope->parent_scope);
+            free(scope);
+        }
+    }
+    stream_free_scopes(node->left);
+    stream_free_scopes(node->right);
+}
+
+/**
+ * Frees AST of the function, its symtables and its header, lexemes are released by the caller
+ * \param function
+ * \param header symtable with the header of the function
+ */
+static void stream_free_function(TNode* function, TSymtable* header){
+    if(function != NULL){
+        stream_free_scopes(function->right);
+        symtable_free(function->data.nodeData.function.scope);
+        item_ll_t* param = function->data.nodeData.function.param_identifiers.first;
+        while(param != NULL){
+            item_ll_t* next = param->next;
+            free(param);
+            param = next;
+        }
+        TData data;
+        if(function->data.nodeData.function.identifier != NULL
+           && symtable_get_data(header, function->data.nodeData.function.identifier, &data)){
+            d_array_free(&data.function.argument_types);
+        }
+        TBinaryTree tree = {.root = function, .active = NULL};
+        BT_free_nodes(&tree);
+    }
+    symtable_free(header);
+}
+
+/**
+ * Checks and generates the function parsed in the second pass
+ * \param stream
+ * \param function
+ */
+static void stream_generate(stream_t* stream, TNode* function){
+    stats_enter(STATS_SEMANTIC);
+    ctx->hasReturn = false;
+    FunctionSemantics(function);
+    stats_leave();
+    if(ctx->error){
+        // Syntax errors of the following functions have priority, they are only parsed
+        stream->semantic_error = ctx->error;
+        ctx->error = SUCCESS;
+        return;
+    }
+    stats_enter(STATS_CODEGEN);
+    TNode program = {.type = PROGRAM, .left = function};
+    TBinaryTree tree = {.root = &program, .active = &program};
+    codegen_function(&tree);
+    stats_leave();
+    if(!ctx->error){
+        stream_flush(stream);
+    }
+}
+
+/**
+ * Parses function after its pub keyword, generates it and frees it
+ * \param stream
+ */
+static void stream_function(stream_t* stream){
+    Tparser* parser = &stream->parser;
+    // Redefinitions were found by the pre-scan, the symtable of the parser keeps only the parsed header
+    parser->global_symtable = symtable_init();
+    if(parser->global_symtable == NULL){
+        ctx->error = ERR_COMPILER_INTERNAL;
+        return;
+    }
+    TNode* function = NULL;
+    parser->state = STATE_fn;
+    function_header(parser, &function);
+    if(!ctx->error && stream->main_valid && stream->semantic_error == SUCCESS){
+        stream_generate(stream, function);
+    }
+    stream_free_function(function, parser->global_symtable);
+    parser->global_symtable = NULL;
+    parser->scope.current_scope = NULL;
+    parser->scope.parent_scope = NULL;
+}
+
+/**
+ * Second pass, parses and generates the functions one after another
+ * \param stream
+ */
+static void stream_functions(stream_t* stream){
+    Tparser* parser = &stream->parser;
+    size_t parsed = 0;
+    while(true){
+        size_t mark = lexeme_mark();
+        if((parser->current_token = get_token()).id == TOKEN_ERROR){
+            return;
+        }
+        switch(parser->current_token.id){
+            case TOKEN_KW_PUB:
+                // The pre-scan stopped in this header
+                if(parsed == stream->declared){
+                    ctx->error = stream->prescan_error != SUCCESS ? stream->prescan_error : ERR_COMPILER_INTERNAL;
+                    return;
+                }
+                parsed++;
+                stream_function(stream);
+                break;
+            case TOKEN_KW_CONST: {
+                TNode* prologue = NULL;
+                parser->state = STATE_identifier;
+                import_func(parser, &prologue);
+                free(prologue);
+                break;
+            }
+            case TOKEN_EOF:
+                return;
+            default:
+                ctx->error = ERR_SYNTAX;
+                return;
+        }
+        if(ctx->error){
+            return;
+        }
+        release_lexemes(mark);
+    }
+}
+
+/**
+ * Returns stream with the source code, that can be read again from the start position
+ * \param source
+ * \param[out] start position of the source code
+ * \return source | temporary copy of the source code | NULL on error
+ */
+static FILE* stream_source(FILE* source, long* start){
+    *start = ftell(source);
+    if(*start >= 0 && fseek(source, *start, SEEK_SET) == 0){
+        return source;
+    }
+    FILE* copy = tmpfile();
+    if(copy == NULL){
+        return NULL;
+    }
+    char chunk[64 * 1024];
+    size_t count;
+    while((count = fread(chunk, 1, sizeof(chunk), source)) > 0){
+        if(fwrite(chunk, 1, count, copy) != count){
+            fclose(copy);
+            return NULL;
+        }
+    }
+    *start = 0;
+    if(ferror(source) || fseek(copy, 0, SEEK_SET) != 0){
+        fclose(copy);
+        return NULL;
+    }
+    return copy;
+}
+
+static bool stream_copy(FILE* from, FILE* to){
+    if(fseek(from, 0, SEEK_SET) != 0){
+        return false;
+    }
+    char chunk[64 * 1024];
+    size_t count;
+    while((count = fread(chunk, 1, sizeof(chunk), from)) > 0){
+        if(fwrite(chunk, 1, count, to) != count){
+            return false;
+        }
+    }
+    return !ferror(from);
+}
+
+/**
+ * Runs both passes over the source code
+ * \param stream
+ * \param source
+ * \param start position of the source code
+ */
+static void stream_compile(stream_t* stream, FILE* source, long start){
+    Tparser* parser = &stream->parser;
+    parser->AST = BT_init();
+    stream->signatures = symtable_init();
+    if(parser->AST == NULL || stream->signatures == NULL || !BT_insert_root(parser->AST, PROGRAM)){
+        ctx->error = ERR_COMPILER_INTERNAL;
+        return;
+    }
+    populate_builtin_functions(stream->signatures);
+    if(ctx->error){
+        return;
+    }
+    fputs(".IFJcode24\n", stream->code);
+    stream->line = 2;
+
+    stats_enter(STATS_PARSE);
+    parser->global_symtable = stream->signatures;
+    parser->headers_only = true;
+    stream_headers(stream);
+    stream->prescan_error = ctx->error;
+    ctx->error = SUCCESS;
+    parser->headers_only = false;
+    ctx->globalSymTable = stream->signatures;
+
+    TData main_data;
+    stream->main_valid = stream->prescan_error == SUCCESS && symtable_get_data(stream->signatures, "main", &main_data)
+                         && main_data.function.argument_types.length == 0 && main_data.function.return_type == VOID_T;
+    if(stream->main_valid){
+        stats_enter(STATS_CODEGEN);
+        codegen_prologue();
+        stats_leave();
+        if(!ctx->error){
+            stream_flush(stream);
+        }
+    }
+
+    if(!ctx->error){
+        // The scanner thread of the pre-scan may have read ahead
+        stop_scanner_thread();
+        if(fseek(source, start, SEEK_SET) != 0){
+            ctx->error = ERR_COMPILER_INTERNAL;
+        }
+        else{
+            init_scanner(source);
+            if(options.lexer_thread){
+                start_scanner_thread();
+            }
+            stream_functions(stream);
+        }
+    }
+    stats_leave();
+    if(ctx->error){
+        return;
+    }
+    // Errors are reported in the order of compile(): syntax, main function, semantics of the functions
+    if(stream->prescan_error != SUCCESS){
+        ctx->error = stream->prescan_error;
+    }
+    else if(!stream->main_valid){
+        main_function_semantics(stream->signatures);
+    }
+    else if(stream->semantic_error != SUCCESS){
+        ctx->error = stream->semantic_error;
+    }
+    else{
+        stats_enter(STATS_CODEGEN);
+        codegen_epilogue();
+        stats_leave();
+        if(!ctx->error){
+            stream_flush(stream);
+        }
+    }
+}
+
+unsigned int compile_stream(FILE* source, opt_level optimization, FILE* out, FILE* table){
+    compiler_context context = {
+        .optimization = optimization,
+        .cg_operand_type = IR_TYPE_ANY,
+        .var_frame = LOCAL,
+    };
+    ctx = &context;
+    stream_t stream = {.parser = {.state = STATE_ROOT}};
+
+    long start;
+    FILE* input = stream_source(source, &start);
+    stream.code = tmpfile();
+    stream.table = table != NULL ? tmpfile() : NULL;
+    if(input == NULL || stream.code == NULL || (table != NULL && stream.table == NULL)){
+        context.error = ERR_COMPILER_INTERNAL;
+    }
+    else{
+        init_scanner(input);
+        if(options.lexer_thread){
+            start_scanner_thread();
+        }
+        stream_compile(&stream, input, start);
+    }
+
+    if(!context.error){
+        stats_enter(STATS_OUTPUT);
+        if(!stream_copy(stream.code, out) || (table != NULL && !stream_copy(stream.table, table))){
+            context.error = ERR_COMPILER_INTERNAL;
+        }
+        stats_leave();
+    }
+    if(stream.code != NULL){
+        fclose(stream.code);
+    }
+    if(stream.table != NULL){
+        fclose(stream.table);
+    }
+    if(input != NULL && input != source){
+        fclose(input);
+    }
+    codegen_dispose();
+    ir_dispose(&context.generated_code);
+    dispose_scanner();
+    ctx = NULL;
+    return context.error;
+}
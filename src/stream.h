@@ -0,0 +1,31 @@
+/**
+ * Název projektu: Implementace překladače imperativního jazyka IFJ24.
+ *
+ * @file stream.h
+ */
+
+#ifndef STREAM_H
+#define STREAM_H
+
+#include <stdio.h>
+
+#include "options.h"
+
+/*
+ * Streaming compilation of --stream. A pre-scan reads the headers of all functions and skips their bodies,
+ * then the source code is read again and every function is analysed, generated, printed and freed as soon as
+ * its body is parsed. Peak memory depends on the largest function and the count of functions, not on the size
+ * of the whole program. Exit codes are the same as of compile().
+ */
+
+/**
+ * Compiles IFJ24 source code one function at a time
+ * \param source stream with the source code, a stream that can not be rewound is copied to a temporary file
+ * \param optimization optimization level of the generated code
+ * \param out stream for IFJcode24, nothing is printed on error
+ * \param table stream for the line table of --line-table, NULL without it, nothing is printed on error
+ * \return 0: success, error code of the compiler
+ */
+unsigned int compile_stream(FILE* source, opt_level optimization, FILE* out, FILE* table);
+
+#endif
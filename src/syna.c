@@ -18,9 +18,11 @@
 #include "syna.h"
 #include "token.h"
 #include "precedent.h"
+#include "compiler.h"
 #include "compiler_error.h"
 #include "lexer.h"
 #include "semantic.h"
+#include "stats.h"
 
 TData declaration_data(bool nullable, bool constant, Type type){
  
@@ -51,7 +53,7 @@ TData blank_function(TSymtable* scope){
 void enter_sub_body(Tparser* parser) {
     struct TScope* new_scope = (struct TScope*)malloc(sizeof(struct TScope));
     if (!new_scope) {
-        error = ERR_COMPILER_INTERNAL;
+        ctx->error = ERR_COMPILER_INTERNAL;
         return ;
     }
 
@@ -62,12 +64,12 @@ void enter_sub_body(Tparser* parser) {
     parser->scope.current_scope = symtable_init();
     
     if (parser->scope.current_scope == NULL) {
-        error = ERR_COMPILER_INTERNAL;
+        ctx->error = ERR_COMPILER_INTERNAL;
         return;
     }
     
     if (parser->scope.current_scope == NULL) {
-        error = ERR_COMPILER_INTERNAL;
+        ctx->error = ERR_COMPILER_INTERNAL;
     }
 
     return ;
@@ -78,7 +80,7 @@ void enter_sub_body(Tparser* parser) {
     //debug_print_keys(parser->scope.current_scope);
  
     if(parser->scope.parent_scope == NULL){
-        error = ERR_COMPILER_INTERNAL;
+        ctx->error = ERR_COMPILER_INTERNAL;
         return;
     }
     
@@ -90,7 +92,7 @@ void init_parser(token_t token) {
     Tparser* parser = malloc(sizeof(Tparser));
 
     if (parser == NULL) {
-        error = ERR_COMPILER_INTERNAL;
+        ctx->error = ERR_COMPILER_INTERNAL;
         return;
     }
 
@@ -98,13 +100,13 @@ void init_parser(token_t token) {
     parser->global_symtable = symtable_init();
 
     if (parser->global_symtable == NULL) {
-        error = ERR_COMPILER_INTERNAL;
+        ctx->error = ERR_COMPILER_INTERNAL;
         return;
     }
     
     // Inserting the built-in functions into the global symtable
     populate_builtin_functions(parser->global_symtable);
-    if(error)
+    if(ctx->error)
         return;
 
     // Initialising the AST
@@ -118,6 +120,7 @@ void init_parser(token_t token) {
 
     // Initial automata state
     parser->state = STATE_ROOT;
+    parser->headers_only = false;
 
     // Processed token
     parser->current_token = token;
@@ -130,7 +133,9 @@ void init_parser(token_t token) {
     //debug_print_keys(parser->global_symtable);
 
     /* SEMANTIC ANALYSIS */
+    stats_enter(STATS_SEMANTIC);
     semantic_analysis(parser->AST);
+    stats_leave();
 }
 
 void root_code(Tparser* parser, TNode** current_node) {
@@ -147,13 +152,13 @@ void root_code(Tparser* parser, TNode** current_node) {
             function_header(parser, &(*current_node)->left);
             //debug_print_keys(parser->scope.current_scope);
 
-            if (error)
+            if (ctx->error)
                 return;
 
             parser->state = STATE_ROOT;
             root_code(parser, &(*current_node)->left);
 
-            if (error)
+            if (ctx->error)
                 return;
 
             break;
@@ -162,13 +167,13 @@ void root_code(Tparser* parser, TNode** current_node) {
 
             import_func(parser, &(parser->AST->root->right));
 
-            if (error)
+            if (ctx->error)
                 return;
 
             parser->state = STATE_ROOT;
             root_code(parser, current_node);
 
-            if (error)
+            if (ctx->error)
                 return;
 
             break;
@@ -177,11 +182,11 @@ void root_code(Tparser* parser, TNode** current_node) {
             return;
 
         default:
-            error = ERR_SYNTAX;
+            ctx->error = ERR_SYNTAX;
         }
         return;
     } else {
-        error = ERR_SYNTAX;
+        ctx->error = ERR_SYNTAX;
         return;
     }
 }
@@ -199,7 +204,7 @@ void import_func(Tparser* parser, TNode** current_node) {
             import_func(parser, current_node);
             break;
         }
-        error = ERR_SYNTAX;
+        ctx->error = ERR_SYNTAX;
         break;
     case STATE_identifier_prolog: //checking for this part const ifj = @import(->"ifj24.zig"<-);
         if (parser->current_token.id == TOKEN_LITERAL_STRING) {
@@ -207,7 +212,7 @@ void import_func(Tparser* parser, TNode** current_node) {
             import_func(parser, current_node);
             break;
         }
-        error = ERR_SYNTAX;
+        ctx->error = ERR_SYNTAX;
         break;
     case STATE_assig: //checking for this part const ifj ->=<- @import("ifj24.zig");
         if (parser->current_token.id == TOKEN_ASSIGNMENT) {
@@ -215,7 +220,7 @@ void import_func(Tparser* parser, TNode** current_node) {
             import_func(parser, current_node);
             break;
         }
-        error = ERR_SYNTAX;
+        ctx->error = ERR_SYNTAX;
         break;
     case STATE_prolog: //checking for this part const ifj = ->@import<-("ifj24.zig");
         if (parser->current_token.id == TOKEN_PROLOG) {
@@ -223,7 +228,7 @@ void import_func(Tparser* parser, TNode** current_node) {
             import_func(parser, current_node);
             break;
         }
-        error = ERR_SYNTAX;
+        ctx->error = ERR_SYNTAX;
         break;
     case STATE_lr_bracket: //checking for this part const ifj = @import->(<-"ifj24.zig");
         if (parser->current_token.id == TOKEN_BRACKET_ROUND_LEFT) {
@@ -231,7 +236,7 @@ void import_func(Tparser* parser, TNode** current_node) {
             import_func(parser, current_node);
             break;
         }
-        error = ERR_SYNTAX;
+        ctx->error = ERR_SYNTAX;
         break;
     case STATE_rr_bracket: //checking for this part const ifj = @import("ifj24.zig"->)<-;
         if (parser->current_token.id == TOKEN_BRACKET_ROUND_RIGHT) {
@@ -239,23 +244,23 @@ void import_func(Tparser* parser, TNode** current_node) {
             import_func(parser, current_node);
             break;
         }
-        error = ERR_SYNTAX;
+        ctx->error = ERR_SYNTAX;
         break;
     case STATE_semicolon: //checking for this part const ifj = @import("ifj24.zig")->;<-
         if (parser->current_token.id == TOKEN_SEMICOLON) {
             return;
         }
-        error = ERR_SYNTAX;
+        ctx->error = ERR_SYNTAX;
         break;
     default:
-        error = ERR_SYNTAX;
+        ctx->error = ERR_SYNTAX;
     }
     return;
 }
 
 void function_header(Tparser* parser, TNode** current_node) {
     
-    if (error) return;
+    if (ctx->error) return;
     
     TData param_data;
     int has_qmark = 0;
@@ -273,13 +278,13 @@ void function_header(Tparser* parser, TNode** current_node) {
             function_header(parser, current_node);
             break;
         }
-        error = ERR_SYNTAX;
+        ctx->error = ERR_SYNTAX;
         break;
     case STATE_identifier:
         if (parser->current_token.id == TOKEN_IDENTIFIER) { //checking for pub fn ->name<-() type{
         
             if (symtable_search(parser->global_symtable, parser->current_token.lexeme.array)) {
-                error = ERR_IDENTIFIER_REDEF_CONST_ASSIGN;
+                ctx->error = ERR_IDENTIFIER_REDEF_CONST_ASSIGN;
                 return;
             }
             
@@ -287,7 +292,7 @@ void function_header(Tparser* parser, TNode** current_node) {
             parser->scope.current_scope = symtable_init();
             
             if (parser->scope.current_scope == NULL) {
-                error = ERR_COMPILER_INTERNAL;
+                ctx->error = ERR_COMPILER_INTERNAL;
                 return;
             }
             
@@ -299,7 +304,7 @@ void function_header(Tparser* parser, TNode** current_node) {
             
             TData function_data = blank_function(parser->scope.current_scope);
             if(!symtable_insert(parser->global_symtable, parser->current_token.lexeme.array, function_data)){
-                error = ERR_COMPILER_INTERNAL;
+                ctx->error = ERR_COMPILER_INTERNAL;
                 return;
             }
           
@@ -307,7 +312,7 @@ void function_header(Tparser* parser, TNode** current_node) {
             function_header(parser, current_node);
             break;
         }
-        error = ERR_SYNTAX;
+        ctx->error = ERR_SYNTAX;
         break;
     case STATE_lr_bracket:
         if (parser->current_token.id == TOKEN_BRACKET_ROUND_LEFT) { //checking for pub fn name->(<-) type{
@@ -325,7 +330,7 @@ void function_header(Tparser* parser, TNode** current_node) {
             break;
             
         }
-        error = ERR_SYNTAX;
+        ctx->error = ERR_SYNTAX;
         break;
     case STATE_type:
     
@@ -340,7 +345,7 @@ void function_header(Tparser* parser, TNode** current_node) {
         case TOKEN_KW_I32://checking for pub fn name() ->i32<-{
              
             if(!symtable_get_data(parser->global_symtable, (*current_node)->data.nodeData.function.identifier, &param_data)){
-                error = ERR_COMPILER_INTERNAL;
+                ctx->error = ERR_COMPILER_INTERNAL;
                 return;
             }
             
@@ -349,7 +354,7 @@ void function_header(Tparser* parser, TNode** current_node) {
             if(has_qmark == 1)
                 param_data.function.is_null_type = true;
             if(!symtable_insert(parser->global_symtable, (*current_node)->data.nodeData.function.identifier, param_data)){
-                error = ERR_COMPILER_INTERNAL;
+                ctx->error = ERR_COMPILER_INTERNAL;
                 return;
             }
         
@@ -361,7 +366,7 @@ void function_header(Tparser* parser, TNode** current_node) {
         case TOKEN_KW_F64://checking for pub fn name() ->f64<-{
         
             if(!symtable_get_data(parser->global_symtable, (*current_node)->data.nodeData.function.identifier, &param_data)){
-                error = ERR_COMPILER_INTERNAL;
+                ctx->error = ERR_COMPILER_INTERNAL;
                 return;
             }
             
@@ -370,7 +375,7 @@ void function_header(Tparser* parser, TNode** current_node) {
             if(has_qmark == 1)
                 param_data.function.is_null_type = true;
             if(!symtable_insert(parser->global_symtable, (*current_node)->data.nodeData.function.identifier, param_data)){
-                error = ERR_COMPILER_INTERNAL;
+                ctx->error = ERR_COMPILER_INTERNAL;
                 return;
             }
         
@@ -383,14 +388,14 @@ void function_header(Tparser* parser, TNode** current_node) {
             if (has_qmark != 1) {
             
                 if(!symtable_get_data(parser->global_symtable, (*current_node)->data.nodeData.function.identifier, &param_data)){
-                    error = ERR_COMPILER_INTERNAL;
+                    ctx->error = ERR_COMPILER_INTERNAL;
                     return;
                 }
                 
                 //setting the return type in the symtable
                 param_data.function.return_type = VOID_T;
                 if(!symtable_insert(parser->global_symtable, (*current_node)->data.nodeData.function.identifier, param_data)){
-                    error = ERR_COMPILER_INTERNAL;
+                    ctx->error = ERR_COMPILER_INTERNAL;
                     return;
                 }
             
@@ -400,20 +405,20 @@ void function_header(Tparser* parser, TNode** current_node) {
                 break;
                 
             } else {
-                error = ERR_SYNTAX;
+                ctx->error = ERR_SYNTAX;
                 return;
             }
         case TOKEN_BRACKET_SQUARE_LEFT: //checking for pub fn name() ->[<-]u8{
             
             if(!symtable_get_data(parser->global_symtable, (*current_node)->data.nodeData.function.identifier, &param_data)){
-                error = ERR_COMPILER_INTERNAL;
+                ctx->error = ERR_COMPILER_INTERNAL;
                 return;
             }
             param_data.function.return_type = U8_SLICE_T;
             if(has_qmark == 1)
                 param_data.function.is_null_type = true;
             if(!symtable_insert(parser->global_symtable, (*current_node)->data.nodeData.function.identifier, param_data)){
-                error = ERR_COMPILER_INTERNAL;
+                ctx->error = ERR_COMPILER_INTERNAL;
                 return;
             }
             
@@ -423,17 +428,19 @@ void function_header(Tparser* parser, TNode** current_node) {
             break;
             
         default:
-            error = ERR_SYNTAX;
+            ctx->error = ERR_SYNTAX;
             return;
         }
         break;
     case STATE_open_body_check:
         if (parser->current_token.id == TOKEN_BRACKET_CURLY_LEFT) { //checking for pub fn name() type->{<-
+            if (parser->headers_only)
+                break;
             parser->state = STATE_command;
             body(parser, &(*current_node)->right);
             break;
         }
-        error = ERR_SYNTAX;
+        ctx->error = ERR_SYNTAX;
         break;
     case STATE_ls_bracket:
         if (parser->current_token.id == TOKEN_BRACKET_SQUARE_RIGHT) { //checking for pub fn name() [->]<-u8{
@@ -442,7 +449,7 @@ void function_header(Tparser* parser, TNode** current_node) {
 
             break;
         }
-        error = ERR_SYNTAX;
+        ctx->error = ERR_SYNTAX;
         break;
     case STATE_u8:
         if (parser->current_token.id == TOKEN_KW_U8) { //checking for pub fn name() []->u8<-{
@@ -452,11 +459,11 @@ void function_header(Tparser* parser, TNode** current_node) {
 
             break;
         }
-        error = ERR_SYNTAX;
+        ctx->error = ERR_SYNTAX;
         break;
 
     default:
-        error = ERR_SYNTAX;
+        ctx->error = ERR_SYNTAX;
     }
     return;
 }
@@ -467,7 +474,7 @@ void function_header(Tparser* parser, TNode** current_node) {
  * @param parser, holds the current token, symtables, binary tree and the current state of the FSM
  */
 void function_params(Tparser* parser, TNode** current_node) {
-    if (error) return;
+    if (ctx->error) return;
     
     TData param_data;
 
@@ -485,13 +492,13 @@ void function_params(Tparser* parser, TNode** current_node) {
             parser->processed_identifier = parser->current_token.lexeme.array;
             
             if(!insert_llist(&(*current_node)->data.nodeData.function.param_identifiers, parser->processed_identifier)){
-                error = ERR_COMPILER_INTERNAL;
+                ctx->error = ERR_COMPILER_INTERNAL;
                 return;
             }
             
             param_data = declaration_data(false, true, UNKNOWN_T);
             if(!symtable_insert(parser->scope.current_scope, parser->processed_identifier, param_data)){
-                error = ERR_COMPILER_INTERNAL;
+                ctx->error = ERR_COMPILER_INTERNAL;
                 return;
             }
             
@@ -500,7 +507,7 @@ void function_params(Tparser* parser, TNode** current_node) {
             break;
             
         default:
-            error = ERR_SYNTAX;
+            ctx->error = ERR_SYNTAX;
             return;
         }
         break;
@@ -510,7 +517,7 @@ void function_params(Tparser* parser, TNode** current_node) {
             function_params(parser, current_node);
             break;
         }
-        error = ERR_SYNTAX;
+        ctx->error = ERR_SYNTAX;
         break;
     case STATE_possible_qmark:
         switch (parser->current_token.id) { //checking for pub fn name(param : ?type) type{
@@ -521,24 +528,24 @@ void function_params(Tparser* parser, TNode** current_node) {
         case TOKEN_KW_I32: //checking for pub fn name(param : ->i32<-) type{
             
             if(!symtable_get_data(parser->scope.current_scope, parser->processed_identifier, &param_data)){
-                error = ERR_COMPILER_INTERNAL;
+                ctx->error = ERR_COMPILER_INTERNAL;
                 return;
             }
             
             //setting the type of the parameter in the symtable
             param_data.variable.type = INTEGER_T;
             if(!symtable_insert(parser->scope.current_scope, parser->processed_identifier, param_data)){
-                error = ERR_COMPILER_INTERNAL;
+                ctx->error = ERR_COMPILER_INTERNAL;
                 return;
             }
             
             if(!symtable_get_data(parser->global_symtable, (*current_node)->data.nodeData.function.identifier, &param_data)){
-                error = ERR_COMPILER_INTERNAL;
+                ctx->error = ERR_COMPILER_INTERNAL;
                 return;
             }
             d_array_append(&param_data.function.argument_types, 'i');
             if(!symtable_insert(parser->global_symtable, (*current_node)->data.nodeData.function.identifier, param_data)){
-                error = ERR_COMPILER_INTERNAL;
+                ctx->error = ERR_COMPILER_INTERNAL;
                 return;
             }
             
@@ -549,24 +556,24 @@ void function_params(Tparser* parser, TNode** current_node) {
         case TOKEN_KW_F64: //checking for pub fn name(param : ->f64<-) type{
         
             if(!symtable_get_data(parser->scope.current_scope, parser->processed_identifier, &param_data)){
-                error = ERR_COMPILER_INTERNAL;
+                ctx->error = ERR_COMPILER_INTERNAL;
                 return;
             }
             
             //setting the type of the parameter in the symtable
             param_data.variable.type = FLOAT_T;
             if(!symtable_insert(parser->scope.current_scope, parser->processed_identifier, param_data)){
-                error = ERR_COMPILER_INTERNAL;
+                ctx->error = ERR_COMPILER_INTERNAL;
                 return;
             }
             
             if(!symtable_get_data(parser->global_symtable, (*current_node)->data.nodeData.function.identifier, &param_data)){
-                error = ERR_COMPILER_INTERNAL;
+                ctx->error = ERR_COMPILER_INTERNAL;
                 return;
             }
             d_array_append(&param_data.function.argument_types, 'f');
             if(!symtable_insert(parser->global_symtable, (*current_node)->data.nodeData.function.identifier, param_data)){
-                error = ERR_COMPILER_INTERNAL;
+                ctx->error = ERR_COMPILER_INTERNAL;
                 return;
             }
         
@@ -577,24 +584,24 @@ void function_params(Tparser* parser, TNode** current_node) {
         case TOKEN_BRACKET_SQUARE_LEFT: //checking for pub fn name(param : ->[<-]u8) type{
           
             if(!symtable_get_data(parser->scope.current_scope, parser->processed_identifier, &param_data)){
-                error = ERR_COMPILER_INTERNAL;
+                ctx->error = ERR_COMPILER_INTERNAL;
                 return;
             }
             
             //setting the type of the parameter in the symtable
             param_data.variable.type = U8_SLICE_T;
             if(!symtable_insert(parser->scope.current_scope, parser->processed_identifier, param_data)){
-                error = ERR_COMPILER_INTERNAL;
+                ctx->error = ERR_COMPILER_INTERNAL;
                 return;
             }
             
             if(!symtable_get_data(parser->global_symtable, (*current_node)->data.nodeData.function.identifier, &param_data)){
-                error = ERR_COMPILER_INTERNAL;
+                ctx->error = ERR_COMPILER_INTERNAL;
                 return;
             }
             d_array_append(&param_data.function.argument_types, 'u');
             if(!symtable_insert(parser->global_symtable, (*current_node)->data.nodeData.function.identifier, param_data)){
-                error = ERR_COMPILER_INTERNAL;
+                ctx->error = ERR_COMPILER_INTERNAL;
                 return;
             }
         
@@ -603,7 +610,7 @@ void function_params(Tparser* parser, TNode** current_node) {
             break;
             
         default:
-            error = ERR_SYNTAX;
+            ctx->error = ERR_SYNTAX;
             break;
         }
         break;
@@ -612,7 +619,7 @@ void function_params(Tparser* parser, TNode** current_node) {
         case TOKEN_KW_I32: //checking for pub fn name(param : ->i32<-) type{
           
             if(!symtable_get_data(parser->scope.current_scope, parser->processed_identifier, &param_data)){
-                error = ERR_COMPILER_INTERNAL;
+                ctx->error = ERR_COMPILER_INTERNAL;
                 return;
             }
             
@@ -620,17 +627,17 @@ void function_params(Tparser* parser, TNode** current_node) {
             param_data.variable.type = INTEGER_T;
             param_data.variable.is_null_type = true;
             if(!symtable_insert(parser->scope.current_scope, parser->processed_identifier, param_data)){
-                error = ERR_COMPILER_INTERNAL;
+                ctx->error = ERR_COMPILER_INTERNAL;
                 return;
             }
             
             if(!symtable_get_data(parser->global_symtable, (*current_node)->data.nodeData.function.identifier, &param_data)){
-                error = ERR_COMPILER_INTERNAL;
+                ctx->error = ERR_COMPILER_INTERNAL;
                 return;
             }
             d_array_append(&param_data.function.argument_types, 'i');
             if(!symtable_insert(parser->global_symtable, (*current_node)->data.nodeData.function.identifier, param_data)){
-                error = ERR_COMPILER_INTERNAL;
+                ctx->error = ERR_COMPILER_INTERNAL;
                 return;
             }
           
@@ -641,7 +648,7 @@ void function_params(Tparser* parser, TNode** current_node) {
         case TOKEN_KW_F64: //checking for pub fn name(param : ->f64<-) type{
         
             if(!symtable_get_data(parser->scope.current_scope, parser->processed_identifier, &param_data)){
-                error = ERR_COMPILER_INTERNAL;
+                ctx->error = ERR_COMPILER_INTERNAL;
                 return;
             }
             
@@ -649,17 +656,17 @@ void function_params(Tparser* parser, TNode** current_node) {
             param_data.variable.type = FLOAT_T;
             param_data.variable.is_null_type = true;
             if(!symtable_insert(parser->scope.current_scope, parser->processed_identifier, param_data)){
-                error = ERR_COMPILER_INTERNAL;
+                ctx->error = ERR_COMPILER_INTERNAL;
                 return;
             }
             
             if(!symtable_get_data(parser->global_symtable, (*current_node)->data.nodeData.function.identifier, &param_data)){
-                error = ERR_COMPILER_INTERNAL;
+                ctx->error = ERR_COMPILER_INTERNAL;
                 return;
             }
             d_array_append(&param_data.function.argument_types, 'f');
             if(!symtable_insert(parser->global_symtable, (*current_node)->data.nodeData.function.identifier, param_data)){
-                error = ERR_COMPILER_INTERNAL;
+                ctx->error = ERR_COMPILER_INTERNAL;
                 return;
             }
         
@@ -670,7 +677,7 @@ void function_params(Tparser* parser, TNode** current_node) {
         case TOKEN_BRACKET_SQUARE_LEFT: //checking for pub fn name(param : ->[<-]u8) type{
         
             if(!symtable_get_data(parser->scope.current_scope, parser->processed_identifier, &param_data)){
-                error = ERR_COMPILER_INTERNAL;
+                ctx->error = ERR_COMPILER_INTERNAL;
                 return;
             }
             
@@ -678,17 +685,17 @@ void function_params(Tparser* parser, TNode** current_node) {
             param_data.variable.type = U8_SLICE_T;
             param_data.variable.is_null_type = true;
             if(!symtable_insert(parser->scope.current_scope, parser->processed_identifier, param_data)){
-                error = ERR_COMPILER_INTERNAL;
+                ctx->error = ERR_COMPILER_INTERNAL;
                 return;
             }
             
             if(!symtable_get_data(parser->global_symtable, (*current_node)->data.nodeData.function.identifier, &param_data)){
-                error = ERR_COMPILER_INTERNAL;
+                ctx->error = ERR_COMPILER_INTERNAL;
                 return;
             }
             d_array_append(&param_data.function.argument_types, 'u');
             if(!symtable_insert(parser->global_symtable, (*current_node)->data.nodeData.function.identifier, param_data)){
-                error = ERR_COMPILER_INTERNAL;
+                ctx->error = ERR_COMPILER_INTERNAL;
                 return;
             }
         
@@ -697,7 +704,7 @@ void function_params(Tparser* parser, TNode** current_node) {
             break;
             
         default:
-            error = ERR_SYNTAX;
+            ctx->error = ERR_SYNTAX;
             return;
         }
         break;
@@ -710,18 +717,18 @@ void function_params(Tparser* parser, TNode** current_node) {
             parser->processed_identifier = parser->current_token.lexeme.array;
             
             if(!insert_llist(&(*current_node)->data.nodeData.function.param_identifiers, parser->processed_identifier)){
-                error = ERR_COMPILER_INTERNAL;
+                ctx->error = ERR_COMPILER_INTERNAL;
                 return;
             }
             if( symtable_search(parser->scope.current_scope, parser->processed_identifier) ){
-                error = ERR_IDENTIFIER_REDEF_CONST_ASSIGN;
+                ctx->error = ERR_IDENTIFIER_REDEF_CONST_ASSIGN;
                 return;
             }
             
             TData param_data;
             param_data = declaration_data(false, true, UNKNOWN_T);
             if(!symtable_insert(parser->scope.current_scope, parser->processed_identifier, param_data)){
-                error = ERR_COMPILER_INTERNAL;
+                ctx->error = ERR_COMPILER_INTERNAL;
                 return;
             }
         
@@ -730,7 +737,7 @@ void function_params(Tparser* parser, TNode** current_node) {
             break;
             
         default:
-            error = ERR_SYNTAX;
+            ctx->error = ERR_SYNTAX;
             return;
         }
         break;
@@ -743,7 +750,7 @@ void function_params(Tparser* parser, TNode** current_node) {
         case TOKEN_BRACKET_ROUND_RIGHT: //checking for pub fn name(param : type ->)<- type{
             break;
         default:
-            error = ERR_SYNTAX;
+            ctx->error = ERR_SYNTAX;
             return;
         }
         break;
@@ -753,7 +760,7 @@ void function_params(Tparser* parser, TNode** current_node) {
             function_params(parser, current_node);
             break;
         }
-        error = ERR_SYNTAX;
+        ctx->error = ERR_SYNTAX;
         break;
     case STATE_u8:
         if (parser->current_token.id == TOKEN_KW_U8) { //checking for pub fn name(param : []->u8<-) type{
@@ -761,11 +768,11 @@ void function_params(Tparser* parser, TNode** current_node) {
             function_params(parser, current_node);
             break;
         }
-        error = ERR_SYNTAX;
+        ctx->error = ERR_SYNTAX;
         break;
 
     default:
-        error = ERR_SYNTAX;
+        ctx->error = ERR_SYNTAX;
     }
 
     return;
@@ -782,7 +789,7 @@ void body(Tparser* parser, TNode** current_node) {
     
     TSymtable* identifier_residence;
 
-    if (error) return;
+    if (ctx->error) return;
 
     if ((parser->current_token = get_token()).id == TOKEN_ERROR) // Token is invalid
         return;
@@ -795,21 +802,21 @@ void body(Tparser* parser, TNode** current_node) {
         
             parser->state = STATE_lr_bracket;
             if_while_header(parser, &(*current_node)->left, IF);
-            if (error) return;
+            if (ctx->error) return;
             
             leave_sub_body(parser);
-            if (error) return;
+            if (ctx->error) return;
             
             parser->state = STATE_possible_else;
             body(parser, &(*current_node)->right);
-            if (error) return;
+            if (ctx->error) return;
             break;
             
         case TOKEN_DISCARD_RESULT:  // -> _ <- = expression|function
             if ((parser->current_token = get_token()).id == TOKEN_ERROR) // Token is invalid
                 return;
             if (parser->current_token.id != TOKEN_ASSIGNMENT) {
-                error = ERR_SYNTAX;
+                ctx->error = ERR_SYNTAX;
                 return;
             } else {
             
@@ -822,13 +829,13 @@ void body(Tparser* parser, TNode** current_node) {
                 expression(parser, TOKEN_SEMICOLON, &(*current_node)->left->left, false);
 
                 //set data type for local_databased on expression result
-                if (error) {
+                if (ctx->error) {
                     return;
                 }
             }
             parser->state = STATE_command;
             body(parser, &(*current_node)->right);
-            if (error) return;
+            if (ctx->error) return;
             break;
         case TOKEN_KW_RETURN: // -> return <- expression;
             (*current_node)->left = create_node(RETURN);
@@ -838,7 +845,7 @@ void body(Tparser* parser, TNode** current_node) {
             /* Expression */
             expression(parser, TOKEN_SEMICOLON, &(*current_node)->left->left, true);
 
-            if (error) {
+            if (ctx->error) {
                 return;
             }
 
@@ -848,14 +855,14 @@ void body(Tparser* parser, TNode** current_node) {
         case TOKEN_BRACKET_CURLY_LEFT: // -> { <- body } ...
         
             enter_sub_body(parser);
-            if (error) return;
+            if (ctx->error) return;
 
             (*current_node)->left = create_node(BODY);
 
             (*current_node)->left->data.nodeData.body.current_scope = (scope_t*) malloc(sizeof(scope_t));
 
             if ((*current_node)->left->data.nodeData.body.current_scope == NULL) {
-                error = ERR_COMPILER_INTERNAL;
+                ctx->error = ERR_COMPILER_INTERNAL;
                 return;
             }
 
@@ -863,10 +870,10 @@ void body(Tparser* parser, TNode** current_node) {
            
             parser->state = STATE_command;
             body(parser, &(*current_node)->left->right);
-            if (error) return;
+            if (ctx->error) return;
             
             leave_sub_body(parser);
-            if (error) return;
+            if (ctx->error) return;
             
             parser->state = STATE_command;
             body(parser, &(*current_node)->right);
@@ -875,25 +882,25 @@ void body(Tparser* parser, TNode** current_node) {
         
             parser->state = STATE_lr_bracket;
             if_while_header(parser, &(*current_node)->left, WHILE);
-            if (error) return;
+            if (ctx->error) return;
             
             leave_sub_body(parser);
-            if (error) return;
+            if (ctx->error) return;
             
             parser->state = STATE_command;
             body(parser, &(*current_node)->right);
-            if (error) return;
+            if (ctx->error) return;
             break;
             
         case TOKEN_KW_VAR: // -> var <- id : type = ...
         
             parser->state = STATE_identifier;
             var_const_declaration(parser, &(*current_node)->left, VAR_DECL);
-            if (error) return;
+            if (ctx->error) return;
             
             parser->state = STATE_command;
             body(parser, &(*current_node)->right);
-            if (error)
+            if (ctx->error)
                 return;
             break;
             
@@ -901,11 +908,11 @@ void body(Tparser* parser, TNode** current_node) {
         
             parser->state = STATE_identifier;
             var_const_declaration(parser, &(*current_node)->left, CONST_DECL);
-            if (error) return;
+            if (ctx->error) return;
             
             parser->state = STATE_command;
             body(parser, &(*current_node)->right);
-            if (error)
+            if (ctx->error)
                 return;
             break;
             
@@ -917,13 +924,13 @@ void body(Tparser* parser, TNode** current_node) {
             if (parser->current_token.id == TOKEN_ASSIGNMENT) { // identifier -> = <- expression ...
             
                 if((identifier_residence = declaration_var_check(parser->scope, parser->processed_identifier)) == NULL){
-                    error = ERR_UNDEFINED_IDENTIFIER;
+                    ctx->error = ERR_UNDEFINED_IDENTIFIER;
                     return;
                 }
                 
                 symtable_get_data(identifier_residence, parser->processed_identifier, &retrieved_data);
                 if( retrieved_data.variable.is_constant ){
-                    error = ERR_IDENTIFIER_REDEF_CONST_ASSIGN;
+                    ctx->error = ERR_IDENTIFIER_REDEF_CONST_ASSIGN;
                     return;
                 }
                 
@@ -931,7 +938,7 @@ void body(Tparser* parser, TNode** current_node) {
                 retrieved_data.variable.is_mutated = true;
                 
                 if(!symtable_insert(identifier_residence, parser->processed_identifier, retrieved_data)){
-                    error = ERR_COMPILER_INTERNAL;
+                    ctx->error = ERR_COMPILER_INTERNAL;
                     return;
                 }
             
@@ -944,7 +951,7 @@ void body(Tparser* parser, TNode** current_node) {
                 expression(parser, TOKEN_SEMICOLON, &(*current_node)->left->left, false);
 
                 //set data type for local_databased on expression result
-                if (error) {
+                if (ctx->error) {
                     return;
                 }
             }
@@ -955,7 +962,7 @@ void body(Tparser* parser, TNode** current_node) {
                 parser->state = STATE_identifier;
                 function_call(parser, &(*current_node)->left);
                 
-                if (error)
+                if (ctx->error)
                     return;
                     
                 if ((parser->current_token = get_token()).id == TOKEN_ERROR) // Token is invalid
@@ -963,7 +970,7 @@ void body(Tparser* parser, TNode** current_node) {
 
                 
                 if (parser->current_token.id != TOKEN_SEMICOLON) {
-                    error = ERR_SYNTAX;
+                    ctx->error = ERR_SYNTAX;
                     return;
                 }
             }
@@ -972,29 +979,29 @@ void body(Tparser* parser, TNode** current_node) {
                 (*current_node)->left->data.nodeData.identifier.identifier = parser->processed_identifier;
                 parser->state = STATE_identifier;
                 function_call_params(parser, &(*current_node)->left->right);
-                if (error)
+                if (ctx->error)
                     return;
                 if ((parser->current_token = get_token()).id == TOKEN_ERROR) // Token is invalid
                     return;
                 if (parser->current_token.id != TOKEN_SEMICOLON) {
-                    error = ERR_SYNTAX;
+                    ctx->error = ERR_SYNTAX;
                     return;
                 }
             }
             else {
-                error = ERR_SYNTAX;
+                ctx->error = ERR_SYNTAX;
                 return;
             }
             parser->state = STATE_command;
             body(parser, &(*current_node)->right);
-            if (error) return;
+            if (ctx->error) return;
             break;
         case TOKEN_BRACKET_CURLY_RIGHT:
             free(*current_node);
             *current_node = NULL;
             break;
         default:
-            error = ERR_SYNTAX;
+            ctx->error = ERR_SYNTAX;
             return;
         }
         break;
@@ -1004,14 +1011,14 @@ void body(Tparser* parser, TNode** current_node) {
         case TOKEN_BRACKET_CURLY_LEFT: // -> { <- body } ...
         
             enter_sub_body(parser);
-            if (error) return;
+            if (ctx->error) return;
 
             (*current_node)->left = create_node(ELSE);
 
             (*current_node)->left->data.nodeData.body.current_scope = (scope_t*) malloc(sizeof(scope_t));
 
             if ((*current_node)->left->data.nodeData.body.current_scope == NULL) {
-                error = ERR_COMPILER_INTERNAL;
+                ctx->error = ERR_COMPILER_INTERNAL;
                 return;
             }
 
@@ -1019,21 +1026,21 @@ void body(Tparser* parser, TNode** current_node) {
             
             parser->state = STATE_command;
             body(parser, &(*current_node)->left->right);
-            if (error) return;
+            if (ctx->error) return;
             
             leave_sub_body(parser);
-            if (error) return;
+            if (ctx->error) return;
             
             
             parser->state = STATE_command;
             body(parser, &(*current_node)->right);
-            if (error) return;
+            if (ctx->error) return;
             break;
         case TOKEN_DISCARD_RESULT: // -> _ <- = expression|function
             if ((parser->current_token = get_token()).id == TOKEN_ERROR) // Token is invalid
                 return;
             if (parser->current_token.id != TOKEN_ASSIGNMENT) {
-                error = ERR_SYNTAX;
+                ctx->error = ERR_SYNTAX;
                 return;
             } else {
             
@@ -1046,25 +1053,25 @@ void body(Tparser* parser, TNode** current_node) {
                 expression(parser, TOKEN_SEMICOLON, &(*current_node)->left->left, false);
 
                 //set data type for local_databased on expression result
-                if (error) {
+                if (ctx->error) {
                     return;
                 }
             }
             parser->state = STATE_command;
             body(parser, &(*current_node)->right);
-            if (error) return;
+            if (ctx->error) return;
             break;
         case TOKEN_KW_ELSE://checking for ..} ->else<- { ..
         
             enter_sub_body(parser);
-            if (error) return;
+            if (ctx->error) return;
         
             (*current_node)->left = create_node(ELSE);
             
             (*current_node)->left->data.nodeData.body.current_scope = (scope_t*) malloc(sizeof(scope_t));
 
             if ((*current_node)->left->data.nodeData.body.current_scope == NULL) {
-                error = ERR_COMPILER_INTERNAL;
+                ctx->error = ERR_COMPILER_INTERNAL;
                 return;
             }
 
@@ -1072,41 +1079,41 @@ void body(Tparser* parser, TNode** current_node) {
 
             parser->state = STATE_open_else;
             body(parser, &(*current_node)->left->right);
-            if (error) return;
+            if (ctx->error) return;
             
             leave_sub_body(parser);
-            if (error) return;
+            if (ctx->error) return;
             
             parser->state = STATE_command;
             body(parser, &(*current_node)->right);
-            if (error) return;
+            if (ctx->error) return;
             break;
             
         case TOKEN_KW_IF: // -> if <- (expression) |replacement| {...
         
             parser->state = STATE_lr_bracket;
             if_while_header(parser, &(*current_node)->left, IF);
-            if (error) return;
+            if (ctx->error) return;
             
             leave_sub_body(parser);
-            if (error) return;
+            if (ctx->error) return;
             
             parser->state = STATE_possible_else;
             body(parser, &(*current_node)->right);
-            if (error) return;
+            if (ctx->error) return;
             break;
             
         case TOKEN_KW_WHILE: // -> while <- (expression) |replacement| {...
             parser->state = STATE_lr_bracket;
             if_while_header(parser, &(*current_node)->left, WHILE);
-            if (error) return;
+            if (ctx->error) return;
             
             leave_sub_body(parser);
-            if (error) return;
+            if (ctx->error) return;
             
             parser->state = STATE_command;
             body(parser, &(*current_node)->right);
-            if (error) return;
+            if (ctx->error) return;
             break;
             
         case TOKEN_KW_RETURN: // -> return <- expression;
@@ -1116,27 +1123,27 @@ void body(Tparser* parser, TNode** current_node) {
 
             /* Expression */
             expression(parser, TOKEN_SEMICOLON, &(*current_node)->left->left, true);
-            if (error) return;
+            if (ctx->error) return;
 
             parser->state = STATE_command;
             body(parser, &(*current_node)->right);
-            if (error) return;
+            if (ctx->error) return;
             break;
         case TOKEN_KW_VAR: // -> var <- id : type = ...
             parser->state = STATE_identifier;
             var_const_declaration(parser, &(*current_node)->left, VAR_DECL);
-            if (error) return;
+            if (ctx->error) return;
             parser->state = STATE_command;
             body(parser, &(*current_node)->right);
-            if (error) return;
+            if (ctx->error) return;
             break;
         case TOKEN_KW_CONST: // -> const <- id : type = ...
             parser->state = STATE_identifier;
             var_const_declaration(parser, &(*current_node)->left, CONST_DECL);
-            if (error) return;
+            if (ctx->error) return;
             parser->state = STATE_command;
             body(parser, &(*current_node)->right);
-            if (error) return;
+            if (ctx->error) return;
             break;
         case TOKEN_IDENTIFIER: // -> identifier <- ...
             //TODO add the expression
@@ -1148,13 +1155,13 @@ void body(Tparser* parser, TNode** current_node) {
             if (parser->current_token.id == TOKEN_ASSIGNMENT) { // identifier -> = <- expression ...
             
                 if((identifier_residence = declaration_var_check(parser->scope, parser->processed_identifier)) == NULL){
-                    error = ERR_UNDEFINED_IDENTIFIER;
+                    ctx->error = ERR_UNDEFINED_IDENTIFIER;
                     return;
                 }
                 
                 symtable_get_data(identifier_residence, parser->processed_identifier, &retrieved_data);
                 if( retrieved_data.variable.is_constant ){
-                    error = ERR_IDENTIFIER_REDEF_CONST_ASSIGN;
+                    ctx->error = ERR_IDENTIFIER_REDEF_CONST_ASSIGN;
                     return;
                 }
                 
@@ -1162,7 +1169,7 @@ void body(Tparser* parser, TNode** current_node) {
                 retrieved_data.variable.is_mutated = true;
                 
                 if(!symtable_insert(identifier_residence, parser->processed_identifier, retrieved_data)){
-                    error = ERR_COMPILER_INTERNAL;
+                    ctx->error = ERR_COMPILER_INTERNAL;
                     return;
                 }
             
@@ -1173,18 +1180,18 @@ void body(Tparser* parser, TNode** current_node) {
                 parser->state = STATE_operand;
                 /* Expression */
                 expression(parser, TOKEN_SEMICOLON, &(*current_node)->left->left, false);
-                if (error) return;
+                if (ctx->error) return;
             }
             else if (parser->current_token.id == TOKEN_ACCESS_OPERATOR) { // identifier -> . <- function ...
                 (*current_node)->left = create_node(FUNCTION_CALL);
                 parser->state = STATE_identifier;
                 function_call(parser, &(*current_node)->left);
-                if (error) return;
+                if (ctx->error) return;
 
                 if ((parser->current_token = get_token()).id == TOKEN_ERROR) // Token is invalid
                     return;
                 if (parser->current_token.id != TOKEN_SEMICOLON) {
-                    error = ERR_SYNTAX;
+                    ctx->error = ERR_SYNTAX;
                     return;
                 }
             }
@@ -1193,39 +1200,39 @@ void body(Tparser* parser, TNode** current_node) {
                 (*current_node)->left->data.nodeData.identifier.identifier = parser->processed_identifier;
                 parser->state = STATE_identifier;
                 function_call_params(parser, &(*current_node)->left->right);
-                if (error)
+                if (ctx->error)
                     return;
                 if ((parser->current_token = get_token()).id == TOKEN_ERROR) // Token is invalid
                     return;
                 if (parser->current_token.id != TOKEN_SEMICOLON) {
-                    error = ERR_SYNTAX;
+                    ctx->error = ERR_SYNTAX;
                     return;
                 }
             }
             else {
-                error = ERR_SYNTAX;
+                ctx->error = ERR_SYNTAX;
                 return;
             }
             parser->state = STATE_command;
             body(parser, &(*current_node)->right);
-            if (error) return;
+            if (ctx->error) return;
             break;
         case TOKEN_BRACKET_CURLY_RIGHT: // ... -> } <-
             free(*current_node);
             *current_node = NULL;
             break;
         default:
-            error = ERR_SYNTAX;
+            ctx->error = ERR_SYNTAX;
             return;
         }
         break;
     case STATE_open_else:
             parser->state = STATE_command;
             body(parser, current_node);
-            if (error) return;
+            if (ctx->error) return;
             break;
     default:
-        error = ERR_SYNTAX;
+        ctx->error = ERR_SYNTAX;
         return;
     }
     return;
@@ -1237,7 +1244,7 @@ void body(Tparser* parser, TNode** current_node) {
  * @param parser, holds the current token, symtables, binary tree and the current state of the FSM
  */
 void if_while_header(Tparser* parser, TNode** current_node, node_type type) {
-    if (error) return;
+    if (ctx->error) return;
     if ((parser->current_token = get_token()).id == TOKEN_ERROR) // Token is invalid
         return;
 
@@ -1246,14 +1253,14 @@ void if_while_header(Tparser* parser, TNode** current_node, node_type type) {
         if (parser->current_token.id == TOKEN_BRACKET_ROUND_LEFT) { //checking for if ->(<-expression) |null_replacement| {
 
             enter_sub_body(parser);
-            if (error) return;
+            if (ctx->error) return;
         
             (*current_node) = create_node(type);
 
             (*current_node)->data.nodeData.body.current_scope = (scope_t*) malloc(sizeof(scope_t));
 
             if ((*current_node)->data.nodeData.body.current_scope == NULL) {
-                error = ERR_COMPILER_INTERNAL;
+                ctx->error = ERR_COMPILER_INTERNAL;
                 return;
             }
 
@@ -1262,13 +1269,13 @@ void if_while_header(Tparser* parser, TNode** current_node, node_type type) {
 
             /* Expression */
             expression(parser, TOKEN_BRACKET_ROUND_RIGHT, &(*current_node)->left, false);
-            if (error) return;
+            if (ctx->error) return;
 
             parser->state = STATE_pipe;
             if_while_header(parser, current_node, type);
             break;
         }
-        error = ERR_SYNTAX;
+        ctx->error = ERR_SYNTAX;
         break;
     case STATE_pipe:
         switch (parser->current_token.id) {
@@ -1286,7 +1293,7 @@ void if_while_header(Tparser* parser, TNode** current_node, node_type type) {
             body(parser, &(*current_node)->right);
             break;
         default:
-            error = ERR_SYNTAX;
+            ctx->error = ERR_SYNTAX;
             return;
         }
         break;
@@ -1296,10 +1303,10 @@ void if_while_header(Tparser* parser, TNode** current_node, node_type type) {
             body(parser, &(*current_node)->right);
             break;
         }
-        error = ERR_SYNTAX;
+        ctx->error = ERR_SYNTAX;
         break;
     default:
-        error = ERR_SYNTAX;
+        ctx->error = ERR_SYNTAX;
         return;
     }
 
@@ -1312,7 +1319,7 @@ void if_while_header(Tparser* parser, TNode** current_node, node_type type) {
  * @param parser, holds the current token, symtables, binary tree and the current state of the FSM
  */
 void null_replacement(Tparser* parser, TNode** current_node) {
-    if (error) return;
+    if (ctx->error) return;
     
     TData nonull_data;
 
@@ -1325,7 +1332,7 @@ void null_replacement(Tparser* parser, TNode** current_node) {
         
             nonull_data = declaration_data(false,true,UNKNOWN_T);
             if(!symtable_insert(parser->scope.current_scope, parser->current_token.lexeme.array, nonull_data)){
-                error = ERR_COMPILER_INTERNAL;
+                ctx->error = ERR_COMPILER_INTERNAL;
                 return;
             }
         
@@ -1337,16 +1344,16 @@ void null_replacement(Tparser* parser, TNode** current_node) {
             break;
             
         }
-        error = ERR_SYNTAX;
+        ctx->error = ERR_SYNTAX;
         break;
     case STATE_pipe:
         if (parser->current_token.id == TOKEN_PIPE) { //checking for if/while (expression) |null_replacement->|<- {
             break;
         }
-        error = ERR_SYNTAX;
+        ctx->error = ERR_SYNTAX;
         break;
     default:
-        error = ERR_SYNTAX;
+        ctx->error = ERR_SYNTAX;
         return;
     }
     return;
@@ -1364,7 +1371,7 @@ void var_const_declaration(Tparser* parser, TNode** current_node, node_type type
     
     TSymtable* identifier_residence;
     
-    if (error) return;
+    if (ctx->error) return;
 
     if ((parser->current_token = get_token()).id == TOKEN_ERROR) // Token is invalid
         return;
@@ -1382,7 +1389,7 @@ void var_const_declaration(Tparser* parser, TNode** current_node, node_type type
         if (parser->current_token.id == TOKEN_IDENTIFIER) { //checking for var/const ->name<- = expression;
             
             if (declaration_var_check(parser->scope, parser->current_token.lexeme.array) != NULL) {
-                error = ERR_IDENTIFIER_REDEF_CONST_ASSIGN;
+                ctx->error = ERR_IDENTIFIER_REDEF_CONST_ASSIGN;
                 return;
             }
         
@@ -1395,7 +1402,7 @@ void var_const_declaration(Tparser* parser, TNode** current_node, node_type type
             var_const_declaration(parser, current_node, type);
             break;
         }
-        error = ERR_SYNTAX;
+        ctx->error = ERR_SYNTAX;
         break;
     case STATE_assig:
         if (parser->current_token.id == TOKEN_ASSIGNMENT) { //checking for var/const name ->=<- expression;
@@ -1403,7 +1410,7 @@ void var_const_declaration(Tparser* parser, TNode** current_node, node_type type
             symtable_data = declaration_data(false, constant, UNKNOWN_T);
             
             if(!symtable_insert(parser->scope.current_scope, parser->processed_identifier, symtable_data)){
-                error = ERR_COMPILER_INTERNAL;
+                ctx->error = ERR_COMPILER_INTERNAL;
                 return;
             }
                 
@@ -1412,7 +1419,7 @@ void var_const_declaration(Tparser* parser, TNode** current_node, node_type type
             /* Expression */
             expression(parser, TOKEN_SEMICOLON, &(*current_node)->left, false);
             //something to match the data type of the final expression result
-            if (error) {
+            if (ctx->error) {
                 return;
             }
             if ( (*current_node)->left->left == NULL && (*current_node)->left->right == NULL ) {
@@ -1421,12 +1428,12 @@ void var_const_declaration(Tparser* parser, TNode** current_node, node_type type
                     //setting the value in the node to the constants with single literal or variable inside them
                     if ( (*current_node)->left->type == VAR_CONST ) {
                         if((identifier_residence = declaration_var_check(parser->scope, (*current_node)->left->data.nodeData.value.identifier)) == NULL){
-                            error = ERR_COMPILER_INTERNAL;
+                            ctx->error = ERR_COMPILER_INTERNAL;
                             return;
                         }
                         
                         if(!symtable_get_data(identifier_residence, (*current_node)->left->data.nodeData.value.identifier, &retrieved_data)){
-                            error = ERR_COMPILER_INTERNAL;
+                            ctx->error = ERR_COMPILER_INTERNAL;
                             return;
                         }
                         
@@ -1437,26 +1444,26 @@ void var_const_declaration(Tparser* parser, TNode** current_node, node_type type
                         value_pointer = retrieved_data.variable.value_pointer;
                         
                         if(!symtable_get_data(parser->scope.current_scope, parser->processed_identifier, &retrieved_data)){
-                            error = ERR_COMPILER_INTERNAL;
+                            ctx->error = ERR_COMPILER_INTERNAL;
                             return;
                         }
                         
                         retrieved_data.variable.value_pointer = value_pointer;
                         
                         if(!symtable_insert(parser->scope.current_scope, parser->processed_identifier, retrieved_data)){
-                            error = ERR_COMPILER_INTERNAL;
+                            ctx->error = ERR_COMPILER_INTERNAL;
                             return;
                         }
                     }else{
                         if(!symtable_get_data(parser->scope.current_scope, parser->processed_identifier, &retrieved_data)){
-                            error = ERR_COMPILER_INTERNAL;
+                            ctx->error = ERR_COMPILER_INTERNAL;
                             return;
                         }
                         
                         retrieved_data.variable.value_pointer = (*current_node)->left;
                         
                         if(!symtable_insert(parser->scope.current_scope, parser->processed_identifier, retrieved_data)){
-                            error = ERR_COMPILER_INTERNAL;
+                            ctx->error = ERR_COMPILER_INTERNAL;
                             return;
                         }
                     }
@@ -1468,7 +1475,7 @@ void var_const_declaration(Tparser* parser, TNode** current_node, node_type type
             var_const_declaration(parser, current_node, type);
             break;
         }
-        error = ERR_SYNTAX;
+        ctx->error = ERR_SYNTAX;
         break;
     case STATE_possible_qmark:
             
@@ -1483,7 +1490,7 @@ void var_const_declaration(Tparser* parser, TNode** current_node, node_type type
             
             symtable_data = declaration_data(false, constant, INTEGER_T);
             if(!symtable_insert(parser->scope.current_scope, parser->processed_identifier, symtable_data)){
-                error = ERR_COMPILER_INTERNAL;
+                ctx->error = ERR_COMPILER_INTERNAL;
                 return;
             }
             
@@ -1495,7 +1502,7 @@ void var_const_declaration(Tparser* parser, TNode** current_node, node_type type
         
             symtable_data = declaration_data(false, constant, FLOAT_T);
             if(!symtable_insert(parser->scope.current_scope, parser->processed_identifier, symtable_data)){
-                error = ERR_COMPILER_INTERNAL;
+                ctx->error = ERR_COMPILER_INTERNAL;
                 return;
             }
         
@@ -1507,7 +1514,7 @@ void var_const_declaration(Tparser* parser, TNode** current_node, node_type type
         
             symtable_data = declaration_data(false, constant, U8_SLICE_T);
             if(!symtable_insert(parser->scope.current_scope, parser->processed_identifier, symtable_data)){
-                error = ERR_COMPILER_INTERNAL;
+                ctx->error = ERR_COMPILER_INTERNAL;
                 return;
             }
         
@@ -1516,7 +1523,7 @@ void var_const_declaration(Tparser* parser, TNode** current_node, node_type type
             break;
             
         default:
-            error = ERR_SYNTAX;
+            ctx->error = ERR_SYNTAX;
             break;
         }
         break;
@@ -1527,7 +1534,7 @@ void var_const_declaration(Tparser* parser, TNode** current_node, node_type type
         
             symtable_data = declaration_data(true, constant, INTEGER_T);
             if(!symtable_insert(parser->scope.current_scope, parser->processed_identifier, symtable_data)){
-                error = ERR_COMPILER_INTERNAL;
+                ctx->error = ERR_COMPILER_INTERNAL;
                 return;
             }
         
@@ -1539,7 +1546,7 @@ void var_const_declaration(Tparser* parser, TNode** current_node, node_type type
         
             symtable_data = declaration_data(true, constant, FLOAT_T);
             if(!symtable_insert(parser->scope.current_scope, parser->processed_identifier, symtable_data)){
-                error = ERR_COMPILER_INTERNAL;
+                ctx->error = ERR_COMPILER_INTERNAL;
                 return;
             }
         
@@ -1551,7 +1558,7 @@ void var_const_declaration(Tparser* parser, TNode** current_node, node_type type
         
             symtable_data = declaration_data(true, constant, U8_SLICE_T);
             if(!symtable_insert(parser->scope.current_scope, parser->processed_identifier, symtable_data)){
-                error = ERR_COMPILER_INTERNAL;
+                ctx->error = ERR_COMPILER_INTERNAL;
                 return;
             }
         
@@ -1560,7 +1567,7 @@ void var_const_declaration(Tparser* parser, TNode** current_node, node_type type
             break;
             
         default:
-            error = ERR_SYNTAX;
+            ctx->error = ERR_SYNTAX;
             break;
         }
         break;
@@ -1571,7 +1578,7 @@ void var_const_declaration(Tparser* parser, TNode** current_node, node_type type
             /* Expression */
             expression(parser, TOKEN_SEMICOLON, &(*current_node)->left, false);
 
-            if (error) {
+            if (ctx->error) {
                 return;
             }
           
@@ -1582,12 +1589,12 @@ void var_const_declaration(Tparser* parser, TNode** current_node, node_type type
                     //setting the value in the node to the constants with single literal or variable inside them
                     if ( (*current_node)->left->type == VAR_CONST ) {
                         if((identifier_residence = declaration_var_check(parser->scope, (*current_node)->left->data.nodeData.value.identifier)) == NULL){
-                            error = ERR_COMPILER_INTERNAL;
+                            ctx->error = ERR_COMPILER_INTERNAL;
                             return;
                         }
                         
                         if(!symtable_get_data(identifier_residence, (*current_node)->left->data.nodeData.value.identifier, &retrieved_data)){
-                            error = ERR_COMPILER_INTERNAL;
+                            ctx->error = ERR_COMPILER_INTERNAL;
                             return;
                         }
                         
@@ -1598,26 +1605,26 @@ void var_const_declaration(Tparser* parser, TNode** current_node, node_type type
                         value_pointer = retrieved_data.variable.value_pointer;
                         
                         if(!symtable_get_data(parser->scope.current_scope, parser->processed_identifier, &retrieved_data)){
-                            error = ERR_COMPILER_INTERNAL;
+                            ctx->error = ERR_COMPILER_INTERNAL;
                             return;
                         }
                         
                         retrieved_data.variable.value_pointer = value_pointer;
                         
                         if(!symtable_insert(parser->scope.current_scope, parser->processed_identifier, retrieved_data)){
-                            error = ERR_COMPILER_INTERNAL;
+                            ctx->error = ERR_COMPILER_INTERNAL;
                             return;
                         }
                     }else{
                         if(!symtable_get_data(parser->scope.current_scope, parser->processed_identifier, &retrieved_data)){
-                            error = ERR_COMPILER_INTERNAL;
+                            ctx->error = ERR_COMPILER_INTERNAL;
                             return;
                         }
                         
                         retrieved_data.variable.value_pointer = (*current_node)->left;
                         
                         if(!symtable_insert(parser->scope.current_scope, parser->processed_identifier, retrieved_data)){
-                            error = ERR_COMPILER_INTERNAL;
+                            ctx->error = ERR_COMPILER_INTERNAL;
                             return;
                         }
                     }
@@ -1625,7 +1632,7 @@ void var_const_declaration(Tparser* parser, TNode** current_node, node_type type
             }
             break;
         }
-        error = ERR_SYNTAX;
+        ctx->error = ERR_SYNTAX;
         break;
     case STATE_ls_bracket:
         if (parser->current_token.id == TOKEN_BRACKET_SQUARE_RIGHT) { // var/const name :[->]<-u8 =
@@ -1633,7 +1640,7 @@ void var_const_declaration(Tparser* parser, TNode** current_node, node_type type
             var_const_declaration(parser, current_node, type);
             break;
         }
-        error = ERR_SYNTAX;
+        ctx->error = ERR_SYNTAX;
         break;
     case STATE_u8:
         if (parser->current_token.id == TOKEN_KW_U8) { //var/const name :[]->u8<- =
@@ -1641,10 +1648,10 @@ void var_const_declaration(Tparser* parser, TNode** current_node, node_type type
             var_const_declaration(parser, current_node, type);
             break;
         }
-        error = ERR_SYNTAX;
+        ctx->error = ERR_SYNTAX;
         return;
     default:
-        error = ERR_SYNTAX;
+        ctx->error = ERR_SYNTAX;
         return;
     }
     return;
@@ -1656,7 +1663,7 @@ void var_const_declaration(Tparser* parser, TNode** current_node, node_type type
  * @param parser, holds the current token, symtables, binary tree and the current state of the FSM
  */
 void function_call(Tparser* parser, TNode** current_node) {
-    if (error) return;
+    if (ctx->error) return;
 
     if ((parser->current_token = get_token()).id == TOKEN_ERROR) // Token is invalid
         return;
@@ -1672,7 +1679,7 @@ void function_call(Tparser* parser, TNode** current_node) {
             break;
             
         }
-        error = ERR_SYNTAX;
+        ctx->error = ERR_SYNTAX;
         break;
     case STATE_lr_bracket:  // F(......
         if (parser->current_token.id == TOKEN_BRACKET_ROUND_LEFT) { //..something->(<-param,param,...)..
@@ -1680,10 +1687,10 @@ void function_call(Tparser* parser, TNode** current_node) {
             function_call_params(parser, &(*current_node)->right);
             break;
         }
-        error = ERR_SYNTAX;
+        ctx->error = ERR_SYNTAX;
         break;
     default:
-        error = ERR_SYNTAX;
+        ctx->error = ERR_SYNTAX;
         break;
         return;
     }
@@ -1695,7 +1702,7 @@ void function_call(Tparser* parser, TNode** current_node) {
  * @param parser, holds the current token, symtables, binary tree and the current state of the FSM
  */
 void function_call_params(Tparser* parser, TNode** current_node) {
-    if (error) return;
+    if (ctx->error) return;
 
     if ((parser->current_token = get_token()).id == TOKEN_ERROR) // Token is invalid
         return;
@@ -1735,7 +1742,7 @@ void function_call_params(Tparser* parser, TNode** current_node) {
             function_call_params(parser, &(*current_node)->right);
             break;
         default:
-            error = ERR_SYNTAX;
+            ctx->error = ERR_SYNTAX;
             return;
         }
         break;
@@ -1748,12 +1755,12 @@ void function_call_params(Tparser* parser, TNode** current_node) {
         case TOKEN_BRACKET_ROUND_RIGHT: // ...,params ->)<-
             return;
         default:
-            error = ERR_SYNTAX;
+            ctx->error = ERR_SYNTAX;
             return;
         }
         break;
     default:
-        error = ERR_SYNTAX;
+        ctx->error = ERR_SYNTAX;
         return;
     }
 
@@ -1779,7 +1786,7 @@ void function_call_params(Tparser* parser, TNode** current_node) {
 } while (0)
 
 void expression(Tparser* parser, token_id end, TNode **current_node, bool allow_empty) {
-    if (error)
+    if (ctx->error)
         return;
     // Potential issues:
     // var x = expr; <-- expr not epsilon (empty expression)
@@ -1814,7 +1821,7 @@ void expression(Tparser* parser, token_id end, TNode **current_node, bool allow_
             GET_TOKEN(); // Read third and last token, to ensure the statement is followed by corresponding end marker, no need to enqueue
 
             if(parser->current_token.id != TOKEN_SEMICOLON) {// Statement must be followed by a Semicolon at the end
-                error = ERR_SYNTAX;
+                ctx->error = ERR_SYNTAX;
                 return;
             }
 
@@ -1824,14 +1831,14 @@ void expression(Tparser* parser, token_id end, TNode **current_node, bool allow_
             char *id_2 = parser->current_token.lexeme.array; // Store second part of the function identifier
 
             if (parser->current_token.id != TOKEN_IDENTIFIER) { // ifj.'id' namespace must be followed by identifier
-                error = ERR_SYNTAX;
+                ctx->error = ERR_SYNTAX;
                 return;
             }
 
             GET_TOKEN(); // Read fourth token, must be left bracket
 
             if (parser->current_token.id != TOKEN_BRACKET_ROUND_LEFT) { // ifj.id'(' namespace must be followed by left bracket
-                error = ERR_SYNTAX;
+                ctx->error = ERR_SYNTAX;
                 return;
             }
 
@@ -1840,7 +1847,7 @@ void expression(Tparser* parser, token_id end, TNode **current_node, bool allow_
             char *full_id = func_id_concat(id, id_2); // Unite namespace and function id into 'namespace.id'
 
             if (full_id == NULL) {
-                error = ERR_SYNTAX;
+                ctx->error = ERR_SYNTAX;
                 return;
             }
 
@@ -1852,7 +1859,7 @@ void expression(Tparser* parser, token_id end, TNode **current_node, bool allow_
             GET_TOKEN(); // Read third and last token, to ensure the statement is followed by corresponding end marker, no need to enqueue
 
             if(parser->current_token.id != TOKEN_SEMICOLON) {// Statement must be followed by a Semicolon at the end
-                error = ERR_SYNTAX;
+                ctx->error = ERR_SYNTAX;
                 return;
             }
 
@@ -1894,7 +1901,7 @@ void populate_builtin_functions(TSymtable* global_symtable){
             d_array_append(&function_data.function.argument_types, function_input[param_type_index]);
 
             if((param_type_index++)>14){
-                error = ERR_COMPILER_INTERNAL;
+                ctx->error = ERR_COMPILER_INTERNAL;
                 return;
             }
         }
@@ -1902,7 +1909,7 @@ void populate_builtin_functions(TSymtable* global_symtable){
         function_data.function.function_scope = NULL;
         
         if(!symtable_insert(global_symtable, function_names[index], function_data)){
-            error = ERR_COMPILER_INTERNAL;
+            ctx->error = ERR_COMPILER_INTERNAL;
             return;
         }
         
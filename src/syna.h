@@ -66,6 +66,7 @@ typedef struct parser {
     scope_t scope; // current scope parser is in, parent scope of current scope
 
     TBinaryTree* AST;           // Abstract syntax tree thats being assembled
+    bool headers_only;          // function_header stops after the opening { of the body, used by the pre-scan of --stream
 } Tparser;
 
 /**
@@ -0,0 +1,60 @@
+#!/bin/sh
+# Compiles example and benchmark programs in one --batch run and by the IFJ24 executable one at a time,
+# generated code and exit codes have to match. Diagnostics of two failing programs have to be written to
+# the .err file of the program that caused them.
+# Usage: batch_differential.sh [jobs]
+
+DIR=$(dirname "$0")
+SRC="$DIR/.."
+JOBS=${1:-4}
+BUILD=$(mktemp -d)
+trap 'rm -rf "$BUILD"' EXIT
+
+make -s -C "$SRC" IFJ24 > /dev/null 2>&1 || { echo "build failed"; exit 1; }
+
+cat > "$BUILD/type_error.zig" << 'EOF'
+const ifj = @import("ifj24.zig");
+pub fn main() void {
+    var a: i32 = 1.5;
+    a = 2;
+}
+EOF
+cat > "$BUILD/syntax_error.zig" << 'EOF'
+const ifj = @import("ifj24.zig");
+pub fn main() void {
+    const a: i32 = 1 + ;
+}
+EOF
+
+failed=0
+for level in -O0 -O1; do
+	: > "$BUILD/list"
+	for program in "$DIR"/examples/*.zig "$DIR"/benchmarks/*.zig; do
+		cp "$program" "$BUILD/$(basename "$program")"
+		echo "$BUILD/$(basename "$program")" >> "$BUILD/list"
+	done
+	echo "$BUILD/type_error.zig" >> "$BUILD/list"
+	echo "$BUILD/syntax_error.zig" >> "$BUILD/list"
+	"$SRC/IFJ24" $level --batch "$BUILD/list" -j "$JOBS" > /dev/null 2>&1 || { echo "batch failed $level"; failed=1; }
+
+	while read -r program; do
+		"$SRC/IFJ24" $level < "$program" > "$BUILD/program.code" 2> /dev/null
+		rc=$?
+		[ $rc -ne 0 ] && : > "$BUILD/program.code"
+		if [ "$(cat "${program%.zig}.rc")" != "$rc" ] || ! cmp -s "${program%.zig}.code" "$BUILD/program.code"; then
+			echo "MISMATCH $level $program"
+			failed=1
+		fi
+	done < "$BUILD/list"
+
+	if ! grep -q "doesn't match" "$BUILD/type_error.err" || ! grep -q "(07)" "$BUILD/type_error.err" \
+		|| grep -q "subexpression\|(02)" "$BUILD/type_error.err" \
+		|| ! grep -q "subexpression" "$BUILD/syntax_error.err" || ! grep -q "(02)" "$BUILD/syntax_error.err" \
+		|| grep -q "doesn't match\|(07)" "$BUILD/syntax_error.err"; then
+		echo "DIAGNOSTICS $level"
+		head -n 5 "$BUILD/type_error.err" "$BUILD/syntax_error.err"
+		failed=1
+	fi
+done
+[ $failed -eq 0 ] && echo "batch matches the executable"
+exit $failed
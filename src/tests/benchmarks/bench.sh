@@ -0,0 +1,65 @@
+#!/bin/sh
+# Measures throughput of the compiler on programs generated by generate.c.
+# Usage: bench.sh [scale] [compiler]
+# Scale multiplies sizes of the generated programs except loop iterations (default 1). Every program is compiled 3 times, the fastest run
+# is reported. Output is one tab separated line per program with a header line, columns stay stable over time:
+# name, lines, tokens, IFJcode24 instructions, compile ms, tokens/s, lines/s, ms of --run.
+
+DIR=$(dirname "$0")
+SCALE=${1:-1}
+COMPILER=${2:-"$DIR/../../IFJ24"}
+REPEAT=3
+[ "$SCALE" -ge 1 ] 2> /dev/null || { echo "scale has to be a positive integer"; exit 1; }
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+${CC:-cc} -std=gnu99 -O2 -o "$WORK/generate" "$DIR/generate.c" || { echo "build of generate.c failed"; exit 1; }
+
+# Value of numeric key in --stats=json output
+json_value() {
+	sed -n "s/.*\"$1\": {*\"*\([0-9.]*\).*/\1/p" "$2"
+}
+
+printf 'name\tlines\ttokens\tinstructions\tcompile_ms\ttokens_per_s\tlines_per_s\trun_ms\n'
+# name, generator options (sizes are multiplied by the scale)
+while read -r name options; do
+	set -- $options
+	scaled=""
+	while [ $# -gt 0 ]; do
+		# Iterations of loop kernels are not scaled
+		case $1 in
+			-loop) scaled="$scaled $1 $2" ;;
+			*) scaled="$scaled $1 $(( $2 * SCALE ))" ;;
+		esac
+		shift 2
+	done
+	"$WORK/generate" $scaled > "$WORK/$name.zig"
+	best=""
+	for run in $(seq $REPEAT); do
+		"$COMPILER" --stats=json "$WORK/$name.zig" > /dev/null 2> "$WORK/stats" || { echo "$name: compilation failed"; exit 1; }
+		ms=$(sed -n 's/.*"total": {"wall_ms": \([0-9.]*\).*/\1/p' "$WORK/stats")
+		if [ -z "$best" ] || awk -v a="$ms" -v b="$best" 'BEGIN { exit !(a < b) }'; then
+			best=$ms
+			cp "$WORK/stats" "$WORK/best"
+		fi
+	done
+	start=$(date +%s%N)
+	"$COMPILER" --run "$WORK/$name.zig" > /dev/null || { echo "$name: run failed"; exit 1; }
+	end=$(date +%s%N)
+	lines=$(wc -l < "$WORK/$name.zig")
+	tokens=$(json_value tokens "$WORK/best")
+	instructions=$(json_value ir_instructions "$WORK/best")
+	awk -v name="$name" -v lines="$lines" -v tokens="$tokens" -v instructions="$instructions" -v ms="$best" \
+		-v run=$(( (end - start) / 1000000 )) 'BEGIN {
+		seconds = ms > 0 ? ms / 1000 : 0.000001
+		printf "%s\t%d\t%d\t%d\t%.3f\t%.0f\t%.0f\t%d\n", name, lines, tokens, instructions, ms, tokens / seconds, lines / seconds, run
+	}'
+done <<'CORPUS'
+small -functions 10
+functions -functions 2000
+expressions -functions 100 -expression 200
+nesting -functions 100 -depth 50
+identifiers -functions 100 -identifiers 300
+strings -functions 100 -strings 100 -string-length 200
+loops -functions 20 -loop 100000
+CORPUS
@@ -0,0 +1,17 @@
+#!/bin/sh
+# Times string building in the built-in interpreter.
+# Usage: concat.sh [iterations] [baseline compiler]
+# The baseline compiler (e.g. IFJ24 built from an older revision) is timed on the same program for comparison.
+
+DIR=$(dirname "$0")
+COMPILER="$DIR/../../IFJ24"
+COUNT=${1:-100000}
+BASELINE="$2"
+PROGRAM="$DIR/concat.zig"
+
+for compiler in "$COMPILER" $BASELINE; do
+	start=$(date +%s%N)
+	echo "$COUNT" | "$compiler" --run "$PROGRAM" > /dev/null || { echo "$compiler failed"; exit 1; }
+	end=$(date +%s%N)
+	printf '%s: %d iterations, %d ms\n' "$compiler" "$COUNT" $(( (end - start) / 1000000 ))
+done
@@ -0,0 +1,28 @@
+// String building benchmark: appending, concatenation of shared strings and substring, iteration count is read from input
+const ifj = @import("ifj24.zig");
+pub fn main() void {
+    const input = ifj.readi32();
+    if (input) |n| {
+        const x = ifj.string("ab");
+        var s: []u8 = ifj.string("");
+        var t: []u8 = ifj.string("");
+        var i: i32 = 0;
+        while (i < n) {
+            s = ifj.concat(s, x);
+            t = ifj.concat(x, t);
+            i = i + 1;
+        }
+        const length_s = ifj.length(s);
+        const length_t = ifj.length(t);
+        const length = length_s + length_t;
+        ifj.write(length);
+        ifj.write("\n");
+        const half = length_s - n;
+        const sub = ifj.substring(s, 0, half);
+        const sub_length = ifj.length(sub);
+        ifj.write(sub_length);
+        ifj.write("\n");
+    } else {
+        ifj.write("expected iteration count\n");
+    }
+}
@@ -0,0 +1,30 @@
+#!/bin/sh
+# Compares threaded (computed goto) and switch dispatch of the built-in interpreter.
+# Usage: dispatch.sh [scale]
+# Both variants are built with -O2 into a temporary directory, scale multiplies the iteration counts (default 1).
+
+DIR=$(dirname "$0")
+SRC="$DIR/../.."
+SCALE=${1:-1}
+BUILD=$(mktemp -d)
+trap 'rm -rf "$BUILD"' EXIT
+
+for dispatch in threaded switch; do
+	make -s -B -C "$SRC" "$BUILD/IFJ24-$dispatch" EXECUTABLE="$BUILD/IFJ24-$dispatch" \
+		DISPATCH=$dispatch CFLAGS="-std=gnu99 -O2" > /dev/null 2>&1 || { echo "build of $dispatch failed"; exit 1; }
+done
+
+# program, iterations of its main loop
+for benchmark in "dispatch 3000000" "factorial_iterative_loop 300000" "factorial_recursive_loop 200000"; do
+	set -- $benchmark
+	program="$DIR/$1.zig"
+	count=$(( $2 * SCALE ))
+	printf '%-26s %9d iterations' "$1" "$count"
+	for dispatch in threaded switch; do
+		start=$(date +%s%N)
+		echo "$count" | "$BUILD/IFJ24-$dispatch" --run "$program" > /dev/null || { echo " $dispatch failed"; exit 1; }
+		end=$(date +%s%N)
+		eval "ms_$dispatch=$(( (end - start) / 1000000 ))"
+	done
+	printf ', threaded %5d ms, switch %5d ms\n' "$ms_threaded" "$ms_switch"
+done
@@ -0,0 +1,18 @@
+// Dispatch microbenchmark: tight loop of cheap instructions, iteration count is read from input
+const ifj = @import("ifj24.zig");
+pub fn main() void {
+    const input = ifj.readi32();
+    if (input) |n| {
+        var i: i32 = 0;
+        var sum: i32 = 0;
+        while (i < n) {
+            sum = sum + 3;
+            sum = sum - 2;
+            i = i + 1;
+        }
+        ifj.write(sum);
+        ifj.write("\n");
+    } else {
+        ifj.write("expected iteration count\n");
+    }
+}
@@ -0,0 +1,23 @@
+// factorial_iterative.zig repeated, count of repetitions is read from input
+const ifj = @import("ifj24.zig");
+pub fn main() void {
+    const input = ifj.readi32();
+    if (input) |n| {
+        var round: i32 = 0;
+        var vysl: f64 = 1.0;
+        while (round < n) {
+            var d: f64 = 10.0;
+            vysl = 1.0;
+            while (d > 0) {
+                vysl = vysl * d;
+                d = d - 1.0;
+            }
+            round = round + 1;
+        }
+        const vysl_i32 = ifj.f2i(vysl);
+        ifj.write(vysl_i32);
+        ifj.write("\n");
+    } else {
+        ifj.write("expected repetition count\n");
+    }
+}
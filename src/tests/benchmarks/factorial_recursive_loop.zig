@@ -0,0 +1,31 @@
+// factorial_recursive.zig repeated, count of repetitions is read from input
+const ifj = @import("ifj24.zig");
+pub fn main() void {
+    const input = ifj.readi32();
+    if (input) |n| {
+        var round: i32 = 0;
+        var vysl: i32 = 0;
+        while (round < n) {
+            vysl = factorial(10);
+            round = round + 1;
+        }
+        ifj.write(vysl);
+        ifj.write("\n");
+    } else {
+        ifj.write("expected repetition count\n");
+    }
+}
+pub fn decrement(n: i32, m: i32) i32 {
+    return n - m;
+}
+pub fn factorial(n: i32) i32 {
+    var result: i32 = 0 - 1;
+    if (n < 2) {
+        result = 1;
+    } else {
+        const decremented_n = decrement(n, 1);
+        const temp_result = factorial(decremented_n);
+        result = n * temp_result;
+    }
+    return result;
+}
@@ -0,0 +1,19 @@
+#!/bin/sh
+# Times deep recursion and repeated calls in the built-in interpreter.
+# Usage: frames.sh [depth] [baseline compiler]
+# The baseline compiler (e.g. IFJ24 built from an older revision) is timed on the same programs for comparison.
+
+DIR=$(dirname "$0")
+COMPILER="$DIR/../../IFJ24"
+DEPTH=${1:-100000}
+BASELINE="$2"
+
+for compiler in "$COMPILER" $BASELINE; do
+	start=$(date +%s%N)
+	echo "$DEPTH" | "$compiler" --run "$DIR/recursion_depth.zig" > /dev/null || { echo "$compiler failed"; exit 1; }
+	middle=$(date +%s%N)
+	echo "$DEPTH" | "$compiler" --run "$DIR/factorial_recursive_loop.zig" > /dev/null || { echo "$compiler failed"; exit 1; }
+	end=$(date +%s%N)
+	printf '%s: recursion depth %d %d ms, %d factorials %d ms\n' "$compiler" "$DEPTH" $(( (middle - start) / 1000000 )) \
+		"$DEPTH" $(( (end - middle) / 1000000 ))
+done
@@ -0,0 +1,230 @@
+/**
+ * Název projektu: Implementace překladače imperativního jazyka IFJ24.
+ *
+ * @file generate.c
+ */
+
+/*
+ * Deterministic generator of valid IFJ24 programs for benchmarks of the compiler.
+ * The same options and seed always give the same program. Every function declares its variables at the top,
+ * reassigns them in nested conditions and returns their sum, main calls all functions and writes the total.
+ * Functions are named fun<N>, f64 would be a keyword.
+ *
+ * Usage: generate [-functions N] [-expression N] [-depth N] [-identifiers N] [-strings N] [-string-length N]
+ *                 [-loop N] [-seed N] > program.zig
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct generator_options{
+    int functions;      // Count of functions besides main
+    int expression;     // Count of terms in generated expressions
+    int depth;          // Nesting depth of if-else statements in every function
+    int identifiers;    // Count of variables in every function
+    int strings;        // Count of string literals in every function
+    int string_length;  // Maximum length of string literals
+    int loop;           // Iterations of the loop kernel in every function, 0 for no loop
+    unsigned long seed;
+} generator_options;
+
+static unsigned long long state;
+
+// Linear congruential generator, rand() differs between C libraries
+static unsigned random_below(unsigned limit){
+    state = state * 6364136223846793005ull + 1442695040888963407ull;
+    return (unsigned)(state >> 33) % limit;
+}
+
+static void indent(int level){
+    for(int i = 0; i < level; i++){
+        fputs("    ", stdout);
+    }
+}
+
+/**
+ * Writes operand of expression: variable, parameter or literal
+ * \param variables count of variables that can be used
+ */
+static void term(int variables){
+    unsigned choice = random_below(variables + 2);
+    if(choice < (unsigned)variables){
+        printf("v%u", choice);
+    }
+    else if(choice == (unsigned)variables){
+        fputs(random_below(2) ? "a" : "b", stdout);
+    }
+    else{
+        printf("%u", random_below(100));
+    }
+}
+
+/**
+ * Writes integer expression of given count of terms, parts are parenthesized at random
+ * \param terms
+ * \param variables count of variables that can be used
+ */
+static void expression(int terms, int variables){
+    static const char* operators[] = {" + ", " - ", " * ", " + "};
+    if(terms <= 1){
+        term(variables);
+        return;
+    }
+    int left = 1 + random_below(terms - 1);
+    bool parentheses = random_below(3) == 0;
+    if(parentheses){
+        putchar('(');
+    }
+    expression(left, variables);
+    fputs(operators[random_below(4)], stdout);
+    expression(terms - left, variables);
+    if(parentheses){
+        putchar(')');
+    }
+}
+
+static void string_literal(int max_length){
+    static const char alphabet[] = "abcdefghijklmnopqrstuvwxyz ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+    int length = max_length > 0 ? 1 + random_below(max_length) : 0;
+    putchar('"');
+    for(int i = 0; i < length; i++){
+        if(random_below(16) == 0){
+            fputs(random_below(2) ? "\\t" : "\\x41", stdout);
+        }
+        else{
+            putchar(alphabet[random_below(sizeof(alphabet) - 1)]);
+        }
+    }
+    putchar('"');
+}
+
+/**
+ * Writes nested if-else statements assigning to variables
+ * \param options
+ * \param depth remaining depth
+ * \param level indentation
+ */
+static void nested(const generator_options* options, int depth, int level){
+    if(depth == 0){
+        return;
+    }
+    int variables = options->identifiers;
+    indent(level);
+    printf("if (v%u < v%u) {\n", random_below(variables), random_below(variables));
+    indent(level + 1);
+    printf("v%u = ", random_below(variables));
+    expression(options->expression, variables);
+    fputs(";\n", stdout);
+    nested(options, depth - 1, level + 1);
+    indent(level);
+    fputs("} else {\n", stdout);
+    indent(level + 1);
+    printf("v%u = ", random_below(variables));
+    expression(options->expression, variables);
+    fputs(";\n", stdout);
+    indent(level);
+    fputs("}\n", stdout);
+}
+
+static void function(const generator_options* options, int index){
+    int variables = options->identifiers;
+    // Functions do not depend on each other, more functions only append to the program
+    state = options->seed * 1000003 + index;
+    printf("pub fn fun%d(a: i32, b: i32) i32 {\n", index);
+    // Variables are initialized from the parameters and previous variables
+    for(int i = 0; i < variables; i++){
+        printf("    var v%d: i32 = ", i);
+        expression(options->expression, i);
+        fputs(";\n", stdout);
+    }
+    // Every variable is reassigned, unchanged var is a semantic error
+    for(int i = 0; i < variables; i++){
+        printf("    v%d = v%d + %d;\n", i, i, i + 1);
+    }
+    nested(options, options->depth, 1);
+    for(int i = 0; i < options->strings; i++){
+        printf("    const s%d = ifj.string(", i);
+        string_literal(options->string_length);
+        printf(");\n    const l%d = ifj.length(s%d);\n    v0 = v0 + l%d;\n", i, i, i);
+    }
+    if(options->loop > 0){
+        printf("    var i: i32 = 0;\n    while (i < %d) {\n        v0 = v0 + i * %u;\n", options->loop, random_below(10));
+        for(int i = 1; i < variables && i < 4; i++){
+            printf("        v%d = v%d - v0 + i;\n", i, i);
+        }
+        fputs("        i = i + 1;\n    }\n", stdout);
+    }
+    // Unused parameter is a semantic error as well
+    fputs("    return a - b", stdout);
+    for(int i = 0; i < variables; i++){
+        printf(" + v%d", i);
+    }
+    fputs(";\n}\n", stdout);
+}
+
+static bool parse_arguments(int argc, char** argv, generator_options* options){
+    static const char* names[] = {"-functions", "-expression", "-depth", "-identifiers", "-strings", "-string-length", "-loop"};
+    int* values[] = {&options->functions, &options->expression, &options->depth, &options->identifiers,
+                     &options->strings, &options->string_length, &options->loop};
+    for(int i = 1; i < argc; i += 2){
+        if(i + 1 >= argc){
+            return false;
+        }
+        char* end;
+        long value = strtol(argv[i + 1], &end, 10);
+        if(*end != '\0' || value < 0){
+            return false;
+        }
+        size_t j = 0;
+        while(j < sizeof(names) / sizeof(names[0]) && strcmp(argv[i], names[j]) != 0){
+            j++;
+        }
+        if(j < sizeof(names) / sizeof(names[0])){
+            *values[j] = (int)value;
+        }
+        else if(strcmp(argv[i], "-seed") == 0){
+            options->seed = value;
+        }
+        else{
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv){
+    generator_options options = {
+        .functions = 10, .expression = 4, .depth = 2, .identifiers = 4,
+        .strings = 1, .string_length = 16, .loop = 0, .seed = 1,
+    };
+    if(!parse_arguments(argc, argv, &options)){
+        fprintf(stderr, "usage: %s [-functions N] [-expression N] [-depth N] [-identifiers N] [-strings N] "
+                "[-string-length N] [-loop N] [-seed N]\n", argv[0]);
+        return 1;
+    }
+    // Programs need a function changing the total of main and a variable in every function
+    if(options.functions == 0){
+        options.functions = 1;
+    }
+    if(options.identifiers == 0){
+        options.identifiers = 1;
+    }
+    if(options.expression == 0){
+        options.expression = 1;
+    }
+    printf("// Generated by generate.c -functions %d -expression %d -depth %d -identifiers %d -strings %d "
+           "-string-length %d -loop %d -seed %lu\n", options.functions, options.expression, options.depth,
+           options.identifiers, options.strings, options.string_length, options.loop, options.seed);
+    fputs("const ifj = @import(\"ifj24.zig\");\n", stdout);
+    fputs("pub fn main() void {\n    var total: i32 = 0;\n", stdout);
+    for(int i = 0; i < options.functions; i++){
+        printf("    const r%d = fun%d(%d, %d);\n    total = total + r%d;\n", i, i, i, i % 7, i);
+    }
+    fputs("    ifj.write(total);\n    ifj.write(\"\\n\");\n}\n", stdout);
+    for(int i = 0; i < options.functions; i++){
+        function(&options, i);
+    }
+    return 0;
+}
@@ -0,0 +1,27 @@
+#!/bin/sh
+# Times reading and writing in the built-in interpreter.
+# Usage: io.sh [groups] [baseline compiler]
+# Input has groups of integer, float and string lines (10^5 groups by default), the output of the baseline
+# compiler (e.g. IFJ24 built from an older revision) has to be the same.
+
+DIR=$(dirname "$0")
+COMPILER="$DIR/../../IFJ24"
+COUNT=${1:-100000}
+BASELINE="$2"
+PROGRAM="$DIR/io.zig"
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+awk -v count="$COUNT" 'BEGIN { for (i = 0; i < count; i++) printf "%d\n%d.%03d\nline %d of input\n", i % 1000, i, i % 997, i }' > "$WORK/input"
+
+for compiler in "$COMPILER" $BASELINE; do
+	start=$(date +%s%N)
+	"$compiler" --run "$PROGRAM" < "$WORK/input" > "$WORK/output" || { echo "$compiler failed"; exit 1; }
+	end=$(date +%s%N)
+	printf '%s: %d groups, %d ms\n' "$compiler" "$COUNT" $(( (end - start) / 1000000 ))
+	if [ -f "$WORK/expected" ]; then
+		cmp -s "$WORK/expected" "$WORK/output" || { echo "output differs"; exit 1; }
+	else
+		mv "$WORK/output" "$WORK/expected"
+	fi
+done
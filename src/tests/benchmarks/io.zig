@@ -0,0 +1,31 @@
+// Input and output benchmark: echoes groups of integer, float and string lines until the end of input
+const ifj = @import("ifj24.zig");
+pub fn main() void {
+    var count: i32 = 0;
+    var sum: i32 = 0;
+    var number = ifj.readi32();
+    while (number) |value| {
+        const real = ifj.readf64();
+        const text = ifj.readstr();
+        ifj.write(value);
+        ifj.write(" ");
+        if (real) |r| {
+            ifj.write(r);
+        } else {
+            ifj.write("null");
+        }
+        ifj.write(" ");
+        if (text) |t| {
+            ifj.write(t);
+        } else {
+        }
+        ifj.write("\n");
+        sum = sum + value;
+        count = count + 1;
+        number = ifj.readi32();
+    }
+    ifj.write(count);
+    ifj.write(" groups, sum ");
+    ifj.write(sum);
+    ifj.write("\n");
+}
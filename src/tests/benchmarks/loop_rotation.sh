@@ -0,0 +1,25 @@
+#!/bin/sh
+# Compares while cycles generated with (-O1) and without (-O0) loop rotation.
+# Usage: loop_rotation.sh [interpreter]
+# Without an IFJcode24 interpreter only the size of the generated code is reported.
+
+DIR=$(dirname "$0")
+COMPILER="$DIR/../../IFJ24"
+INTERPRETER="$1"
+PROGRAM="$DIR/while_loops.zig"
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+for level in -O0 -O1; do
+	"$COMPILER" $level < "$PROGRAM" > "$WORK/while_loops$level.code" || exit 1
+	printf '%s: %s instructions, %s jumps' "$level" \
+		"$(grep -vc '^#\|^label' "$WORK/while_loops$level.code")" \
+		"$(grep -c '^jump' "$WORK/while_loops$level.code")"
+	if [ -n "$INTERPRETER" ]; then
+		start=$(date +%s%N)
+		$INTERPRETER "$WORK/while_loops$level.code" > /dev/null
+		end=$(date +%s%N)
+		printf ', %d ms' $(( (end - start) / 1000000 ))
+	fi
+	echo
+done
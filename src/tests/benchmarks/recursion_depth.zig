@@ -0,0 +1,22 @@
+// Recursion of the given depth, each level has its own frame
+const ifj = @import("ifj24.zig");
+pub fn main() void {
+    const input = ifj.readi32();
+    if (input) |n| {
+        const d = depth(n);
+        ifj.write(d);
+        ifj.write("\n");
+    } else {
+    }
+}
+pub fn depth(n: i32) i32 {
+    var result: i32 = 0;
+    if (n < 1) {
+        result = 0;
+    } else {
+        const m = n - 1;
+        const inner = depth(m);
+        result = inner + 1;
+    }
+    return result;
+}
@@ -0,0 +1,18 @@
+// Benchmark: factorial_iterative.zig style loops scaled up
+const ifj = @import("ifj24.zig");
+pub fn main() void {
+    var round: i32 = 0;
+    var checksum: f64 = 0.0;
+    while (round < 20000) {
+        var d: f64 = 20.0;
+        var vysl: f64 = 1.0;
+        while (d > 0) {
+            vysl = vysl * d;
+            d = d - 1.0;
+        }
+        checksum = checksum + vysl;
+        round = round + 1;
+    }
+    ifj.write(checksum);
+    ifj.write("\n");
+}
@@ -0,0 +1,32 @@
+#!/bin/sh
+# Runs example and benchmark programs with native code and with the interpreter only, output and exit codes have to match.
+# Usage: jit_differential.sh [threshold]
+# The compiler is built with -O2 into a temporary directory, native code is compiled after threshold executions (default 1).
+
+DIR=$(dirname "$0")
+SRC="$DIR/.."
+THRESHOLD=${1:-1}
+BUILD=$(mktemp -d)
+trap 'rm -rf "$BUILD"' EXIT
+
+make -s -B -C "$SRC" "$BUILD/IFJ24" EXECUTABLE="$BUILD/IFJ24" CFLAGS="-std=gnu99 -O2 -DJIT_THRESHOLD=$THRESHOLD" > /dev/null 2>&1 \
+	|| { echo "build failed"; exit 1; }
+
+failed=0
+for program in "$DIR"/examples/*.zig "$DIR"/benchmarks/*.zig; do
+	[ "$(basename "$program")" = ifj24.zig ] && continue
+	for input in 0 5 300 'x'; do
+		for level in -O0 -O1; do
+			printf '%s\n' "$input" | "$BUILD/IFJ24" $level --run "$program" > "$BUILD/native.out" 2> /dev/null
+			native=$?
+			printf '%s\n' "$input" | "$BUILD/IFJ24" $level --run --no-jit "$program" > "$BUILD/interpreted.out" 2> /dev/null
+			interpreted=$?
+			if [ $native -ne $interpreted ] || ! cmp -s "$BUILD/native.out" "$BUILD/interpreted.out"; then
+				echo "MISMATCH $program $level input '$input': exit $native, interpreter exit $interpreted"
+				failed=1
+			fi
+		done
+	done
+done
+[ $failed -eq 0 ] && echo "native code matches the interpreter"
+exit $failed
@@ -0,0 +1,70 @@
+/**
+ * Název projektu: Implementace překladače imperativního jazyka IFJ24.
+ *
+ * @file library.c
+ */
+
+/*
+ * Compiles every file given on the command line in one process through libifj24 and prints a line
+ * "# <file> <exit code>" followed by the generated code of each file. Diagnostics are printed to stderr.
+ *
+ * Usage: library [-O0|-O1] program.zig...
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../ifj24.h"
+
+static char* read_file(const char* path, size_t* length){
+    FILE* file = fopen(path, "rb");
+    if(file == NULL){
+        return NULL;
+    }
+    char* content = NULL;
+    size_t capacity = 0;
+    *length = 0;
+    size_t count;
+    do{
+        if(*length == capacity){
+            capacity = capacity ? capacity * 2 : 4096;
+            char* grown = realloc(content, capacity);
+            if(grown == NULL){
+                free(content);
+                fclose(file);
+                return NULL;
+            }
+            content = grown;
+        }
+        count = fread(content + *length, 1, capacity - *length, file);
+        *length += count;
+    } while(count > 0);
+    fclose(file);
+    return content;
+}
+
+int main(int argc, char** argv){
+    ifj24_options options = {.optimization = 1};
+    int first = 1;
+    if(argc > 1 && (strcmp(argv[1], "-O0") == 0 || strcmp(argv[1], "-O1") == 0)){
+        options.optimization = argv[1][2] - '0';
+        first = 2;
+    }
+    for(int i = first; i < argc; i++){
+        size_t length;
+        char* source = read_file(argv[i], &length);
+        if(source == NULL){
+            fprintf(stderr, "cannot read '%s'\n", argv[i]);
+            return 1;
+        }
+        ifj24_output output;
+        ifj24_compile(source, length, &output, &options);
+        printf("# %s %d\n", argv[i], output.error);
+        fwrite(output.code, 1, output.length, stdout);
+        fwrite(output.diagnostics, 1, output.diagnostics_length, stderr);
+        ifj24_output_free(&output);
+        free(source);
+    }
+    return 0;
+}
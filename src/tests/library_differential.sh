@@ -0,0 +1,30 @@
+#!/bin/sh
+# Compiles example and benchmark programs in one process through libifj24 and by the IFJ24 executable,
+# generated code and exit codes have to match.
+# Usage: library_differential.sh
+
+DIR=$(dirname "$0")
+SRC="$DIR/.."
+BUILD=$(mktemp -d)
+trap 'rm -rf "$BUILD"' EXIT
+
+make -s -C "$SRC" IFJ24 lib > /dev/null 2>&1 && ${CC:-gcc} -std=gnu99 -o "$BUILD/library" "$DIR/library.c" "$SRC/libifj24.a" -pthread \
+	|| { echo "build failed"; exit 1; }
+
+failed=0
+for level in -O0 -O1; do
+	: > "$BUILD/executable.out"
+	for program in "$DIR"/examples/*.zig "$DIR"/benchmarks/*.zig; do
+		"$SRC/IFJ24" $level < "$program" > "$BUILD/program.code" 2> /dev/null
+		echo "# $program $?" >> "$BUILD/executable.out"
+		cat "$BUILD/program.code" >> "$BUILD/executable.out"
+	done
+	"$BUILD/library" $level "$DIR"/examples/*.zig "$DIR"/benchmarks/*.zig > "$BUILD/library.out" 2> /dev/null
+	if ! cmp -s "$BUILD/library.out" "$BUILD/executable.out"; then
+		echo "MISMATCH $level"
+		diff "$BUILD/library.out" "$BUILD/executable.out" | head -n 20
+		failed=1
+	fi
+done
+[ $failed -eq 0 ] && echo "library matches the executable"
+exit $failed
@@ -0,0 +1,64 @@
+/**
+ * Název projektu: Implementace překladače imperativního jazyka IFJ24.
+ *
+ * @file server_client.c
+ */
+
+/*
+ * Client of IFJ24 --server: sends source code from stdin, prints the generated IFJcode24 to stdout,
+ * diagnostics of the compiler to stderr and exits with the exit code of the compilation.
+ *
+ * Usage: server_client socket < program.zig
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+int main(int argc, char** argv){
+    struct sockaddr_un address = {.sun_family = AF_UNIX};
+    if(argc != 2 || strlen(argv[1]) >= sizeof(address.sun_path)){
+        fprintf(stderr, "usage: %s socket < program.zig\n", argv[0]);
+        return 99;
+    }
+    strcpy(address.sun_path, argv[1]);
+    int server = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(server < 0 || connect(server, (struct sockaddr*)&address, sizeof(address)) != 0){
+        perror("connect");
+        return 99;
+    }
+    char buffer[64 * 1024];
+    size_t count;
+    while((count = fread(buffer, 1, sizeof(buffer), stdin)) > 0){
+        for(size_t sent = 0; sent < count; ){
+            ssize_t written = write(server, buffer + sent, count - sent);
+            if(written < 0){
+                perror("write");
+                return 99;
+            }
+            sent += written;
+        }
+    }
+    shutdown(server, SHUT_WR);
+
+    // The first line is the exit code and the length of diagnostics, the diagnostics are followed by the generated code
+    FILE* response = fdopen(server, "r");
+    int exit_code;
+    size_t diagnostics;
+    if(response == NULL || fscanf(response, "%d %zu", &exit_code, &diagnostics) != 2 || fgetc(response) != '\n'){
+        fprintf(stderr, "invalid response\n");
+        return 99;
+    }
+    while(diagnostics > 0 && (count = fread(buffer, 1, diagnostics < sizeof(buffer) ? diagnostics : sizeof(buffer), response)) > 0){
+        fwrite(buffer, 1, count, stderr);
+        diagnostics -= count;
+    }
+    while((count = fread(buffer, 1, sizeof(buffer), response)) > 0){
+        fwrite(buffer, 1, count, stdout);
+    }
+    fclose(response);
+    return exit_code;
+}
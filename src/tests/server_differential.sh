@@ -0,0 +1,50 @@
+#!/bin/sh
+# Starts IFJ24 --server, sends it example and benchmark programs from concurrent clients and compares
+# generated code and exit codes with the executable.
+# Usage: server_differential.sh [clients]
+
+DIR=$(dirname "$0")
+SRC="$DIR/.."
+CLIENTS=${1:-8}
+BUILD=$(mktemp -d)
+SOCKET="$BUILD/ifj24.sock"
+trap 'kill $SERVER 2> /dev/null; rm -rf "$BUILD"' EXIT
+
+make -s -C "$SRC" IFJ24 > /dev/null 2>&1 && ${CC:-gcc} -std=gnu99 -o "$BUILD/client" "$DIR/server_client.c" \
+	|| { echo "build failed"; exit 1; }
+
+"$SRC/IFJ24" --server "$SOCKET" -j 4 > /dev/null 2>&1 &
+SERVER=$!
+while [ ! -S "$SOCKET" ]; do
+	kill -0 $SERVER 2> /dev/null || { echo "server did not start"; exit 1; }
+	sleep 0.1
+done
+
+failed=0
+for program in "$DIR"/examples/*.zig "$DIR"/benchmarks/*.zig; do
+	"$SRC/IFJ24" < "$program" > "$BUILD/expected.code" 2> /dev/null
+	expected=$?
+	# Clients run concurrently, every one compiles the same program
+	client=1
+	pids=
+	while [ $client -le "$CLIENTS" ]; do
+		( "$BUILD/client" "$SOCKET" < "$program" > "$BUILD/$client.code"; echo $? > "$BUILD/$client.rc" ) &
+		pids="$pids $!"
+		client=$((client + 1))
+	done
+	wait $pids
+	client=1
+	while [ $client -le "$CLIENTS" ]; do
+		if [ "$(cat "$BUILD/$client.rc")" -ne $expected ] || ! cmp -s "$BUILD/$client.code" "$BUILD/expected.code"; then
+			echo "MISMATCH $program client $client: exit $(cat "$BUILD/$client.rc"), executable exit $expected"
+			failed=1
+		fi
+		client=$((client + 1))
+	done
+done
+
+kill $SERVER
+wait $SERVER
+[ -S "$SOCKET" ] && { echo "socket was not removed"; failed=1; }
+[ $failed -eq 0 ] && echo "server matches the executable"
+exit $failed
@@ -10,6 +10,7 @@
 #include <stdio.h>
 
 #include "token.h"
+#include "compiler.h"
 #include "compiler_error.h"
 #include "lexer.h"
 
@@ -38,8 +39,8 @@ void enqueue_t_buf (t_buf *buf, token_t token) {
 	t_buf_item *new;
 
 	if ((new = (t_buf_item*) malloc(sizeof(t_buf_item))) == NULL) {
-		printf(RED_BOLD("error")": Token buffer resource allocation failure\n");
-		error = ERR_COMPILER_INTERNAL;
+		fprintf(compiler_messages(), RED_BOLD("error")": Token buffer resource allocation failure\n");
+		ctx->error = ERR_COMPILER_INTERNAL;
 		return;
 	}
 
@@ -64,8 +65,8 @@ token_t get_t_buf (t_buf *buf) {
 	token_t token;
 
 	if (buf == NULL || buf->head == NULL) {
-		printf(RED_BOLD("error")": Token buffer is empty or invalid pointer to buffer\n");
-		error = ERR_COMPILER_INTERNAL;
+		fprintf(compiler_messages(), RED_BOLD("error")": Token buffer is empty or invalid pointer to buffer\n");
+		ctx->error = ERR_COMPILER_INTERNAL;
 		return (token_t) {.id = TOKEN_ERROR};
 	}
 
@@ -128,8 +129,8 @@ char *func_id_concat(char *lex_prefix, char *lex_suffix) {
 	size_t size = strlen(lex_prefix) + strlen(".") +strlen(lex_suffix);
 
 	if ((new_lexeme = (char*) malloc(size + 1)) == NULL) {
-		error = ERR_COMPILER_INTERNAL;
-		printf(RED("error")": Lexeme concatenation resource allocation failure\n");
+		ctx->error = ERR_COMPILER_INTERNAL;
+		fprintf(compiler_messages(), RED("error")": Lexeme concatenation resource allocation failure\n");
 		return NULL;
 	}
 
@@ -137,5 +138,7 @@ char *func_id_concat(char *lex_prefix, char *lex_suffix) {
 	strcat(new_lexeme, ".");
 	strcat(new_lexeme, lex_suffix);
 
+	if (!keep_lexeme(new_lexeme))
+		return NULL;
 	return new_lexeme;
 }
\ No newline at end of file
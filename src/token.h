@@ -83,6 +83,7 @@ typedef struct token {
 	token_id id;			// ID of current token (token type)
 	dynamic_array lexeme;	// Dyn. array type containing sequence of alphanumerical + '_' characters  (lexeme)
 	// Lexeme containts identifiers, values
+	unsigned int row, col;	// Position of the first character of the token in the source code
 } token_t;
 
 typedef struct token_buffer t_buf; 
@@ -0,0 +1,180 @@
+/**
+ * Název projektu: Implementace překladače imperativního jazyka IFJ24.
+ *
+ * @file value.h
+ */
+
+#ifndef VALUE_H
+#define VALUE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "rope.h"
+
+// Runtime types of IFJcode24 values
+typedef enum vm_type{
+    VM_UNDECLARED = 0, // Frame slot without defvar
+    VM_UNDEFINED,      // Declared variable without value
+    VM_NIL,
+    VM_INT,
+    VM_FLOAT,
+    VM_BOOL,
+    VM_STRING,
+} vm_type;
+
+#ifdef VM_NAN_BOXING
+
+/*
+ * 8 byte NaN-boxed value. Floats are stored as they are (NaN is canonicalized to positive quiet NaN),
+ * other types have the top 13 bits set, type in the next 3 bits and 48 bit payload.
+ * Integers are 48 bit, strings are user space pointers. The interpreter reports integers out of that range
+ * as runtime errors, they are never truncated.
+ */
+typedef uint64_t vm_value;
+
+#define VM_BOX_PREFIX 0x1FFFu               // Top 13 bits of boxed value
+#define VM_BOX_TAG(type) (0xFFF8u | (type)) // Top 16 bits of boxed value of given type
+#define VM_PAYLOAD_MASK 0xFFFFFFFFFFFFull
+
+static inline vm_value vm_box(vm_type type, uint64_t payload){
+    return ((uint64_t)VM_BOX_TAG(type) << 48) | (payload & VM_PAYLOAD_MASK);
+}
+
+static inline vm_type vm_type_of(vm_value value){
+    return (value >> 51) == VM_BOX_PREFIX ? (vm_type)((value >> 48) & 7) : VM_FLOAT;
+}
+
+static inline bool vm_is(vm_value value, vm_type type){
+    return type == VM_FLOAT ? (value >> 51) != VM_BOX_PREFIX : (value >> 48) == VM_BOX_TAG(type);
+}
+
+static inline long long vm_as_int(vm_value value){
+    // Sign extension of 48 bit payload
+    return (long long)(value << 16) >> 16;
+}
+
+static inline double vm_as_float(vm_value value){
+    double number;
+    memcpy(&number, &value, sizeof(number));
+    return number;
+}
+
+static inline bool vm_as_bool(vm_value value){
+    return value & 1;
+}
+
+static inline rope* vm_as_string(vm_value value){
+    return (rope*)(uintptr_t)(value & VM_PAYLOAD_MASK);
+}
+
+static inline vm_value vm_int(long long number){
+    return vm_box(VM_INT, (uint64_t)number);
+}
+
+static inline bool vm_int_fits(long long number){
+    return vm_as_int(vm_int(number)) == number;
+}
+
+static inline vm_value vm_float(double number){
+    vm_value value;
+    if(number != number){
+        return 0x7FF8000000000000ull;
+    }
+    memcpy(&value, &number, sizeof(value));
+    return value;
+}
+
+static inline vm_value vm_bool(bool boolean){
+    return vm_box(VM_BOOL, boolean);
+}
+
+static inline vm_value vm_string(rope* string){
+    return vm_box(VM_STRING, (uintptr_t)string);
+}
+
+static inline vm_value vm_simple(vm_type type){
+    return vm_box(type, 0);
+}
+
+#else
+
+// 16 byte tagged value
+typedef struct vm_value{
+    uint8_t type;
+    union{
+        long long int_val;
+        double float_val;
+        bool bool_val;
+        rope* string;
+    } as;
+} vm_value;
+
+static inline vm_type vm_type_of(vm_value value){
+    return (vm_type)value.type;
+}
+
+static inline bool vm_is(vm_value value, vm_type type){
+    return value.type == type;
+}
+
+static inline long long vm_as_int(vm_value value){
+    return value.as.int_val;
+}
+
+static inline double vm_as_float(vm_value value){
+    return value.as.float_val;
+}
+
+static inline bool vm_as_bool(vm_value value){
+    return value.as.bool_val;
+}
+
+static inline rope* vm_as_string(vm_value value){
+    return value.as.string;
+}
+
+static inline vm_value vm_int(long long number){
+    vm_value value = {.type = VM_INT, .as.int_val = number};
+    return value;
+}
+
+static inline bool vm_int_fits(long long number){
+    (void)number;
+    return true;
+}
+
+static inline vm_value vm_float(double number){
+    vm_value value = {.type = VM_FLOAT, .as.float_val = number};
+    return value;
+}
+
+static inline vm_value vm_bool(bool boolean){
+    vm_value value = {.type = VM_BOOL, .as.bool_val = boolean};
+    return value;
+}
+
+static inline vm_value vm_string(rope* string){
+    vm_value value = {.type = VM_STRING, .as.string = string};
+    return value;
+}
+
+static inline vm_value vm_simple(vm_type type){
+    vm_value value = {.type = type, .as.int_val = 0};
+    return value;
+}
+
+#endif
+
+// Frames and the data stack are dense arrays of values
+typedef char vm_value_size_check[sizeof(vm_value) <= 16 ? 1 : -1];
+
+/**
+ * Both values have the given type
+ */
+static inline bool vm_both(vm_value a, vm_value b, vm_type type){
+    return vm_is(a, type) && vm_is(b, type);
+}
+
+#endif
@@ -0,0 +1,1541 @@
+/**
+ * Název projektu: Implementace překladače imperativního jazyka IFJ24.
+ *
+ * @file vm.c
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <strings.h>
+
+#include "vm.h"
+#include "jit.h"
+#include "loader.h"
+#include "options.h"
+#include "vm_io.h"
+
+// Initial capacities of the frame stack (in slots) and of the call stack
+#define VM_FRAME_STACK_SIZE 4096
+#define VM_CALL_STACK_SIZE 1024
+
+// Frame with variables in slots resolved by the loader
+typedef struct vm_frame{
+    vm_value* slots;
+    size_t size;
+} vm_frame;
+
+// State of the interpreter
+typedef struct vm_state{
+    const vm_code* code;
+    size_t ip;              // Index of the next instruction
+    vm_frame global;        // GF
+    /*
+     * Slots of LF stack followed by TF. TF is always created on top of the current LF,
+     * so pushframe and popframe only move the boundary between LF stack and TF.
+     */
+    vm_value* frame_stack;
+    size_t frame_top, frame_capacity; // frame_top: count of slots used by LF stack
+    vm_frame* locals;       // Stack of LF, top is the current LF
+    size_t local_count, local_capacity;
+    vm_frame temporary;     // TF, slots are NULL when undefined
+    vm_value* stack;        // Data stack
+    size_t stack_count, stack_capacity;
+    size_t* calls;          // Call stack of return addresses
+    size_t call_count, call_capacity;
+#ifdef VM_JIT
+    jit_state jit;          // Native code of hot regions, entries are NULL with --no-jit
+#endif
+} vm_state;
+
+static const char* type_names[] = {
+    [VM_UNDECLARED] = "",
+    [VM_UNDEFINED] = "",
+    [VM_NIL] = "nil",
+    [VM_INT] = "int",
+    [VM_FLOAT] = "float",
+    [VM_BOOL] = "bool",
+    [VM_STRING] = "string",
+};
+
+/**
+ * Ensures capacity of dynamic array
+ * \param array pointer to array
+ * \param capacity pointer to current capacity
+ * \param count required count of elements
+ * \param size size of one element
+ * \return 0: success, VM_ERR_INTERNAL: memory allocation error
+ */
+static int vm_reserve(void** array, size_t* capacity, size_t count, size_t size){
+    if(count <= *capacity){
+        return 0;
+    }
+    size_t new_capacity = *capacity ? *capacity * 2 : 16;
+    while(new_capacity < count){
+        new_capacity *= 2;
+    }
+    void* new_array = realloc(*array, new_capacity * size);
+    if(new_array == NULL){
+        return VM_ERR_INTERNAL;
+    }
+    *array = new_array;
+    *capacity = new_capacity;
+    return 0;
+}
+
+// Values
+
+static void vm_free_value(vm_value* value){
+    if(vm_is(*value, VM_STRING)){
+        rope_release(vm_as_string(*value));
+    }
+    *value = vm_simple(VM_UNDEFINED);
+}
+
+/**
+ * Creates string value owning its copy of the string
+ * \param string
+ * \param length
+ * \param out
+ * \return 0: success, VM_ERR_INTERNAL: memory allocation error
+ */
+static int vm_make_string(const char* string, size_t length, vm_value* out){
+    rope* copy = rope_new(string, length);
+    if(copy == NULL){
+        return VM_ERR_INTERNAL;
+    }
+    *out = vm_string(copy);
+    return 0;
+}
+
+/**
+ * Creates integer value, NaN-boxed values cannot hold integers wider than 48 bits
+ * \param number
+ * \param out
+ * \return 0: success, VM_ERR_OPERAND_VALUE: the integer cannot be represented
+ */
+static int vm_make_int(long long number, vm_value* out){
+    if(!vm_int_fits(number)){
+        return VM_ERR_OPERAND_VALUE;
+    }
+    *out = vm_int(number);
+    return 0;
+}
+
+/**
+ * Creates owned value from borrowed value, strings are shared
+ * \param src
+ * \return copy
+ */
+static vm_value vm_copy_value(vm_value src){
+    if(vm_is(src, VM_STRING)){
+        rope_retain(vm_as_string(src));
+    }
+    return src;
+}
+
+/**
+ * Characters of string value
+ * \param value string
+ * \param out NUL terminated characters
+ * \return 0: success, VM_ERR_INTERNAL: memory allocation error
+ */
+static int vm_characters(vm_value value, const char** out){
+    *out = rope_flatten(vm_as_string(value));
+    return *out == NULL ? VM_ERR_INTERNAL : 0;
+}
+
+// Frames
+
+/**
+ * Allocates slots of frame, all slots are undeclared
+ * \param size count of slots
+ * \return slots | NULL in case of a memory allocation error
+ */
+static vm_value* vm_new_slots(size_t size){
+    vm_value* slots = malloc(sizeof(vm_value) * (size + 1));
+    if(slots == NULL){
+        return NULL;
+    }
+    for(size_t i = 0; i < size; i++){
+        slots[i] = vm_simple(VM_UNDECLARED);
+    }
+    return slots;
+}
+
+/**
+ * Grows frame stack, slots of LF stack are moved and the frames are rebased
+ * \param vm
+ * \param count required count of slots
+ * \return 0: success, VM_ERR_INTERNAL: memory allocation error
+ */
+static int vm_reserve_frames(vm_state* vm, size_t count){
+    if(count <= vm->frame_capacity){
+        return 0;
+    }
+    size_t capacity = vm->frame_capacity ? vm->frame_capacity * 2 : VM_FRAME_STACK_SIZE;
+    while(capacity < count){
+        capacity *= 2;
+    }
+    vm_value* frame_stack = malloc(sizeof(vm_value) * capacity);
+    if(frame_stack == NULL){
+        return VM_ERR_INTERNAL;
+    }
+    if(vm->frame_top > 0){
+        memcpy(frame_stack, vm->frame_stack, sizeof(vm_value) * vm->frame_top);
+    }
+    for(size_t i = 0; i < vm->local_count; i++){
+        vm->locals[i].slots = frame_stack + (vm->locals[i].slots - vm->frame_stack);
+    }
+    free(vm->frame_stack);
+    vm->frame_stack = frame_stack;
+    vm->frame_capacity = capacity;
+    return 0;
+}
+
+/**
+ * Frees values of frame, the slots stay allocated
+ * \param frame
+ */
+static void vm_clear_frame(vm_frame* frame){
+    for(size_t i = 0; i < frame->size; i++){
+        vm_free_value(&frame->slots[i]);
+    }
+}
+
+/**
+ * Creates TF on top of the LF stack with all slots undeclared, the previous TF is discarded
+ * \param vm
+ * \param size count of slots
+ * \return 0: success, VM_ERR_INTERNAL: memory allocation error
+ */
+static int vm_create_frame(vm_state* vm, size_t size){
+    if(vm->temporary.slots != NULL){
+        vm_clear_frame(&vm->temporary);
+        vm->temporary.slots = NULL;
+    }
+    int err = vm_reserve_frames(vm, vm->frame_top + size);
+    if(err){
+        return err;
+    }
+    vm_value* slots = vm->frame_stack + vm->frame_top;
+    for(size_t i = 0; i < size; i++){
+        slots[i] = vm_simple(VM_UNDECLARED);
+    }
+    vm->temporary.slots = slots;
+    vm->temporary.size = size;
+    return 0;
+}
+
+/**
+ * Moves TF to the top of the LF stack
+ * \param vm
+ * \return 0: success, VM_ERR_FRAME: TF does not exist, VM_ERR_INTERNAL
+ */
+static int vm_push_frame(vm_state* vm){
+    if(vm->temporary.slots == NULL){
+        return VM_ERR_FRAME;
+    }
+    int err = vm_reserve((void**)&vm->locals, &vm->local_capacity, vm->local_count + 1, sizeof(vm_frame));
+    if(err){
+        return err;
+    }
+    vm->locals[vm->local_count++] = vm->temporary;
+    vm->frame_top += vm->temporary.size;
+    vm->temporary.slots = NULL;
+    return 0;
+}
+
+/**
+ * Moves the top of the LF stack to TF, the previous TF is discarded
+ * \param vm
+ * \return 0: success, VM_ERR_FRAME: LF does not exist
+ */
+static int vm_pop_frame(vm_state* vm){
+    if(vm->local_count == 0){
+        return VM_ERR_FRAME;
+    }
+    if(vm->temporary.slots != NULL){
+        vm_clear_frame(&vm->temporary);
+    }
+    vm->temporary = vm->locals[--vm->local_count];
+    vm->frame_top -= vm->temporary.size;
+    return 0;
+}
+
+/**
+ * Finds frame of variable operand
+ * \param vm
+ * \param operand
+ * \param out
+ * \return 0: success, VM_ERR_FRAME: frame does not exist
+ */
+static int vm_get_frame(vm_state* vm, const vm_operand* operand, vm_frame** out){
+    switch(operand->kind){
+        case VM_OPERAND_GF:
+            *out = &vm->global;
+            return 0;
+        case VM_OPERAND_LF:
+            if(vm->local_count == 0){
+                return VM_ERR_FRAME;
+            }
+            *out = &vm->locals[vm->local_count - 1];
+            return 0;
+        case VM_OPERAND_TF:
+            if(vm->temporary.slots == NULL){
+                return VM_ERR_FRAME;
+            }
+            *out = &vm->temporary;
+            return 0;
+        default:
+            return VM_ERR_INTERNAL;
+    }
+}
+
+/**
+ * Finds slot of variable
+ * \param vm
+ * \param operand variable operand
+ * \param out
+ * \return 0: success, VM_ERR_FRAME, VM_ERR_UNDEFINED_VAR
+ */
+static int vm_lookup(vm_state* vm, const vm_operand* operand, vm_value** out){
+    vm_frame* frame;
+    int err = vm_get_frame(vm, operand, &frame);
+    if(err){
+        return err;
+    }
+    if(operand->index >= frame->size || vm_is(frame->slots[operand->index], VM_UNDECLARED)){
+        return VM_ERR_UNDEFINED_VAR;
+    }
+    *out = &frame->slots[operand->index];
+    return 0;
+}
+
+/**
+ * Declares variable without value
+ * \param vm
+ * \param operand variable operand
+ * \return 0: success, VM_ERR_FRAME, VM_ERR_SEMANTIC: redefinition, VM_ERR_INTERNAL
+ */
+static int vm_define(vm_state* vm, const vm_operand* operand){
+    vm_frame* frame;
+    int err = vm_get_frame(vm, operand, &frame);
+    if(err){
+        return err;
+    }
+    if(operand->index >= frame->size){
+        return VM_ERR_INTERNAL;
+    }
+    if(!vm_is(frame->slots[operand->index], VM_UNDECLARED)){
+        return VM_ERR_SEMANTIC;
+    }
+    frame->slots[operand->index] = vm_simple(VM_UNDEFINED);
+    return 0;
+}
+
+// Operands
+
+/**
+ * Reads value of symbol, strings are borrowed from the variable or the program
+ * \param vm
+ * \param operand variable or literal
+ * \param out
+ * \return 0: success, VM_ERR_FRAME, VM_ERR_UNDEFINED_VAR, VM_ERR_MISSING_VALUE
+ */
+static int vm_symbol(vm_state* vm, const vm_operand* operand, vm_value* out){
+    vm_value* variable;
+    if(operand->kind == VM_OPERAND_CONST){
+        *out = operand->constant;
+        return 0;
+    }
+    int err = vm_lookup(vm, operand, &variable);
+    if(err){
+        return err;
+    }
+    if(vm_is(*variable, VM_UNDEFINED)){
+        return VM_ERR_MISSING_VALUE;
+    }
+    *out = *variable;
+    return 0;
+}
+
+/**
+ * Stores value to variable, the variable takes ownership of the value
+ * \param vm
+ * \param operand variable operand
+ * \param value owned value
+ * \return 0: success, VM_ERR_FRAME, VM_ERR_UNDEFINED_VAR
+ */
+static int vm_store(vm_state* vm, const vm_operand* operand, vm_value value){
+    vm_value* variable;
+    int err = vm_lookup(vm, operand, &variable);
+    if(err){
+        vm_free_value(&value);
+        return err;
+    }
+    vm_free_value(variable);
+    *variable = value;
+    return 0;
+}
+
+// Data stack
+
+static int vm_push(vm_state* vm, vm_value value){
+    int err = vm_reserve((void**)&vm->stack, &vm->stack_capacity, vm->stack_count + 1, sizeof(vm_value));
+    if(err){
+        vm_free_value(&value);
+        return err;
+    }
+    vm->stack[vm->stack_count++] = value;
+    return 0;
+}
+
+/**
+ * Pushes copy of symbol to the data stack
+ * \param vm
+ * \param operand variable or literal
+ * \return 0: success, runtime error code
+ */
+static int vm_push_symbol(vm_state* vm, const vm_operand* operand){
+    vm_value value;
+    int err = vm_symbol(vm, operand, &value);
+    return err ? err : vm_push(vm, vm_copy_value(value));
+}
+
+static int vm_pop(vm_state* vm, vm_value* out){
+    if(vm->stack_count == 0){
+        return VM_ERR_MISSING_VALUE;
+    }
+    *out = vm->stack[--vm->stack_count];
+    return 0;
+}
+
+static void vm_clear_stack(vm_state* vm){
+    while(vm->stack_count > 0){
+        vm_free_value(&vm->stack[--vm->stack_count]);
+    }
+}
+
+// Calls
+
+/**
+ * Jumps to function, the return address is pushed to the call stack
+ * \param vm
+ * \param target first instruction of the function
+ * \param return_address
+ * \return 0: success, VM_ERR_INTERNAL
+ */
+static int vm_call(vm_state* vm, size_t target, size_t return_address){
+    int err = vm_reserve((void**)&vm->calls, &vm->call_capacity, vm->call_count + 1, sizeof(size_t));
+    if(err){
+        return err;
+    }
+    vm->calls[vm->call_count++] = return_address;
+    vm->ip = target;
+    return 0;
+}
+
+/**
+ * Jumps to the return address from the call stack
+ * \param vm
+ * \return 0: success, VM_ERR_MISSING_VALUE: empty call stack
+ */
+static int vm_return(vm_state* vm){
+    if(vm->call_count == 0){
+        return VM_ERR_MISSING_VALUE;
+    }
+    vm->ip = vm->calls[--vm->call_count];
+    return 0;
+}
+
+// Operations
+
+/**
+ * Arithmetic operation of two numbers of the same type
+ * \param op IR_ADD, IR_SUB, IR_MUL, IR_DIV, IR_IDIV or their stack variant
+ * \param a
+ * \param b
+ * \param out
+ * \return 0: success, VM_ERR_OPERAND_TYPE, VM_ERR_OPERAND_VALUE: division by zero, int result out of range
+ */
+static int vm_arithmetic(ir_opcode op, vm_value a, vm_value b, vm_value* out){
+    if(vm_both(a, b, VM_INT)){
+        // Two's complement wrap around instead of undefined overflow
+        unsigned long long x = vm_as_int(a);
+        unsigned long long y = vm_as_int(b);
+        switch(op){
+            case IR_ADD:
+            case IR_ADDS:
+                return vm_make_int(x + y, out);
+            case IR_SUB:
+            case IR_SUBS:
+                return vm_make_int(x - y, out);
+            case IR_MUL:
+            case IR_MULS:
+                return vm_make_int(x * y, out);
+            case IR_IDIV:
+            case IR_IDIVS:
+                if(y == 0){
+                    return VM_ERR_OPERAND_VALUE;
+                }
+                if(vm_as_int(b) == -1){
+                    return vm_make_int(0 - x, out);
+                }
+                return vm_make_int(vm_as_int(a) / vm_as_int(b), out);
+            default:
+                return VM_ERR_OPERAND_TYPE;
+        }
+    }
+    if(!vm_both(a, b, VM_FLOAT)){
+        return VM_ERR_OPERAND_TYPE;
+    }
+    double x = vm_as_float(a);
+    double y = vm_as_float(b);
+    switch(op){
+        case IR_ADD:
+        case IR_ADDS:
+            *out = vm_float(x + y);
+            return 0;
+        case IR_SUB:
+        case IR_SUBS:
+            *out = vm_float(x - y);
+            return 0;
+        case IR_MUL:
+        case IR_MULS:
+            *out = vm_float(x * y);
+            return 0;
+        case IR_DIV:
+        case IR_DIVS:
+            if(y == 0.0){
+                return VM_ERR_OPERAND_VALUE;
+            }
+            *out = vm_float(x / y);
+            return 0;
+        default:
+            return VM_ERR_OPERAND_TYPE;
+    }
+}
+
+/**
+ * Compares two strings
+ * \param a
+ * \param b
+ * \param out negative, zero or positive like strcmp
+ * \return 0: success, VM_ERR_INTERNAL
+ */
+static int vm_compare_strings(vm_value a, vm_value b, int* out){
+    const char *x, *y;
+    int err;
+    if(vm_as_string(a) == vm_as_string(b)){
+        *out = 0;
+        return 0;
+    }
+    if((err = vm_characters(a, &x)) || (err = vm_characters(b, &y))){
+        return err;
+    }
+    *out = strcmp(x, y);
+    return 0;
+}
+
+/**
+ * Equality of two values, nil can be compared with any type
+ * \param a
+ * \param b
+ * \param out
+ * \return 0: success, VM_ERR_OPERAND_TYPE
+ */
+static int vm_equal(vm_value a, vm_value b, bool* out){
+    vm_type type = vm_type_of(a);
+    int order = 0, err;
+    if(type == VM_NIL || vm_is(b, VM_NIL)){
+        *out = vm_is(b, type);
+        return 0;
+    }
+    if(!vm_is(b, type)){
+        return VM_ERR_OPERAND_TYPE;
+    }
+    switch(type){
+        case VM_INT:
+            *out = vm_as_int(a) == vm_as_int(b);
+            return 0;
+        case VM_FLOAT:
+            *out = vm_as_float(a) == vm_as_float(b);
+            return 0;
+        case VM_BOOL:
+            *out = vm_as_bool(a) == vm_as_bool(b);
+            return 0;
+        case VM_STRING:
+            if(vm_as_string(a)->length != vm_as_string(b)->length){
+                *out = false;
+                return 0;
+            }
+            err = vm_compare_strings(a, b, &order);
+            *out = order == 0;
+            return err;
+        default:
+            return VM_ERR_OPERAND_TYPE;
+    }
+}
+
+/**
+ * Less than of two values of the same type, nil can not be compared
+ * \param a
+ * \param b
+ * \param out
+ * \return 0: success, VM_ERR_OPERAND_TYPE
+ */
+static int vm_less(vm_value a, vm_value b, bool* out){
+    vm_type type = vm_type_of(a);
+    int order = 0, err;
+    if(!vm_is(b, type)){
+        return VM_ERR_OPERAND_TYPE;
+    }
+    switch(type){
+        case VM_INT:
+            *out = vm_as_int(a) < vm_as_int(b);
+            return 0;
+        case VM_FLOAT:
+            *out = vm_as_float(a) < vm_as_float(b);
+            return 0;
+        case VM_BOOL:
+            *out = !vm_as_bool(a) && vm_as_bool(b);
+            return 0;
+        case VM_STRING:
+            err = vm_compare_strings(a, b, &order);
+            *out = order < 0;
+            return err;
+        default:
+            return VM_ERR_OPERAND_TYPE;
+    }
+}
+
+/**
+ * Relational operation
+ * \param op IR_LT, IR_GT, IR_EQ or their stack variant
+ * \param a
+ * \param b
+ * \param out bool value
+ * \return 0: success, VM_ERR_OPERAND_TYPE
+ */
+static int vm_relation(ir_opcode op, vm_value a, vm_value b, vm_value* out){
+    bool result;
+    int err;
+    switch(op){
+        case IR_LT:
+        case IR_LTS:
+            err = vm_less(a, b, &result);
+            break;
+        case IR_GT:
+        case IR_GTS:
+            err = vm_less(b, a, &result);
+            break;
+        default:
+            err = vm_equal(a, b, &result);
+            break;
+    }
+    *out = vm_bool(result);
+    return err;
+}
+
+/**
+ * Reads line from stdin and converts it to value of given type, nil on EOF or invalid input
+ * \param type int, float, string or bool
+ * \param out
+ * \return 0: success, VM_ERR_OPERAND_VALUE: int out of range of the value representation, VM_ERR_INTERNAL
+ */
+static int vm_read(const char* type, vm_value* out){
+    char* line;
+    size_t length;
+    int err = vm_read_line(&line, &length);
+    *out = vm_simple(VM_NIL);
+    if(err || line == NULL){
+        return err;
+    }
+    if(strcmp(type, "string") == 0){
+        return vm_make_string(line, strlen(line), out);
+    }
+    if(strcmp(type, "int") == 0){
+        long long number;
+        if(vm_parse_int(line, length, &number)){
+            return vm_make_int(number, out);
+        }
+    }
+    else if(strcmp(type, "float") == 0){
+        double number;
+        if(vm_parse_float(line, length, &number)){
+            *out = vm_float(number);
+        }
+    }
+    else if(strcmp(type, "bool") == 0){
+        *out = vm_bool(strcasecmp(line, "true") == 0);
+    }
+    return 0;
+}
+
+/**
+ * Writes value to the output buffer
+ * \param value
+ * \return 0: success, VM_ERR_INTERNAL
+ */
+static int vm_write(vm_value value){
+    const char* characters;
+    int err;
+    switch(vm_type_of(value)){
+        case VM_INT:
+            vm_write_int(vm_as_int(value));
+            break;
+        case VM_FLOAT:
+            vm_write_float(vm_as_float(value));
+            break;
+        case VM_BOOL:
+            vm_write_bytes(vm_as_bool(value) ? "true" : "false", vm_as_bool(value) ? 4 : 5);
+            break;
+        case VM_STRING:
+            if((err = vm_characters(value, &characters))){
+                return err;
+            }
+            vm_write_bytes(characters, vm_as_string(value)->length);
+            break;
+        default:
+            break;
+    }
+    return 0;
+}
+
+/**
+ * Arithmetic or relational instruction with three operands
+ * \param vm
+ * \param op
+ * \param args destination and two symbols
+ * \return 0: success, runtime error code
+ */
+static int vm_binary(vm_state* vm, ir_opcode op, const vm_operand* args){
+    vm_value a, b, result;
+    int err;
+    if((err = vm_symbol(vm, &args[1], &a)) || (err = vm_symbol(vm, &args[2], &b))){
+        return err;
+    }
+    err = op == IR_LT || op == IR_GT || op == IR_EQ ? vm_relation(op, a, b, &result) : vm_arithmetic(op, a, b, &result);
+    return err ? err : vm_store(vm, &args[0], result);
+}
+
+/**
+ * Arithmetic or relational instruction on the data stack
+ * \param vm
+ * \param op
+ * \return 0: success, runtime error code
+ */
+static int vm_binary_stack(vm_state* vm, ir_opcode op){
+    vm_value a, b, result;
+    if(vm->stack_count < 2){
+        return VM_ERR_MISSING_VALUE;
+    }
+    vm_pop(vm, &b);
+    vm_pop(vm, &a);
+    int err = op == IR_LTS || op == IR_GTS || op == IR_EQS ? vm_relation(op, a, b, &result) : vm_arithmetic(op, a, b, &result);
+    vm_free_value(&a);
+    vm_free_value(&b);
+    return err ? err : vm_push(vm, result);
+}
+
+/**
+ * Conditional jump
+ * \param vm
+ * \param args label and two symbols
+ * \param jump_if_equal jumpifeq | jumpifneq
+ * \return 0: success, runtime error code
+ */
+static int vm_jump_if(vm_state* vm, const vm_operand* args, bool jump_if_equal){
+    vm_value a, b;
+    bool equal;
+    int err;
+    if((err = vm_symbol(vm, &args[1], &a)) || (err = vm_symbol(vm, &args[2], &b)) || (err = vm_equal(a, b, &equal))){
+        return err;
+    }
+    if(equal == jump_if_equal){
+        vm->ip = args[0].index;
+    }
+    return 0;
+}
+
+/**
+ * Concatenation of two strings
+ * \param vm
+ * \param args destination and two symbols
+ * \param a string value of the first symbol
+ * \param b string value of the second symbol
+ * \return 0: success, runtime error code
+ */
+static int vm_concat(vm_state* vm, const vm_operand* args, vm_value a, vm_value b){
+    // Destination is the only owner of the first string, it can be extended in place
+    if(args[0].kind == args[1].kind && args[0].index == args[1].index && vm_as_string(a)->refs == 1){
+        return rope_append(vm_as_string(a), vm_as_string(b)) ? 0 : VM_ERR_INTERNAL;
+    }
+    rope* string = rope_concat(vm_as_string(a), vm_as_string(b));
+    if(string == NULL){
+        return VM_ERR_INTERNAL;
+    }
+    return vm_store(vm, &args[0], vm_string(string));
+}
+
+/**
+ * Superinstruction pushs a; pushs b; <op>s; pops x for two ints or two floats, the stack is not used.
+ * Sequence that would fail or works with other types is not executed and is left to the original instructions.
+ * \param vm
+ * \param sequence the first instruction of the sequence
+ * \param out value stored to x
+ * \return the sequence was executed
+ */
+static bool vm_fused_binary(vm_state* vm, const vm_instruction* sequence, vm_value* out){
+    vm_value a, b;
+    vm_value* variable;
+    if(vm_symbol(vm, &sequence[0].args[0], &a) || vm_symbol(vm, &sequence[1].args[0], &b) ||
+       vm_lookup(vm, &sequence[3].args[0], &variable)){
+        return false;
+    }
+    if(vm_both(a, b, VM_INT)){
+        long long x = vm_as_int(a), y = vm_as_int(b);
+        switch(sequence[2].op){
+            case IR_ADDS:
+            case VM_ADDS_I32:
+            case VM_ADDS_F64:
+                if(vm_make_int((unsigned long long)x + (unsigned long long)y, out)){
+                    return false;
+                }
+                break;
+            case IR_SUBS:
+            case VM_SUBS_I32:
+            case VM_SUBS_F64:
+                if(vm_make_int((unsigned long long)x - (unsigned long long)y, out)){
+                    return false;
+                }
+                break;
+            case IR_MULS:
+            case VM_MULS_I32:
+            case VM_MULS_F64:
+                if(vm_make_int((unsigned long long)x * (unsigned long long)y, out)){
+                    return false;
+                }
+                break;
+            case IR_LTS:
+            case VM_LTS_I32:
+            case VM_LTS_F64:
+                *out = vm_bool(x < y);
+                break;
+            case IR_GTS:
+            case VM_GTS_I32:
+            case VM_GTS_F64:
+                *out = vm_bool(x > y);
+                break;
+            case IR_EQS:
+            case VM_EQS_I32:
+            case VM_EQS_F64:
+                *out = vm_bool(x == y);
+                break;
+            default:
+                return false;
+        }
+    }
+    else if(vm_both(a, b, VM_FLOAT)){
+        double x = vm_as_float(a), y = vm_as_float(b);
+        switch(sequence[2].op){
+            case IR_ADDS:
+            case VM_ADDS_I32:
+            case VM_ADDS_F64:
+                *out = vm_float(x + y);
+                break;
+            case IR_SUBS:
+            case VM_SUBS_I32:
+            case VM_SUBS_F64:
+                *out = vm_float(x - y);
+                break;
+            case IR_MULS:
+            case VM_MULS_I32:
+            case VM_MULS_F64:
+                *out = vm_float(x * y);
+                break;
+            case IR_LTS:
+            case VM_LTS_I32:
+            case VM_LTS_F64:
+                *out = vm_bool(x < y);
+                break;
+            case IR_GTS:
+            case VM_GTS_I32:
+            case VM_GTS_F64:
+                *out = vm_bool(x > y);
+                break;
+            case IR_EQS:
+            case VM_EQS_I32:
+            case VM_EQS_F64:
+                *out = vm_bool(x == y);
+                break;
+            default:
+                return false;
+        }
+    }
+    else{
+        return false;
+    }
+    vm_free_value(variable);
+    *variable = *out;
+    return true;
+}
+
+#ifdef VM_JIT
+// Native code
+
+/**
+ * Fills context of native code from the state of the interpreter
+ * \param vm
+ * \param context
+ */
+static void vm_jit_context(vm_state* vm, jit_context* context){
+    vm_frame* local = vm->local_count > 0 ? &vm->locals[vm->local_count - 1] : NULL;
+    context->global = vm->global.slots;
+    context->local = local != NULL ? local->slots : NULL;
+    context->local_size = local != NULL ? local->size : 0;
+    context->temporary = vm->temporary.slots;
+    context->temporary_size = vm->temporary.slots != NULL ? vm->temporary.size : 0;
+    context->stack = vm->stack;
+    context->stack_used = vm->stack_count * sizeof(vm_value);
+    context->stack_size = vm->stack_capacity * sizeof(vm_value);
+}
+
+/**
+ * Executes instruction without a template for native code
+ * \param context
+ * \param ip
+ * \return index of the next instruction | JIT_ERROR
+ */
+static size_t vm_jit_helper(jit_context* context, size_t ip){
+    vm_state* vm = context->vm;
+    const vm_instruction* instruction = &vm->code->code[ip];
+    const vm_operand* args = instruction->args;
+    vm_value value;
+    int err = 0;
+    vm->stack_count = context->stack_used / sizeof(vm_value);
+    // Error is reported at the instruction, calls and returns change the next instruction
+    vm->ip = ip + 1;
+    switch(instruction->op){
+        case IR_CREATEFRAME:
+            err = vm_create_frame(vm, args[0].index);
+            break;
+        case IR_PUSHFRAME:
+            err = vm_push_frame(vm);
+            break;
+        case IR_POPFRAME:
+            err = vm_pop_frame(vm);
+            break;
+        case IR_CALL:
+            err = vm_call(vm, args[0].index, ip + 1);
+            break;
+        case IR_RETURN:
+            err = vm_return(vm);
+            break;
+        case IR_CLEARS:
+            vm_clear_stack(vm);
+            break;
+        case IR_READ:
+            if(!(err = vm_read(vm_as_string(args[1].constant)->data, &value))){
+                err = vm_store(vm, &args[0], value);
+            }
+            break;
+        case IR_WRITE:
+            if(!(err = vm_symbol(vm, &args[0], &value))){
+                err = vm_write(value);
+            }
+            break;
+        default:
+            err = VM_ERR_INTERNAL;
+            break;
+    }
+    if(err){
+        context->error = err;
+        return JIT_ERROR;
+    }
+    vm_jit_context(vm, context);
+    return vm->ip;
+}
+
+/**
+ * Executes native code of the current instruction while there is one, native code continues in other regions
+ * \param vm
+ * \return 0: success, runtime error code
+ */
+static int vm_jit_enter(vm_state* vm){
+    jit_function function;
+    jit_context context = {.vm = vm, .helper = vm_jit_helper};
+    while((function = jit_lookup(&vm->jit, vm->code, vm->ip)) != NULL){
+        vm_jit_context(vm, &context);
+        size_t next = function(&context);
+        vm->stack_count = context.stack_used / sizeof(vm_value);
+        if(next == JIT_ERROR){
+            return context.error;
+        }
+        vm->ip = next & ~JIT_TRANSFER;
+        // Failed guard, the interpreter executes the instruction
+        if(!(next & JIT_TRANSFER)){
+            break;
+        }
+    }
+    return 0;
+}
+
+// Enters native code at the current instruction when it is hot
+#define VM_JIT_ENTER { if((err = vm_jit_enter(vm))){ return err; } }
+// Backward jumps are loops
+#define VM_JIT_BACKWARD { if(vm->ip <= (size_t)(instruction - code)){ VM_JIT_ENTER; } }
+#else
+#define VM_JIT_ENTER
+#define VM_JIT_BACKWARD
+#endif
+
+// Dispatch of instructions, direct threaded code with GCC computed goto unless built with -DVM_SWITCH_DISPATCH
+#if defined(__GNUC__) && !defined(VM_SWITCH_DISPATCH)
+#define VM_THREADED_DISPATCH
+#endif
+
+#ifdef VM_THREADED_DISPATCH
+// Handler of instruction is a label with the name of its opcode
+#define VM_CASE(op) op:
+#define VM_DEFAULT VM_INVALID:
+// Jumps directly to the handler of the next instruction
+#define VM_DISPATCH \
+    instruction = &code[vm->ip++]; \
+    args = instruction->args; \
+    goto *instruction->handler
+#else
+#define VM_CASE(op) case op:
+#define VM_DEFAULT default:
+#define VM_DISPATCH continue
+#endif
+
+// Finishes instruction, continues with the next one when the result is not an error
+#define VM_NEXT(result) { if((err = (result))){ return err; } VM_DISPATCH; }
+
+// Operands of binary stack instruction
+#define VM_STACK_A vm->stack[vm->stack_count - 2]
+#define VM_STACK_B vm->stack[vm->stack_count - 1]
+
+/*
+ * Fast paths of instructions with two int operands x and y, the type check is a tag compare.
+ * Other operands and all errors are handled by the generic implementation that follows.
+ */
+#define VM_INT_BINARY(expression) \
+    if(!vm_symbol(vm, &args[1], &a) && !vm_symbol(vm, &args[2], &b) && vm_both(a, b, VM_INT)){ \
+        long long x = vm_as_int(a), y = vm_as_int(b); \
+        VM_NEXT(vm_store(vm, &args[0], (expression))); \
+    }
+// Result replaces both operands on the data stack
+#define VM_INT_STACK(expression) \
+    if(vm->stack_count >= 2 && vm_both(VM_STACK_A, VM_STACK_B, VM_INT)){ \
+        long long x = vm_as_int(VM_STACK_A), y = vm_as_int(VM_STACK_B); \
+        VM_STACK_A = (expression); \
+        vm->stack_count--; \
+        VM_DISPATCH; \
+    }
+#define VM_INT_JUMP(condition) \
+    if(!vm_symbol(vm, &args[1], &a) && !vm_symbol(vm, &args[2], &b) && vm_both(a, b, VM_INT)){ \
+        long long x = vm_as_int(a), y = vm_as_int(b); \
+        if(condition){ \
+            vm->ip = args[0].index; \
+            VM_JIT_BACKWARD; \
+        } \
+        VM_DISPATCH; \
+    }
+
+// Stack instruction with operand types proven by the compiler, x and y are i32 or f64 operands
+#define VM_PROVEN_STACK(type, as, expression) { \
+        if(vm->stack_count < 2){ \
+            return VM_ERR_MISSING_VALUE; \
+        } \
+        type x = as(VM_STACK_A), y = as(VM_STACK_B); \
+        VM_STACK_A = (expression); \
+        vm->stack_count--; \
+        VM_DISPATCH; \
+    }
+#define VM_I32_STACK(expression) VM_PROVEN_STACK(long long, vm_as_int, expression)
+#define VM_F64_STACK(expression) VM_PROVEN_STACK(double, vm_as_float, expression)
+// Variants of the int fast paths whose integer result has to fit into the value representation
+#define VM_INT_RESULT(expression, out) \
+    if((err = vm_make_int((expression), &(out)))){ \
+        return err; \
+    }
+#define VM_INT_ARITHMETIC(expression) \
+    if(!vm_symbol(vm, &args[1], &a) && !vm_symbol(vm, &args[2], &b) && vm_both(a, b, VM_INT)){ \
+        long long x = vm_as_int(a), y = vm_as_int(b); \
+        VM_INT_RESULT(expression, result); \
+        VM_NEXT(vm_store(vm, &args[0], result)); \
+    }
+#define VM_INT_ARITHMETIC_STACK(expression) \
+    if(vm->stack_count >= 2 && vm_both(VM_STACK_A, VM_STACK_B, VM_INT)){ \
+        long long x = vm_as_int(VM_STACK_A), y = vm_as_int(VM_STACK_B); \
+        VM_INT_RESULT(expression, VM_STACK_A); \
+        vm->stack_count--; \
+        VM_DISPATCH; \
+    }
+#define VM_I32_ARITHMETIC_STACK(expression) { \
+        if(vm->stack_count < 2){ \
+            return VM_ERR_MISSING_VALUE; \
+        } \
+        long long x = vm_as_int(VM_STACK_A), y = vm_as_int(VM_STACK_B); \
+        VM_INT_RESULT(expression, VM_STACK_A); \
+        vm->stack_count--; \
+        VM_DISPATCH; \
+    }
+
+#ifdef VM_THREADED_DISPATCH
+// Labels as values are GNU extension
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+#endif
+
+/**
+ * Interprets loaded code from the current instruction until exit instruction
+ * \param vm
+ * \param code loaded code ending with exit instruction
+ * \param exit_code set by exit instruction
+ * \return 0: success, runtime error code
+ */
+static int vm_interpret(vm_state* vm, vm_instruction* code, int* exit_code){
+    const vm_instruction* instruction;
+    const vm_operand* args;
+    vm_value a, b, result;
+    vm_value* variable;
+    rope* string;
+    const char* characters;
+    char character;
+    int err = 0;
+#ifdef VM_THREADED_DISPATCH
+    static const void* handlers[VM_OPCODE_COUNT] = {
+        [IR_MOVE] = &&IR_MOVE, [IR_CREATEFRAME] = &&IR_CREATEFRAME, [IR_PUSHFRAME] = &&IR_PUSHFRAME,
+        [IR_POPFRAME] = &&IR_POPFRAME, [IR_DEFVAR] = &&IR_DEFVAR, [IR_CALL] = &&IR_CALL, [IR_RETURN] = &&IR_RETURN,
+        [IR_PUSHS] = &&IR_PUSHS, [IR_POPS] = &&IR_POPS, [IR_CLEARS] = &&IR_CLEARS,
+        [IR_ADD] = &&IR_ADD, [IR_SUB] = &&IR_SUB, [IR_MUL] = &&IR_MUL, [IR_DIV] = &&IR_DIV, [IR_IDIV] = &&IR_IDIV,
+        [IR_ADDS] = &&IR_ADDS, [IR_SUBS] = &&IR_SUBS, [IR_MULS] = &&IR_MULS, [IR_DIVS] = &&IR_DIVS, [IR_IDIVS] = &&IR_IDIVS,
+        [IR_LT] = &&IR_LT, [IR_GT] = &&IR_GT, [IR_EQ] = &&IR_EQ, [IR_LTS] = &&IR_LTS, [IR_GTS] = &&IR_GTS, [IR_EQS] = &&IR_EQS,
+        [IR_ORS] = &&IR_ORS, [IR_NOTS] = &&IR_NOTS,
+        [IR_INT2FLOAT] = &&IR_INT2FLOAT, [IR_FLOAT2INT] = &&IR_FLOAT2INT, [IR_INT2CHAR] = &&IR_INT2CHAR, [IR_STRI2INT] = &&IR_STRI2INT,
+        [IR_READ] = &&IR_READ, [IR_WRITE] = &&IR_WRITE,
+        [IR_CONCAT] = &&IR_CONCAT, [IR_STRLEN] = &&IR_STRLEN, [IR_GETCHAR] = &&IR_GETCHAR, [IR_SETCHAR] = &&IR_SETCHAR,
+        [IR_TYPE] = &&IR_TYPE, [IR_JUMP] = &&IR_JUMP, [IR_JUMPIFEQ] = &&IR_JUMPIFEQ, [IR_JUMPIFNEQ] = &&IR_JUMPIFNEQ,
+        [IR_EXIT] = &&IR_EXIT,
+        [VM_FUSED_BINARY] = &&VM_FUSED_BINARY, [VM_FUSED_BRANCH] = &&VM_FUSED_BRANCH,
+        [VM_ADDS_I32] = &&VM_ADDS_I32, [VM_SUBS_I32] = &&VM_SUBS_I32, [VM_MULS_I32] = &&VM_MULS_I32, [VM_IDIVS_I32] = &&VM_IDIVS_I32,
+        [VM_LTS_I32] = &&VM_LTS_I32, [VM_GTS_I32] = &&VM_GTS_I32, [VM_EQS_I32] = &&VM_EQS_I32,
+        [VM_ADDS_F64] = &&VM_ADDS_F64, [VM_SUBS_F64] = &&VM_SUBS_F64, [VM_MULS_F64] = &&VM_MULS_F64, [VM_DIVS_F64] = &&VM_DIVS_F64,
+        [VM_LTS_F64] = &&VM_LTS_F64, [VM_GTS_F64] = &&VM_GTS_F64, [VM_EQS_F64] = &&VM_EQS_F64,
+        [VM_CONCAT_STR] = &&VM_CONCAT_STR,
+    };
+    // Handler addresses are resolved once before the execution, the last instruction is always exit
+    for(size_t i = 0; i < vm->code->count; i++){
+        code[i].handler = handlers[code[i].op] != NULL ? handlers[code[i].op] : &&VM_INVALID;
+    }
+    VM_DISPATCH;
+#else
+    while(true){
+        instruction = &code[vm->ip++];
+        args = instruction->args;
+        switch(instruction->op){
+#endif
+        VM_CASE(IR_MOVE)
+            if((err = vm_symbol(vm, &args[1], &a))){
+                return err;
+            }
+            VM_NEXT(vm_store(vm, &args[0], vm_copy_value(a)));
+        VM_CASE(IR_CREATEFRAME)
+            // Size of the frame is resolved by the loader
+            VM_NEXT(vm_create_frame(vm, args[0].index));
+        VM_CASE(IR_PUSHFRAME)
+            VM_NEXT(vm_push_frame(vm));
+        VM_CASE(IR_POPFRAME)
+            VM_NEXT(vm_pop_frame(vm));
+        VM_CASE(IR_DEFVAR)
+            VM_NEXT(vm_define(vm, &args[0]));
+        VM_CASE(IR_CALL)
+            if((err = vm_call(vm, args[0].index, vm->ip))){
+                return err;
+            }
+            VM_JIT_ENTER;
+            VM_DISPATCH;
+        VM_CASE(IR_RETURN)
+            if((err = vm_return(vm))){
+                return err;
+            }
+            VM_JIT_ENTER;
+            VM_DISPATCH;
+        VM_CASE(IR_PUSHS)
+            VM_NEXT(vm_push_symbol(vm, &args[0]));
+        VM_CASE(IR_POPS)
+            if((err = vm_lookup(vm, &args[0], &variable)) || (err = vm_pop(vm, &a))){
+                return err;
+            }
+            vm_free_value(variable);
+            *variable = a;
+            VM_NEXT(0);
+        VM_CASE(IR_CLEARS)
+            vm_clear_stack(vm);
+            VM_NEXT(0);
+        VM_CASE(IR_ADD)
+            VM_INT_ARITHMETIC((unsigned long long)x + (unsigned long long)y);
+            VM_NEXT(vm_binary(vm, IR_ADD, args));
+        VM_CASE(IR_SUB)
+            VM_INT_ARITHMETIC((unsigned long long)x - (unsigned long long)y);
+            VM_NEXT(vm_binary(vm, IR_SUB, args));
+        VM_CASE(IR_MUL)
+            VM_INT_ARITHMETIC((unsigned long long)x * (unsigned long long)y);
+            VM_NEXT(vm_binary(vm, IR_MUL, args));
+        VM_CASE(IR_DIV)
+        VM_CASE(IR_IDIV)
+            VM_NEXT(vm_binary(vm, instruction->op, args));
+        VM_CASE(IR_ADDS)
+            VM_INT_ARITHMETIC_STACK((unsigned long long)x + (unsigned long long)y);
+            VM_NEXT(vm_binary_stack(vm, IR_ADDS));
+        VM_CASE(IR_SUBS)
+            VM_INT_ARITHMETIC_STACK((unsigned long long)x - (unsigned long long)y);
+            VM_NEXT(vm_binary_stack(vm, IR_SUBS));
+        VM_CASE(IR_MULS)
+            VM_INT_ARITHMETIC_STACK((unsigned long long)x * (unsigned long long)y);
+            VM_NEXT(vm_binary_stack(vm, IR_MULS));
+        VM_CASE(IR_DIVS)
+        VM_CASE(IR_IDIVS)
+            VM_NEXT(vm_binary_stack(vm, instruction->op));
+        VM_CASE(IR_LT)
+            VM_INT_BINARY(vm_bool(x < y));
+            VM_NEXT(vm_binary(vm, IR_LT, args));
+        VM_CASE(IR_GT)
+            VM_INT_BINARY(vm_bool(x > y));
+            VM_NEXT(vm_binary(vm, IR_GT, args));
+        VM_CASE(IR_EQ)
+            VM_INT_BINARY(vm_bool(x == y));
+            VM_NEXT(vm_binary(vm, IR_EQ, args));
+        VM_CASE(IR_LTS)
+            VM_INT_STACK(vm_bool(x < y));
+            VM_NEXT(vm_binary_stack(vm, IR_LTS));
+        VM_CASE(IR_GTS)
+            VM_INT_STACK(vm_bool(x > y));
+            VM_NEXT(vm_binary_stack(vm, IR_GTS));
+        VM_CASE(IR_EQS)
+            VM_INT_STACK(vm_bool(x == y));
+            VM_NEXT(vm_binary_stack(vm, IR_EQS));
+        VM_CASE(IR_ORS)
+            if(vm->stack_count < 2){
+                return VM_ERR_MISSING_VALUE;
+            }
+            if(!vm_both(VM_STACK_A, VM_STACK_B, VM_BOOL)){
+                return VM_ERR_OPERAND_TYPE;
+            }
+            VM_STACK_A = vm_bool(vm_as_bool(VM_STACK_A) || vm_as_bool(VM_STACK_B));
+            vm->stack_count--;
+            VM_NEXT(0);
+        VM_CASE(IR_NOTS)
+            if(vm->stack_count < 1){
+                return VM_ERR_MISSING_VALUE;
+            }
+            if(!vm_is(VM_STACK_B, VM_BOOL)){
+                return VM_ERR_OPERAND_TYPE;
+            }
+            VM_STACK_B = vm_bool(!vm_as_bool(VM_STACK_B));
+            VM_NEXT(0);
+        VM_CASE(IR_INT2FLOAT)
+            if((err = vm_symbol(vm, &args[1], &a))){
+                return err;
+            }
+            if(!vm_is(a, VM_INT)){
+                return VM_ERR_OPERAND_TYPE;
+            }
+            result = vm_float((double)vm_as_int(a));
+            VM_NEXT(vm_store(vm, &args[0], result));
+        VM_CASE(IR_FLOAT2INT)
+            if((err = vm_symbol(vm, &args[1], &a))){
+                return err;
+            }
+            if(!vm_is(a, VM_FLOAT)){
+                return VM_ERR_OPERAND_TYPE;
+            }
+            if((err = vm_make_int((long long)vm_as_float(a), &result))){
+                return err;
+            }
+            VM_NEXT(vm_store(vm, &args[0], result));
+        VM_CASE(IR_INT2CHAR)
+            if((err = vm_symbol(vm, &args[1], &a))){
+                return err;
+            }
+            if(!vm_is(a, VM_INT)){
+                return VM_ERR_OPERAND_TYPE;
+            }
+            if(vm_as_int(a) < 0 || vm_as_int(a) > 255){
+                return VM_ERR_STRING;
+            }
+            character = (char)vm_as_int(a);
+            if((err = vm_make_string(&character, 1, &result))){
+                return err;
+            }
+            VM_NEXT(vm_store(vm, &args[0], result));
+        VM_CASE(IR_STRI2INT)
+        VM_CASE(IR_GETCHAR)
+            if((err = vm_symbol(vm, &args[1], &a)) || (err = vm_symbol(vm, &args[2], &b))){
+                return err;
+            }
+            if(!vm_is(a, VM_STRING) || !vm_is(b, VM_INT)){
+                return VM_ERR_OPERAND_TYPE;
+            }
+            if(vm_as_int(b) < 0 || (size_t)vm_as_int(b) >= vm_as_string(a)->length){
+                return VM_ERR_STRING;
+            }
+            if((err = vm_characters(a, &characters))){
+                return err;
+            }
+            if(instruction->op == IR_GETCHAR){
+                if((err = vm_make_string(&characters[vm_as_int(b)], 1, &result))){
+                    return err;
+                }
+            }
+            else{
+                result = vm_int((unsigned char)characters[vm_as_int(b)]);
+            }
+            VM_NEXT(vm_store(vm, &args[0], result));
+        VM_CASE(IR_READ)
+            if((err = vm_read(vm_as_string(args[1].constant)->data, &result))){
+                return err;
+            }
+            VM_NEXT(vm_store(vm, &args[0], result));
+        VM_CASE(IR_WRITE)
+            if((err = vm_symbol(vm, &args[0], &a))){
+                return err;
+            }
+            VM_NEXT(vm_write(a));
+        VM_CASE(IR_CONCAT)
+            if((err = vm_symbol(vm, &args[1], &a)) || (err = vm_symbol(vm, &args[2], &b))){
+                return err;
+            }
+            if(!vm_both(a, b, VM_STRING)){
+                return VM_ERR_OPERAND_TYPE;
+            }
+            VM_NEXT(vm_concat(vm, args, a, b));
+        VM_CASE(VM_CONCAT_STR)
+            if((err = vm_symbol(vm, &args[1], &a)) || (err = vm_symbol(vm, &args[2], &b))){
+                return err;
+            }
+            VM_NEXT(vm_concat(vm, args, a, b));
+        VM_CASE(IR_STRLEN)
+            if((err = vm_symbol(vm, &args[1], &a))){
+                return err;
+            }
+            if(!vm_is(a, VM_STRING)){
+                return VM_ERR_OPERAND_TYPE;
+            }
+            result = vm_int(vm_as_string(a)->length);
+            VM_NEXT(vm_store(vm, &args[0], result));
+        VM_CASE(IR_SETCHAR)
+            if((err = vm_symbol(vm, &args[0], &result)) || (err = vm_symbol(vm, &args[1], &a)) || (err = vm_symbol(vm, &args[2], &b))){
+                return err;
+            }
+            if(!vm_is(result, VM_STRING) || !vm_is(a, VM_INT) || !vm_is(b, VM_STRING)){
+                return VM_ERR_OPERAND_TYPE;
+            }
+            if(vm_as_int(a) < 0 || (size_t)vm_as_int(a) >= vm_as_string(result)->length || vm_as_string(b)->length == 0){
+                return VM_ERR_STRING;
+            }
+            if((err = vm_characters(b, &characters)) || (err = vm_characters(result, &characters))){
+                return err;
+            }
+            character = vm_as_string(b)->data[0];
+            string = vm_as_string(result);
+            // Shared string is copied before the change
+            if(string->refs > 1){
+                if((err = vm_make_string(characters, string->length, &result)) || (err = vm_store(vm, &args[0], result))){
+                    return err;
+                }
+                string = vm_as_string(result);
+            }
+            string->data[vm_as_int(a)] = character;
+            VM_NEXT(0);
+        VM_CASE(IR_TYPE)
+            if(args[1].kind != VM_OPERAND_CONST){
+                if((err = vm_lookup(vm, &args[1], &variable))){
+                    return err;
+                }
+                a = *variable;
+            }
+            else if((err = vm_symbol(vm, &args[1], &a))){
+                return err;
+            }
+            if((err = vm_make_string(type_names[vm_type_of(a)], strlen(type_names[vm_type_of(a)]), &result))){
+                return err;
+            }
+            VM_NEXT(vm_store(vm, &args[0], result));
+        VM_CASE(IR_JUMP)
+            vm->ip = args[0].index;
+            VM_JIT_BACKWARD;
+            VM_DISPATCH;
+        VM_CASE(IR_JUMPIFEQ)
+            VM_INT_JUMP(x == y);
+            if((err = vm_jump_if(vm, args, true))){
+                return err;
+            }
+            VM_JIT_BACKWARD;
+            VM_DISPATCH;
+        VM_CASE(IR_JUMPIFNEQ)
+            VM_INT_JUMP(x != y);
+            if((err = vm_jump_if(vm, args, false))){
+                return err;
+            }
+            VM_JIT_BACKWARD;
+            VM_DISPATCH;
+        VM_CASE(IR_EXIT)
+            if((err = vm_symbol(vm, &args[0], &a))){
+                return err;
+            }
+            if(!vm_is(a, VM_INT)){
+                return VM_ERR_OPERAND_TYPE;
+            }
+            if(vm_as_int(a) < 0 || vm_as_int(a) > 9){
+                return VM_ERR_OPERAND_VALUE;
+            }
+            *exit_code = vm_as_int(a);
+            return 0;
+        VM_CASE(VM_FUSED_BINARY)
+            if(vm_fused_binary(vm, instruction, &result)){
+                vm->ip += 3;
+                VM_DISPATCH;
+            }
+            VM_NEXT(vm_push_symbol(vm, &args[0]));
+        VM_CASE(VM_FUSED_BRANCH)
+            // Relation is followed by jump comparing its result with bool literal
+            if(vm_fused_binary(vm, instruction, &result)){
+                if((vm_as_bool(result) == vm_as_bool(instruction[4].args[2].constant)) == (instruction[4].op == IR_JUMPIFEQ)){
+                    vm->ip = instruction[4].args[0].index;
+                    VM_JIT_BACKWARD;
+                }
+                else{
+                    vm->ip += 4;
+                }
+                VM_DISPATCH;
+            }
+            VM_NEXT(vm_push_symbol(vm, &args[0]));
+        VM_CASE(VM_ADDS_I32)
+            VM_I32_ARITHMETIC_STACK((unsigned long long)x + (unsigned long long)y);
+        VM_CASE(VM_SUBS_I32)
+            VM_I32_ARITHMETIC_STACK((unsigned long long)x - (unsigned long long)y);
+        VM_CASE(VM_MULS_I32)
+            VM_I32_ARITHMETIC_STACK((unsigned long long)x * (unsigned long long)y);
+        VM_CASE(VM_IDIVS_I32)
+            if(vm->stack_count >= 2 && vm_as_int(VM_STACK_B) == 0){
+                return VM_ERR_OPERAND_VALUE;
+            }
+            VM_I32_ARITHMETIC_STACK(y == -1 ? (long long)(0 - (unsigned long long)x) : x / y);
+        VM_CASE(VM_LTS_I32)
+            VM_I32_STACK(vm_bool(x < y));
+        VM_CASE(VM_GTS_I32)
+            VM_I32_STACK(vm_bool(x > y));
+        VM_CASE(VM_EQS_I32)
+            VM_I32_STACK(vm_bool(x == y));
+        VM_CASE(VM_ADDS_F64)
+            VM_F64_STACK(vm_float(x + y));
+        VM_CASE(VM_SUBS_F64)
+            VM_F64_STACK(vm_float(x - y));
+        VM_CASE(VM_MULS_F64)
+            VM_F64_STACK(vm_float(x * y));
+        VM_CASE(VM_DIVS_F64)
+            if(vm->stack_count >= 2 && vm_as_float(VM_STACK_B) == 0.0){
+                return VM_ERR_OPERAND_VALUE;
+            }
+            VM_F64_STACK(vm_float(x / y));
+        VM_CASE(VM_LTS_F64)
+            VM_F64_STACK(vm_bool(x < y));
+        VM_CASE(VM_GTS_F64)
+            VM_F64_STACK(vm_bool(x > y));
+        VM_CASE(VM_EQS_F64)
+            VM_F64_STACK(vm_bool(x == y));
+        VM_DEFAULT
+            return VM_ERR_INTERNAL;
+#ifndef VM_THREADED_DISPATCH
+        }
+    }
+#endif
+}
+
+#ifdef VM_THREADED_DISPATCH
+#pragma GCC diagnostic pop
+#endif
+
+
+
+static void vm_dispose(vm_state* vm){
+    for(size_t i = 0; i < vm->global.size; i++){
+        vm_free_value(&vm->global.slots[i]);
+    }
+    free(vm->global.slots);
+    for(size_t i = 0; i < vm->local_count; i++){
+        vm_clear_frame(&vm->locals[i]);
+    }
+    if(vm->temporary.slots != NULL){
+        vm_clear_frame(&vm->temporary);
+    }
+    free(vm->frame_stack);
+    free(vm->locals);
+    vm_clear_stack(vm);
+    free(vm->stack);
+    free(vm->calls);
+#ifdef VM_JIT
+    jit_free(&vm->jit);
+#endif
+}
+
+/**
+ * Prints runtime error with the instruction that caused it
+ * \param program
+ * \param index index of the instruction in the program
+ * \param err
+ */
+static void vm_print_error(const ir_program* program, size_t index, int err){
+    fprintf(stderr, "runtime error(%02d)", err);
+    if(index < program->count){
+        const ir_instruction* instruction = &program->code[index];
+        fprintf(stderr, ": %s", ir_opcode_name(instruction->op));
+        for(int i = 0; i < IR_MAX_OPERANDS && instruction->args[i].type != IR_NONE; i++){
+            fputc(' ', stderr);
+            ir_print_operand(&instruction->args[i], stderr);
+        }
+    }
+    fputc('\n', stderr);
+}
+
+int vm_run(const ir_program* program, opt_level optimization){
+    vm_code code;
+    int err = vm_load(program, optimization, &code);
+    if(err){
+        vm_print_error(program, program->count, err);
+        return err;
+    }
+    vm_state vm = {.code = &code};
+    vm.global.size = code.global_size;
+    vm.global.slots = vm_new_slots(code.global_size);
+    // Calls do not allocate until the preallocated stacks are exhausted
+    if(vm.global.slots == NULL || vm_reserve_frames(&vm, VM_FRAME_STACK_SIZE)
+        || vm_reserve((void**)&vm.locals, &vm.local_capacity, VM_CALL_STACK_SIZE, sizeof(vm_frame))
+        || vm_reserve((void**)&vm.calls, &vm.call_capacity, VM_CALL_STACK_SIZE, sizeof(size_t))
+        || vm_reserve((void**)&vm.stack, &vm.stack_capacity, VM_CALL_STACK_SIZE, sizeof(vm_value))){
+        err = VM_ERR_INTERNAL;
+    }
+#ifdef VM_JIT
+    if(!err && options.jit){
+        err = jit_init(&vm.jit, code.count);
+    }
+#endif
+    int exit_code = 0;
+    if(!err){
+        err = vm_interpret(&vm, code.code, &exit_code);
+    }
+    vm_io_close();
+    if(err){
+        vm_print_error(program, vm.ip > 0 ? code.source[vm.ip - 1] : program->count, err);
+        exit_code = err;
+    }
+    vm_dispose(&vm);
+    vm_free_code(&code);
+    return exit_code;
+}
@@ -0,0 +1,33 @@
+/**
+ * Název projektu: Implementace překladače imperativního jazyka IFJ24.
+ *
+ * @file vm.h
+ */
+
+#ifndef VM_H
+#define VM_H
+
+#include "ir.h"
+#include "options.h"
+
+/* Return codes of the interpreter in case of runtime errors */
+typedef enum vm_error {
+	VM_ERR_SEMANTIC = 52,		/* Undefined label, redefinition of variable */
+	VM_ERR_OPERAND_TYPE = 53,	/* Wrong operand types */
+	VM_ERR_UNDEFINED_VAR = 54,	/* Access to nonexistent variable */
+	VM_ERR_FRAME = 55,			/* Frame does not exist */
+	VM_ERR_MISSING_VALUE = 56,	/* Missing value in variable, data stack or call stack */
+	VM_ERR_OPERAND_VALUE = 57,	/* Wrong operand value (division by zero, wrong exit code, int out of range of the value representation) */
+	VM_ERR_STRING = 58,			/* Wrong work with string */
+	VM_ERR_INTERNAL = 99		/* Memory allocation error */
+} vm_error;
+
+/**
+ * Interprets IFJcode24 program, reads input from stdin and writes output to stdout
+ * \param program instruction stream generated by codegen
+ * \param optimization optimization level the program was compiled at
+ * \return exit code of the program or runtime error code
+ */
+int vm_run(const ir_program* program, opt_level optimization);
+
+#endif
@@ -0,0 +1,212 @@
+/**
+ * Název projektu: Implementace překladače imperativního jazyka IFJ24.
+ *
+ * @file vm_io.c
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "vm.h"
+#include "vm_io.h"
+
+#define VM_IO_BUFFER 65536
+
+// Output waiting to be written to stdout
+static char output[VM_IO_BUFFER];
+static size_t output_length = 0;
+
+// Read part of stdin, lines start at input_start
+static char* input = NULL;
+static size_t input_start = 0, input_end = 0, input_capacity = 0;
+static bool input_eof = false;
+
+// Powers of ten exactly representable as double
+static const double exact_powers[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+#define MAX_EXACT_POWER 22
+
+// Input
+
+/**
+ * Reads next block of stdin after the buffered input, the buffer grows when it is full
+ * \return 0: success, VM_ERR_INTERNAL: memory allocation error
+ */
+static int vm_fill_input(void){
+    // Unfinished line is moved to the beginning of the buffer
+    if(input_start > 0){
+        memmove(input, input + input_start, input_end - input_start);
+        input_end -= input_start;
+        input_start = 0;
+    }
+    if(input_end + 1 >= input_capacity){
+        size_t capacity = input_capacity ? input_capacity * 2 : VM_IO_BUFFER;
+        char* grown = realloc(input, capacity);
+        if(grown == NULL){
+            return VM_ERR_INTERNAL;
+        }
+        input = grown;
+        input_capacity = capacity;
+    }
+    // Prompt written by the program has to be visible before waiting for input
+    vm_io_flush();
+    ssize_t count;
+    do{
+        count = read(STDIN_FILENO, input + input_end, input_capacity - input_end - 1);
+    } while(count < 0 && errno == EINTR);
+    if(count <= 0){
+        input_eof = true;
+        return 0;
+    }
+    input_end += count;
+    return 0;
+}
+
+int vm_read_line(char** line, size_t* length){
+    size_t scanned = input_start;
+    while(true){
+        char* newline = input == NULL ? NULL : memchr(input + scanned, '\n', input_end - scanned);
+        if(newline != NULL){
+            *newline = '\0';
+            *line = input + input_start;
+            *length = newline - *line;
+            input_start = newline - input + 1;
+            return 0;
+        }
+        if(input_eof){
+            // Last line does not have to end with newline
+            if(input_start == input_end){
+                *line = NULL;
+                *length = 0;
+                return 0;
+            }
+            input[input_end] = '\0';
+            *line = input + input_start;
+            *length = input_end - input_start;
+            input_start = input_end;
+            return 0;
+        }
+        scanned = input_end - input_start;
+        int err = vm_fill_input();
+        if(err){
+            return err;
+        }
+    }
+}
+
+bool vm_parse_int(const char* line, size_t length, long long* out){
+    size_t i = line[0] == '-' || line[0] == '+';
+    // Numbers that may overflow and other forms are left to strtoll
+    if(length > i && length - i <= 18){
+        long long number = 0;
+        for(; i < length && line[i] >= '0' && line[i] <= '9'; i++){
+            number = number * 10 + (line[i] - '0');
+        }
+        if(i == length){
+            *out = line[0] == '-' ? -number : number;
+            return true;
+        }
+    }
+    // Only decimal numbers are ints, a number out of the range of int is not an int either
+    char* end;
+    errno = 0;
+    *out = strtoll(line, &end, 10);
+    return length > 0 && *end == '\0' && errno != ERANGE;
+}
+
+bool vm_parse_float(const char* line, size_t length, double* out){
+    size_t i = line[0] == '-' || line[0] == '+';
+    unsigned long long mantissa = 0;
+    int exponent = 0, digits = 0;
+    for(; i < length && line[i] >= '0' && line[i] <= '9'; i++, digits++){
+        mantissa = mantissa * 10 + (line[i] - '0');
+    }
+    if(i < length && line[i] == '.'){
+        for(i++; i < length && line[i] >= '0' && line[i] <= '9'; i++, digits++){
+            mantissa = mantissa * 10 + (line[i] - '0');
+            exponent--;
+        }
+    }
+    if(digits > 0 && digits <= 15 && i < length && (line[i] == 'e' || line[i] == 'E')){
+        size_t start = ++i;
+        bool negative = i < length && line[i] == '-';
+        i += i < length && (line[i] == '-' || line[i] == '+');
+        int written = 0;
+        for(; i < length && line[i] >= '0' && line[i] <= '9' && written < 4; i++){
+            written = written * 10 + (line[i] - '0');
+        }
+        // Exponent without digits is malformed, strtod decides
+        if(i == start || line[i - 1] < '0' || line[i - 1] > '9'){
+            digits = 0;
+        }
+        exponent += negative ? -written : written;
+    }
+    // At most 15 digits fit into mantissa exactly, multiplication by exact power of ten is correctly rounded
+    if(i == length && digits > 0 && digits <= 15
+        && exponent >= -MAX_EXACT_POWER && exponent <= MAX_EXACT_POWER){
+        double number = (double)mantissa;
+        number = exponent < 0 ? number / exact_powers[-exponent] : number * exact_powers[exponent];
+        *out = line[0] == '-' ? -number : number;
+        return true;
+    }
+    char* end;
+    *out = strtod(line, &end);
+    return length > 0 && *end == '\0';
+}
+
+// Output
+
+void vm_write_bytes(const char* data, size_t length){
+    if(output_length + length > VM_IO_BUFFER){
+        vm_io_flush();
+        // Long strings are written directly
+        if(length > VM_IO_BUFFER){
+            fwrite(data, 1, length, stdout);
+            return;
+        }
+    }
+    memcpy(output + output_length, data, length);
+    output_length += length;
+}
+
+void vm_write_int(long long number){
+    char digits[24];
+    size_t position = sizeof(digits);
+    unsigned long long magnitude = number < 0 ? 0ull - (unsigned long long)number : (unsigned long long)number;
+    do{
+        digits[--position] = '0' + magnitude % 10;
+        magnitude /= 10;
+    } while(magnitude > 0);
+    if(number < 0){
+        digits[--position] = '-';
+    }
+    vm_write_bytes(digits + position, sizeof(digits) - position);
+}
+
+void vm_write_float(double number){
+    char characters[64];
+    int length = snprintf(characters, sizeof(characters), "%a", number);
+    vm_write_bytes(characters, length);
+}
+
+void vm_io_flush(void){
+    if(output_length > 0){
+        fwrite(output, 1, output_length, stdout);
+        output_length = 0;
+    }
+    fflush(stdout);
+}
+
+void vm_io_close(void){
+    vm_io_flush();
+    free(input);
+    input = NULL;
+    input_start = input_end = input_capacity = 0;
+    input_eof = false;
+}
@@ -0,0 +1,74 @@
+/**
+ * Název projektu: Implementace překladače imperativního jazyka IFJ24.
+ *
+ * @file vm_io.h
+ */
+
+#ifndef VM_IO_H
+#define VM_IO_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/*
+ * Buffered input and output of the interpreter. Stdin is read in large blocks and split to lines,
+ * output is collected in a buffer written to stdout when it fills, before blocking on input and by vm_io_flush.
+ */
+
+/**
+ * Reads next line of stdin
+ * \param line NUL terminated line without the newline, valid until the next read | NULL at the end of input
+ * \param length
+ * \return 0: success, VM_ERR_INTERNAL: memory allocation error
+ */
+int vm_read_line(char** line, size_t* length);
+
+/**
+ * Converts line to integer, plain decimal numbers are parsed directly, other inputs by strtoll in base 10
+ * \param line NUL terminated line
+ * \param length
+ * \param out
+ * \return whole line is a decimal number in the range of long long
+ */
+bool vm_parse_int(const char* line, size_t length, long long* out);
+
+/**
+ * Converts line to float, decimal numbers exactly representable by one operation are parsed directly,
+ * other inputs by strtod
+ * \param line NUL terminated line
+ * \param length
+ * \param out
+ * \return whole line is a number
+ */
+bool vm_parse_float(const char* line, size_t length, double* out);
+
+/**
+ * Writes characters to the output buffer
+ * \param data
+ * \param length
+ */
+void vm_write_bytes(const char* data, size_t length);
+
+/**
+ * Writes integer in decimal to the output buffer
+ * \param number
+ */
+void vm_write_int(long long number);
+
+/**
+ * Writes float in hexadecimal format (%a) to the output buffer
+ * \param number
+ */
+void vm_write_float(double number);
+
+/**
+ * Writes buffered output to stdout
+ */
+void vm_io_flush(void);
+
+/**
+ * Flushes output and frees input buffer
+ */
+void vm_io_close(void);
+
+#endif